@@ -0,0 +1,218 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Shape Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef BRANCHANDBOUNDICP_H_
+#define BRANCHANDBOUNDICP_H_
+
+#include <vector>
+#include <queue>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include <Eigen/SVD>
+#include "ICP.h"
+#include "SFA/Utility/AbstractMesh.h"
+#include "SFA/Utility/KdTree.h"
+#include "SFA/Utility/Parallel.h"
+
+namespace sfa
+{
+    /**
+     * @brief Global rigid registration by branch-and-bound (Go-ICP)
+     * @details The space of all rotations (as angle-axis vectors within a ball of radius pi) is
+     * 		split into cubes. For every rotation cube a nested branch-and-bound over translation
+     * 		cubes computes bounds of the squared distances of a subsample of source to dest.
+     * 		Distances are looked up in a distance transform of dest that is computed once per
+     * 		destination generation. As distances change by no more than the points move, the
+     * 		value of the closest cell center minus the offset to it is a strict lower bound,
+     * 		while the value itself serves as an estimate. Whenever the estimate promises a
+     * 		better solution it is tightened by local ICP, which measures exact distances.
+     * 		Cubes that are finer than the cells of the distance transform aren't split any
+     * 		further.
+     * 		The search ends as soon as no cube can improve the best solution by more than the
+     * 		mean squared error threshold or the cube budget is used up. The remaining
+     * 		difference to the global optimum is provided by getGap().
+     * 		Children of a cube are evaluated in parallel. Just like PCA_ICP this aligns source
+     * 		once per call to reset() and is meant to be followed by a regular ICP.
+     */
+    class BranchAndBoundICP: public ICP
+    {
+	public:
+	    /**
+	     * @brief Constructor
+	     * @param pLog Log to use or nullptr to disable logging
+	     */
+	    BranchAndBoundICP(AbstractLog* pLog = nullptr);
+	    virtual ~BranchAndBoundICP();
+	    /**
+	     * @brief Aligns source with dest
+	     * @details Does nothing if source has already been aligned since the last call to reset().
+	     * @param source Source mesh
+	     * @param dest Destination mesh
+	     * @return The amount of points used for the calculation
+	     */
+	    virtual unsigned int calcNextStep(AbstractMesh& source, AbstractMesh const& dest);
+	    /**
+	     * @brief Computes the best transformation found by the search without applying it
+	     * @param source Source mesh
+	     * @param dest Destination mesh
+	     * @return Rigid transformation to apply to source
+	     */
+	    Eigen::Isometry3d findPose(AbstractMesh const& source, AbstractMesh const& dest);
+	    /**
+	     * @brief Allows the next call to calcNextStep() to align again
+	     */
+	    virtual void reset();
+	    /**
+	     * @return Amount of source vertices used for the search
+	     */
+	    unsigned int getSamples() const;
+	    /**
+	     * @brief Modifies the amount of source vertices used for the search
+	     * @param samples New amount
+	     */
+	    void setSamples(unsigned int samples);
+	    /**
+	     * @return Mean squared error threshold relative to the size of dest
+	     */
+	    double getThreshold() const;
+	    /**
+	     * @brief Modifies the mean squared error threshold
+	     * @details The search stops once no solution can be better than the current one by more
+	     * 		than this. It is measured in a coordinate system where dest fits into [-1,1]^3.
+	     * @param threshold New threshold
+	     */
+	    void setThreshold(double threshold);
+	    /**
+	     * @return Amount of cells of the distance transform along each axis
+	     */
+	    unsigned int getResolution() const;
+	    /**
+	     * @brief Modifies the amount of cells of the distance transform along each axis
+	     * @param resolution New resolution
+	     */
+	    void setResolution(unsigned int resolution);
+	    /**
+	     * @return Amount of rotation cubes evaluated by the last search
+	     */
+	    unsigned int getEvaluatedCubes() const;
+	    /**
+	     * @return Maximum amount of rotation cubes to evaluate per search, 0 if unlimited
+	     */
+	    unsigned int getMaxCubes() const;
+	    /**
+	     * @brief Limits the amount of rotation cubes evaluated per search
+	     * @param cubes New maximum, 0 if unlimited
+	     */
+	    void setMaxCubes(unsigned int cubes);
+	    /**
+	     * @return Mean squared error by which the result of the last search may exceed the global
+	     * 	       optimum, measured like the threshold
+	     */
+	    double getGap() const;
+	private:
+	    /**
+	     * @brief Distance transform of a destination mesh
+	     * @details Dest is moved and scaled such that it fits into [-1,1]^3, the grid covers twice
+	     * 		that size.
+	     */
+	    struct DistanceField
+	    {
+		public:
+		    unsigned int generation = 0;
+		    unsigned int amountOfVertices = 0;
+		    unsigned int resolution = 0;
+		    Eigen::Vector3d center = Eigen::Vector3d::Zero();
+		    double scale = 1;
+		    std::vector<float> distances;
+		    /**
+		     * @brief Normalized destination vertices for the local ICP
+		     */
+		    Eigen::Matrix3Xd points;
+		    KdTree<3> tree;
+	    };
+	    /**
+	     * @brief Cube in rotation or translation space
+	     */
+	    struct Cube
+	    {
+		public:
+		    Eigen::Vector3d center;
+		    double halfSide;
+		    double lowerBound;
+		    /**
+		     * @brief Reversed order such that std::priority_queue yields the lowest bound first
+		     */
+		    bool operator<(Cube const& other) const;
+	    };
+	    /**
+	     * @brief Makes sure m_distanceField is up to date for \p dest
+	     * @param dest Destination mesh
+	     */
+	    void updateDistanceField(AbstractMesh const& dest);
+	    /**
+	     * @brief Looks up the distance of a point to the closest destination vertex
+	     * @param x Point in normalized coordinates
+	     * @param[out] lower Lower bound of the exact distance
+	     * @return Distance sampled at the closest cell center
+	     */
+	    double sampleDistance(Eigen::Vector3d const& x, double& lower) const;
+	    /**
+	     * @brief Sum of exact squared distances of all points to dest
+	     * @param X Points in normalized coordinates
+	     * @return The error
+	     */
+	    double computeError(Eigen::Matrix3Xd const& X) const;
+	    /**
+	     * @brief Branch-and-bound over translations for a fixed rotation
+	     * @param X Rotated source points
+	     * @param gammaR Maximum distance each point may move due to the uncertainty of the rotation
+	     * @param bestError Best error found so far
+	     * @param[out] translation Best translation found, only modified if it is better than
+	     * 			       \p bestError
+	     * @param[out] lowerBound Lower bound of the error of all translations, given that each
+	     * 			      point may move by up to its \p gammaR
+	     * @return Lowest estimated error, \p bestError if nothing better was found
+	     */
+	    double searchTranslation(Eigen::Matrix3Xd const& X, Eigen::VectorXd const& gammaR, double bestError,
+		    Eigen::Vector3d& translation, double& lowerBound) const;
+	    /**
+	     * @return Half the diagonal of a cell of the distance transform in normalized coordinates
+	     */
+	    double getCellRadius() const;
+	    /**
+	     * @brief Refines a transformation with point-to-point ICP
+	     * @param P Source points
+	     * @param[in,out] R Rotation
+	     * @param[in,out] t Translation
+	     * @return Exact error after refinement, never more than the exact error before
+	     */
+	    double refine(Eigen::Matrix3Xd const& P, Eigen::Matrix3d& R, Eigen::Vector3d& t) const;
+	    /**
+	     * @param r Angle-axis vector
+	     * @return Rotation matrix
+	     */
+	    static Eigen::Matrix3d toRotation(Eigen::Vector3d const& r);
+
+	    DistanceField m_distanceField;
+	    unsigned int m_samples = 50;
+	    double m_threshold = 0.001;
+	    unsigned int m_resolution = 64;
+	    unsigned int m_refineIterations = 30;
+	    unsigned int m_evaluatedCubes = 0;
+	    unsigned int m_maxCubes = 100000;
+	    double m_gap = 0;
+	    bool m_aligned = false;
+    };
+}
+
+#endif /* BRANCHANDBOUNDICP_H_ */
@@ -0,0 +1,72 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Shape Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef CORRESPONDENCES_H_
+#define CORRESPONDENCES_H_
+
+#include <vector>
+#include <cstdint>
+
+namespace sfa
+{
+    /**
+     * @brief Point pairs between a source and a destination mesh
+     * @details Stored as one array per attribute, thus stages only touch the data they need.
+     * 		Resizing and removing pairs keeps the allocated memory, so a buffer can be reused
+     * 		for every step without any heap traffic once it's big enough.
+     */
+    class Correspondences
+    {
+	public:
+	    /**
+	     * @brief Index of the source vertex of every pair
+	     */
+	    std::vector<uint32_t> source;
+	    /**
+	     * @brief Index of the destination vertex of every pair
+	     */
+	    std::vector<uint32_t> dest;
+	    /**
+	     * @brief Distance between both vertices of every pair
+	     */
+	    std::vector<double> distance;
+	    /**
+	     * @brief Weight of every pair
+	     */
+	    std::vector<double> weight;
+
+	    /**
+	     * @return Amount of pairs
+	     */
+	    unsigned int size() const;
+	    /**
+	     * @brief Changes the amount of pairs
+	     * @details New pairs have a weight of 1, all other new attributes are 0.
+	     * @param size New amount of pairs
+	     */
+	    void resize(unsigned int size);
+	    /**
+	     * @brief Removes all pairs
+	     */
+	    void clear();
+	    /**
+	     * @brief Removes all pairs \p predicate returns true for
+	     * @details The order of the remaining pairs doesn't change. \p predicate is called directly,
+	     * 		thus it can be inlined into the loop.
+	     * @param predicate Gets passed the index of a pair
+	     * @return Amount of removed pairs
+	     */
+	    template<class Predicate> unsigned int removeIf(Predicate const& predicate);
+    };
+}
+
+#include "Correspondences.imp"
+
+#endif /* CORRESPONDENCES_H_ */
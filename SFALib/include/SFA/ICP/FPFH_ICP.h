@@ -0,0 +1,150 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Shape Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef FPFH_ICP_H_
+#define FPFH_ICP_H_
+
+#include <vector>
+#include <random>
+#include <atomic>
+#include <algorithm>
+#include <cmath>
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include "ICP.h"
+#include "SFA/Utility/AbstractMesh.h"
+#include "SFA/Utility/KdTree.h"
+#include "SFA/Utility/Parallel.h"
+#include "SFA/Utility/Scheduler.h"
+
+namespace sfa
+{
+    /**
+     * @brief Global pre-alignment based on Fast Point Feature Histograms
+     * @details Just like PCA_ICP this isn't a real ICP implementation. It describes the
+     * 		surrounding of every vertex by a rotation invariant histogram, matches source and
+     * 		destination vertices with similar histograms and estimates the transformation from
+     * 		those matches with RANSAC. Thus it works for arbitrary initial poses and is meant
+     * 		to be followed by one of the real ICP implementations.
+     * 		The neighborhood of a vertex is made up of its two-ring on the mesh. Vertices
+     * 		with too few mesh neighbors use their k nearest neighbors instead. Features are
+     * 		computed in parallel and cached until the shape of the mesh changes.
+     */
+    class FPFH_ICP: public ICP
+    {
+	public:
+	    /**
+	     * @brief Amount of bins per angular feature
+	     */
+	    static const unsigned int Bins = 11;
+	    /**
+	     * @brief One histogram per column
+	     */
+	    typedef Eigen::Matrix<double, 3 * Bins, Eigen::Dynamic> Features;
+
+	    /**
+	     * @brief Constructor
+	     * @param pLog Log to use or nullptr to disable logging
+	     */
+	    FPFH_ICP(AbstractLog* pLog = nullptr);
+	    virtual ~FPFH_ICP();
+	    /**
+	     * @brief Aligns source with dest
+	     * @details Does nothing if source has already been aligned since the last call to reset().
+	     * @param source Source mesh
+	     * @param dest Destination mesh
+	     * @return The amount of inlier matches used for the final estimate
+	     */
+	    virtual unsigned int calcNextStep(AbstractMesh& source, AbstractMesh const& dest);
+	    /**
+	     * @brief Computes the transformation that aligns source with dest without applying it
+	     * @param source Source mesh
+	     * @param dest Destination mesh
+	     * @param[out] pInliers If not nullptr the amount of inlier matches is copied here
+	     * @return Rigid transformation to apply to source
+	     */
+	    Eigen::Isometry3d findPose(AbstractMesh const& source, AbstractMesh const& dest,
+		    unsigned int* pInliers = nullptr);
+	    /**
+	     * @brief Computes the feature histogram of every vertex of \p mesh
+	     * @param mesh Mesh to compute features for
+	     * @param[out] features One histogram per vertex
+	     * @return Average distance between neighboring vertices
+	     */
+	    double computeFeatures(AbstractMesh const& mesh, Features& features) const;
+	    /**
+	     * @brief Allows the next call to calcNextStep() to align again
+	     */
+	    virtual void reset();
+	    /**
+	     * @return Amount of RANSAC iterations
+	     */
+	    unsigned int getIterations() const;
+	    /**
+	     * @brief Modifies the amount of RANSAC iterations
+	     * @param iterations New amount
+	     */
+	    void setIterations(unsigned int iterations);
+	    /**
+	     * @return Maximum distance of an inlier match after transformation, 0 for automatic
+	     */
+	    double getInlierDistance() const;
+	    /**
+	     * @brief Modifies the maximum distance of an inlier match after transformation
+	     * @param distance New distance or 0 to use twice the average edge length of dest
+	     */
+	    void setInlierDistance(double distance);
+	private:
+	    /**
+	     * @brief Features of a mesh
+	     */
+	    struct FeatureCache
+	    {
+		public:
+		    unsigned int shapeGeneration = 0;
+		    unsigned int amountOfVertices = 0;
+		    Features features;
+		    double averageEdgeLength = 0;
+		    /**
+		     * @brief Search structure in feature space, only built for the destination
+		     */
+		    KdTree<3 * Bins> tree;
+	    };
+	    /**
+	     * @brief Makes sure \p cache holds up to date features for \p mesh
+	     * @param mesh Mesh to get features for
+	     * @param cache Cache to check and update
+	     * @param buildTree Indicates if the search tree should be built as well
+	     * @return True if the features had to be recomputed, otherwise false
+	     */
+	    bool updateFeatures(AbstractMesh const& mesh, FeatureCache& cache, bool buildTree) const;
+
+	    FeatureCache m_sourceFeatures;
+	    FeatureCache m_destFeatures;
+	    unsigned int m_iterations = 5000;
+	    double m_inlierDistance = 0;
+	    /**
+	     * @brief Amount of matches each hypothesis is tested on before it has to compete with
+	     * 	      the best one so far
+	     */
+	    unsigned int m_verificationSamples = 50;
+	    /**
+	     * @brief Amount of nearest neighbors used for vertices without proper mesh neighborhood
+	     */
+	    unsigned int m_nearestNeighbors = 10;
+	    /**
+	     * @brief Amount of vertices processed as one work item during feature computation
+	     */
+	    unsigned int m_chunkSize = 256;
+	    bool m_aligned = false;
+    };
+}
+
+#endif /* FPFH_ICP_H_ */
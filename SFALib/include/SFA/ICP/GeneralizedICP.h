@@ -0,0 +1,114 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Shape Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef GENERALIZEDICP_H_
+#define GENERALIZEDICP_H_
+
+#include <vector>
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include <Eigen/Eigenvalues>
+#include <Eigen/LU>
+#include "ICP.h"
+#include "SFA/NearestNeighbor/NearestNeighbor.h"
+
+namespace sfa
+{
+    /**
+     * @brief Generalized ICP (plane-to-plane)
+     * @details Every vertex is modeled as a sample of a locally planar surface with a covariance
+     * 		that is small along the surface normal and large within the surface. The
+     * 		transformation is found by minimizing the Mahalanobis distance between
+     * 		corresponding points with a few Gauss-Newton iterations.
+     * 		Covariances are computed once per mesh from the neighbor rings of each vertex and
+     * 		cached. Transformations applied by this algorithm are tracked, thus the cached
+     * 		covariances of the source mesh only have to be rotated instead of recomputed.
+     */
+    class GeneralizedICP: public ICP
+    {
+	public:
+	    /**
+	     * @brief Constructs the icp object using \p nn to get the nearest neighbors
+	     * @param nn Nearest neighbor implementation to use
+	     * @param pLog Log to use or nullptr to disable logging
+	     */
+	    GeneralizedICP(NearestNeighbor& nn, AbstractLog* pLog = nullptr);
+	    virtual ~GeneralizedICP();
+	    virtual unsigned int calcNextStep(AbstractMesh& source, AbstractMesh const& dest);
+	    /**
+	     * @return Maximum amount of Gauss-Newton iterations per step
+	     */
+	    unsigned int getMaxIterations() const;
+	    /**
+	     * @brief Modifies the maximum amount of Gauss-Newton iterations per step
+	     * @param iterations New maximum
+	     */
+	    void setMaxIterations(unsigned int iterations);
+	    /**
+	     * @return Amount of times the covariances of a whole mesh have been computed
+	     */
+	    unsigned int getCovarianceComputations() const;
+	private:
+	    /**
+	     * @brief Covariances of all vertices of a mesh
+	     */
+	    struct CovarianceCache
+	    {
+		public:
+		    /**
+		     * @brief Generation of the mesh the covariances are valid for
+		     */
+		    unsigned int generation = 0;
+		    /**
+		     * @brief Covariance of every vertex at the time they were computed
+		     */
+		    std::vector<Eigen::Matrix3d> covariances;
+		    /**
+		     * @brief Rotation applied to the mesh since the covariances were computed
+		     */
+		    Eigen::Matrix3d rotation = Eigen::Matrix3d::Identity();
+	    };
+	    /**
+	     * @brief Makes sure \p cache holds up to date covariances for \p mesh
+	     * @param mesh Mesh to get covariances for
+	     * @param cache Cache to check and update
+	     */
+	    void updateCovariances(AbstractMesh const& mesh, CovarianceCache& cache);
+	    /**
+	     * @brief Computes the regularized covariance of a vertex from its neighbors
+	     * @param mesh Mesh the vertex belongs to
+	     * @param n Index of the vertex to compute covariance for
+	     * @return Covariance matrix
+	     */
+	    Eigen::Matrix3d computeCovariance(AbstractMesh const& mesh, unsigned int n) const;
+	    /**
+	     * @brief Computes the covariance of a plane with normal \p normal
+	     * @param normal Plane normal
+	     * @return Covariance matrix
+	     */
+	    Eigen::Matrix3d planeCovariance(Eigen::Vector3d const& normal) const;
+
+	    NearestNeighbor& m_nearestNeighbor;
+	    CovarianceCache m_sourceCache;
+	    CovarianceCache m_destCache;
+	    unsigned int m_maxIterations = 5;
+	    unsigned int m_covarianceComputations = 0;
+	    /**
+	     * @brief Variance along the normal compared to the variance within the surface
+	     */
+	    const double m_epsilon = 0.001;
+	    /**
+	     * @brief Gauss-Newton iteration stops as soon as the update gets smaller than this
+	     */
+	    const double m_convergenceThreshold = 1e-10;
+    };
+}
+
+#endif /* GENERALIZEDICP_H_ */
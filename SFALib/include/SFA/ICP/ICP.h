@@ -13,10 +13,17 @@
 
 #include <vector>
 #include <random>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
 #include <Eigen/Core>
+#include <Eigen/Geometry>
+#include <Eigen/Eigenvalues>
+#include <Eigen/SVD>
 #include "SFA/Utility/AbstractMesh.h"
 #include "SFA/Utility/Vertex.h"
 #include "SFA/Utility/AbstractLog.h"
+#include "SFA/Utility/Arena.h"
 
 namespace sfa
 {
@@ -37,6 +44,10 @@ namespace sfa
 		EVERY_THIRD = 1 << 3, //!< EVERY_THIRD
 		EVERY_FOURTH = 1 << 4,//!< EVERY_FOURTH
 		EVERY_FIFTH = 1 << 5, //!< EVERY_FIFTH
+		NORMAL_SPACE = 1 << 6,//!< NORMAL_SPACE: Draws the selection percentage of all vertices
+				      //!< evenly from groups of vertices with similar normal direction
+		COVARIANCE = 1 << 7,  //!< COVARIANCE: Prefers the points that best constrain all six
+				      //!< degrees of freedom of a point-to-plane alignment
 	    };
 
 	    /**
@@ -55,12 +66,26 @@ namespace sfa
 	     * @return The amount of points used for the calculation
 	     */
 	    virtual unsigned int calcNextStep(AbstractMesh& source, AbstractMesh const& dest) = 0;
+	    /**
+	     * @brief Allows one-shot alignments to run again on the next call to calcNextStep()
+	     * @details Does nothing for iterative algorithms.
+	     */
+	    virtual void reset();
 	    /**
 	     * @brief Selects a certain amount of points on the source mesh
 	     * @param source Source model
 	     * @return List with all points to use for ICP
 	     */
 	    std::vector<Vertex> selectPoints(AbstractMesh& source);
+	    /**
+	     * @brief Selects a certain amount of points on the source mesh
+	     * @details All filters are evaluated in a single pass over the vertices, the selection
+	     * 		percentage is applied afterwards by sequential sampling. Both run in linear time.
+	     * @param source Source model
+	     * @return Indices of all points to use for ICP. The reference stays valid until the
+	     * 	       next call.
+	     */
+	    std::vector<uint32_t> const& selectIndices(AbstractMesh const& source);
 	    /**
 	     * @brief Calculates the average of the passed points
 	     * @param points Points to calculate average from
@@ -89,16 +114,165 @@ namespace sfa
 	     * @param percentage Percentage in the range of [0,1]
 	     */
 	    void setSelectionPercentage(double percentage);
+	    /**
+	     * @return Maximum amount of points to select, 0 if unlimited
+	     */
+	    unsigned int const& getSelectionBudget() const;
+	    /**
+	     * @brief Limits the amount of selected points independent of the mesh size
+	     * @param budget Maximum amount of points to select, 0 if unlimited
+	     */
+	    void setSelectionBudget(unsigned int budget);
+	    /**
+	     * @brief Reseeds the random number generator used for point selection
+	     * @param seed New seed
+	     */
+	    void setSeed(unsigned int seed);
+	    /**
+	     * @return Maximum amount of threads used per step, 0 if one per hardware thread
+	     */
+	    unsigned int getThreads() const;
+	    /**
+	     * @brief Limits the amount of threads used per step
+	     * @details Results don't depend on the amount of threads.
+	     * @param threads Maximum amount of threads, 0 to use one per hardware thread
+	     */
+	    void setThreads(unsigned int threads);
+	    /**
+	     * @return Arena that provides the temporaries of a single step
+	     */
+	    Arena const& getArena() const;
 	protected:
+	    /**
+	     * @brief Removes all pairs from m_selection and m_nearest whose destination vertex is
+	     * 	      located on the edge of \p dest, if requested by the selection method
+	     * @param dest Destination model
+	     */
+	    void rejectEdgePairs(AbstractMesh const& dest);
+	    /**
+	     * @brief Computes the rigid transformation mapping \p X onto \p Y in a least squares sense
+	     * @param X Source points, one per column
+	     * @param Y Corresponding destination points, one per column
+	     * @return The transformation
+	     */
+	    static Eigen::Isometry3d estimatePose(Eigen::Matrix3Xd const& X, Eigen::Matrix3Xd const& Y);
+	    /**
+	     * @brief Checks the index, random and edge filters of the selection method
+	     * @param source Source model
+	     * @param i Index of the vertex to check
+	     * @return True in case the vertex may be used for ICP
+	     */
+	    bool isSelectable(AbstractMesh const& source, uint32_t i);
+	    /**
+	     * @brief Fills m_selection by normal-space sampling
+	     * @param source Source model
+	     */
+	    void selectNormalSpace(AbstractMesh const& source);
+	    /**
+	     * @brief Makes sure m_normalBuckets is up to date for \p source
+	     * @param source Source model
+	     */
+	    void updateNormalBuckets(AbstractMesh const& source);
+	    /**
+	     * @brief Keeps the selection caches of \p source valid across a rigid transformation
+	     * @details Caches are keyed on the mesh generation. Call this right after the algorithm
+	     * 		itself moved the mesh rigidly, which doesn't affect what they hold.
+	     * @param source Mesh that has just been transformed
+	     * @param previousGeneration Generation of the mesh before the transformation
+	     */
+	    void keepSelectionCaches(AbstractMesh const& source, unsigned int previousGeneration);
+	    /**
+	     * @brief Fills m_selection by covariance sampling
+	     * @param source Source model
+	     */
+	    void selectCovariance(AbstractMesh const& source);
+	    /**
+	     * @brief Makes sure m_stableOrder is up to date for \p source
+	     * @details Greedily orders all vertices such that every prefix constrains the
+	     * 		eigenvectors of the 6x6 point-to-plane covariance matrix as evenly as possible.
+	     * @param source Source model
+	     */
+	    void updateStableOrder(AbstractMesh const& source);
+	    /**
+	     * @param candidates Amount of vertices to choose from
+	     * @return Amount of vertices to select with regard to percentage and budget
+	     */
+	    uint32_t getSelectionAmount(uint32_t candidates) const;
+
 	    /**
 	     * @brief Bitwise OR-ed parameters from PointSelection
 	     */
 	    unsigned int m_selectionMethod = 0;
 	    double m_selectionPercentage = 1;
+	    unsigned int m_selectionBudget = 0;
+	    unsigned int m_threads = 0;
+	    /**
+	     * @brief Amount of point pairs accumulated as one work item
+	     * @details Partial results are always combined in the same order, which keeps steps
+	     * 		deterministic no matter how many threads are used.
+	     */
+	    unsigned int m_chunkSize = 256;
+	    /**
+	     * @brief Temporaries needed during a step, reset at the beginning of every step
+	     */
+	    Arena m_arena;
 	    /**
 	     * @brief Random number generator
 	     */
 	    std::mt19937 m_random;
+	    /**
+	     * @brief Indices of the points selected by the last call to selectIndices()
+	     */
+	    std::vector<uint32_t> m_selection;
+	    /**
+	     * @brief Indices of the nearest neighbors of the selected points, reused across steps
+	     */
+	    std::vector<uint32_t> m_nearest;
+	    /**
+	     * @brief Vertices of a mesh grouped by the direction of their normal
+	     * @details Bucket b consists of members[offsets[b]] to members[offsets[b + 1] - 1] in
+	     * 		random order. As the grouping only depends on the normals relative to each
+	     * 		other it stays valid while the mesh is moved rigidly, see keepSelectionCaches().
+	     */
+	    struct NormalBuckets
+	    {
+		public:
+		    AbstractMesh const* pMesh = nullptr;
+		    /**
+		     * @brief Generation of the mesh the buckets are valid for
+		     */
+		    unsigned int generation = 0;
+		    unsigned int amountOfVertices = 0;
+		    std::vector<uint32_t> offsets;
+		    std::vector<uint32_t> members;
+		    /**
+		     * @brief Buckets that still have unused members during the current selection
+		     */
+		    std::vector<uint32_t> active;
+		    /**
+		     * @brief Random start position within each bucket for the current selection
+		     */
+		    std::vector<uint32_t> starts;
+	    } m_normalBuckets;
+	    /**
+	     * @brief Amount of buckets along the polar axis. There are twice as many along the azimuth.
+	     */
+	    unsigned int m_normalBucketResolution = 6;
+	    /**
+	     * @brief Vertices of a mesh in the order they are picked by covariance sampling
+	     * @details Just like the normal buckets this is invariant under rigid motion.
+	     */
+	    struct StableOrder
+	    {
+		public:
+		    AbstractMesh const* pMesh = nullptr;
+		    /**
+		     * @brief Generation of the mesh the order is valid for
+		     */
+		    unsigned int generation = 0;
+		    unsigned int amountOfVertices = 0;
+		    std::vector<uint32_t> order;
+	    } m_stableOrder;
 	    /**
 	     * @brief Plug-in possibility for library users to have some logfile output
 	     */
@@ -0,0 +1,66 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Shape Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef KERNELICP_H_
+#define KERNELICP_H_
+
+#include <algorithm>
+#include "ICP.h"
+#include "Correspondences.h"
+#include "PipelineStages.h"
+#include "SFA/Utility/Parallel.h"
+
+namespace sfa
+{
+    /**
+     * @brief Rigid ICP with all per-point work specialized at compile time
+     * @details Does the same as a PipelineICP consisting of nearest neighbor matching, edge
+     * 		rejection and \p SolverType, but doesn't dispatch any per-point call at runtime if
+     * 		both meshes are of type \p MeshType and \p MeshType as well as
+     * 		\p NearestNeighborType are final. The mesh type is checked once per step, other meshes
+     * 		are processed by the same code instantiated for AbstractMesh.
+     * @tparam MeshType Concrete mesh type
+     * @tparam NearestNeighborType Concrete nearest neighbor type, needs a findNearest() method
+     * 	       accepting a \p MeshType
+     * @tparam SolverType Solver that provides a solveFor() method template, e.g. PointToPointSolver
+     */
+    template<class MeshType, class NearestNeighborType, class SolverType> class KernelICP : public ICP
+    {
+	public:
+	    /**
+	     * @brief Constructs the icp object using \p nn to get the nearest neighbors
+	     * @param nn Nearest neighbor implementation to use
+	     * @param pLog Log to use or nullptr to disable logging
+	     */
+	    KernelICP(NearestNeighborType& nn, AbstractLog* pLog = nullptr);
+	    virtual ~KernelICP();
+	    virtual unsigned int calcNextStep(AbstractMesh& source, AbstractMesh const& dest);
+	    /**
+	     * @return The pairs used by the last step
+	     */
+	    Correspondences const& getCorrespondences() const;
+	private:
+	    /**
+	     * @brief Does a single step on meshes of type \p Mesh
+	     * @param source Source model
+	     * @param dest Destination model
+	     * @return The amount of points used for the calculation
+	     */
+	    template<class Mesh> unsigned int step(Mesh& source, Mesh const& dest);
+
+	    NearestNeighborType& m_nearestNeighbor;
+	    SolverType m_solver;
+	    Correspondences m_correspondences;
+    };
+}
+
+#include "KernelICP.imp"
+
+#endif /* KERNELICP_H_ */
@@ -0,0 +1,163 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Shape Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef LANDMARKICP_H_
+#define LANDMARKICP_H_
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include <Eigen/Cholesky>
+#include "ICP.h"
+#include "SFA/Utility/AbstractMesh.h"
+#include "SFA/Utility/Parallel.h"
+#include "SFA/Utility/Scheduler.h"
+
+namespace sfa
+{
+    /**
+     * @brief Coarse alignment based on a few strongly curved landmarks
+     * @details Principal curvatures of every vertex are estimated by fitting a quadric to its
+     * 		one-ring, or its two-ring if it has less than five neighbors. The most strongly curved
+     * 		vertices that are sufficiently far apart from each other (on faces usually nose tip,
+     * 		chin and eye corners) are used as landmarks.
+     * 		Triplets of landmarks on source and dest with matching distances and convexity
+     * 		yield candidate poses, the one that brings most landmarks together wins.
+     * 		Just like PCA_ICP this aligns source once per call to reset() and is meant to be
+     * 		followed by a regular ICP.
+     */
+    class LandmarkICP: public ICP
+    {
+	public:
+	    /**
+	     * @brief Principal curvatures of a vertex
+	     * @details Positive values mean the surface bends away from the normal (convex).
+	     */
+	    struct Curvature
+	    {
+		public:
+		    double max = 0;
+		    double min = 0;
+	    };
+
+	    /**
+	     * @brief Constructor
+	     * @param pLog Log to use or nullptr to disable logging
+	     */
+	    LandmarkICP(AbstractLog* pLog = nullptr);
+	    virtual ~LandmarkICP();
+	    /**
+	     * @brief Aligns source with dest
+	     * @details Does nothing if source has already been aligned since the last call to reset().
+	     * @param source Source mesh
+	     * @param dest Destination mesh
+	     * @return The amount of landmark pairs used for the final estimate
+	     */
+	    virtual unsigned int calcNextStep(AbstractMesh& source, AbstractMesh const& dest);
+	    /**
+	     * @brief Computes the transformation that aligns source with dest without applying it
+	     * @param source Source mesh
+	     * @param dest Destination mesh
+	     * @param[out] pPairs If not nullptr the amount of matching landmark pairs is copied here
+	     * @return Rigid transformation to apply to source
+	     */
+	    Eigen::Isometry3d findPose(AbstractMesh const& source, AbstractMesh const& dest,
+		    unsigned int* pPairs = nullptr);
+	    /**
+	     * @brief Estimates the principal curvatures of all vertices of \p mesh
+	     * @param mesh Mesh to compute curvatures for
+	     * @param[out] curvatures Curvature of every vertex
+	     */
+	    void computeCurvatures(AbstractMesh const& mesh, std::vector<Curvature>& curvatures) const;
+	    /**
+	     * @brief Picks the most strongly curved vertices that are far enough apart
+	     * @param mesh Mesh to find landmarks on
+	     * @param curvatures Curvature of every vertex of \p mesh
+	     * @param[out] landmarks Indices of the landmark vertices, most strongly curved first
+	     */
+	    void findLandmarks(AbstractMesh const& mesh, std::vector<Curvature> const& curvatures,
+		    std::vector<uint32_t>& landmarks) const;
+	    /**
+	     * @brief Allows the next call to calcNextStep() to align again
+	     */
+	    virtual void reset();
+	    /**
+	     * @return Maximum amount of landmarks per mesh
+	     */
+	    unsigned int getLandmarks() const;
+	    /**
+	     * @brief Modifies the maximum amount of landmarks per mesh
+	     * @param landmarks New amount, at least 3
+	     */
+	    void setLandmarks(unsigned int landmarks);
+	private:
+	    /**
+	     * @brief Landmarks of a mesh
+	     */
+	    struct LandmarkCache
+	    {
+		public:
+		    unsigned int generation = 0;
+		    /**
+		     * @brief Shape generation the landmarks have been searched for
+		     */
+		    unsigned int shapeGeneration = 0;
+		    unsigned int amountOfVertices = 0;
+		    std::vector<uint32_t> landmarks;
+		    Eigen::Matrix3Xd positions;
+		    /**
+		     * @brief Indicates for every landmark whether it is convex
+		     */
+		    std::vector<bool> convex;
+		    /**
+		     * @brief Length of the bounding box diagonal of the mesh
+		     */
+		    double size = 0;
+	    };
+	    /**
+	     * @brief Makes sure \p cache holds up to date landmarks for \p mesh
+	     * @param mesh Mesh to get landmarks for
+	     * @param cache Cache to check and update
+	     */
+	    void updateLandmarks(AbstractMesh const& mesh, LandmarkCache& cache) const;
+	    /**
+	     * @brief Counts the source landmarks that end up close to a compatible destination landmark
+	     * @param pose Transformation to apply to the source landmarks
+	     * @param tolerance Maximum distance of a match
+	     * @param[out] pairs Index of the matching destination landmark for every source landmark or
+	     * 		         -1 if there is none
+	     * @param[out] error Sum of squared distances of all matches
+	     * @return Amount of matches
+	     */
+	    unsigned int matchLandmarks(Eigen::Isometry3d const& pose, double tolerance, std::vector<int>& pairs,
+		    double& error) const;
+
+	    LandmarkCache m_sourceLandmarks;
+	    LandmarkCache m_destLandmarks;
+	    unsigned int m_landmarks = 8;
+	    /**
+	     * @brief Minimum distance between two landmarks relative to the mesh size
+	     */
+	    double m_suppressionRadius = 0.1;
+	    /**
+	     * @brief Maximum deviation of corresponding distances relative to the mesh size
+	     */
+	    double m_tolerance = 0.03;
+	    /**
+	     * @brief Amount of vertices processed as one work item during curvature estimation
+	     */
+	    unsigned int m_chunkSize = 256;
+	    bool m_aligned = false;
+    };
+}
+
+#endif /* LANDMARKICP_H_ */
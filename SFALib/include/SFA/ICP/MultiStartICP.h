@@ -0,0 +1,161 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Shape Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef MULTISTARTICP_H_
+#define MULTISTARTICP_H_
+
+#include <vector>
+#include <memory>
+#include <random>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <cmath>
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include "ICP.h"
+#include "SFA/NearestNeighbor/NearestNeighbor.h"
+#include "SFA/Utility/AbstractMesh.h"
+#include "SFA/Utility/AbstractLog.h"
+#include "SFA/Utility/Parallel.h"
+
+namespace sfa
+{
+    /**
+     * @brief Runs several ICP instances from perturbed initial poses and keeps the best one
+     * @details The first start uses the unmodified source, all others are rotated randomly around
+     * 		the center of source. All starts run concurrently and are compared to each other
+     * 		at checkpoints, where the worse half is dropped. This is repeated until only one
+     * 		start is left, which is then copied back into source.
+     * 		All starts share the same destination mesh, thus the nearest neighbor
+     * 		implementation used by the ICP instances must be safe to use from multiple
+     * 		threads (e.g. KdTreeNearestNeighbor).
+     * @tparam MeshType Copyable mesh type derived from AbstractMesh
+     */
+    template<class MeshType> class MultiStartICP
+    {
+	public:
+	    /**
+	     * @brief Creates a new ICP instance for every start
+	     */
+	    typedef std::function<ICP*()> ICPFactory;
+	    /**
+	     * @brief Outcome of a multi-start registration
+	     */
+	    struct Result
+	    {
+		public:
+		    /**
+		     * @brief Index of the winning start, 0 is the unperturbed source
+		     */
+		    unsigned int winner = 0;
+		    /**
+		     * @brief Mean squared distance of the winner to its nearest neighbors on dest
+		     */
+		    double error = 0;
+		    /**
+		     * @brief Amount of ICP steps calculated by the winner
+		     * @details One checkpoint per halving round, e.g. three checkpoints for eight starts.
+		     */
+		    unsigned int steps = 0;
+		    /**
+		     * @brief Time spent on all starts in seconds, summed up over all threads
+		     */
+		    double cpuTime = 0;
+	    };
+
+	    /**
+	     * @brief Constructor
+	     * @param factory Used to create one ICP instance per start
+	     * @param nn Nearest neighbor implementation used to compare the starts
+	     * @param pLog Log to use or nullptr to disable logging
+	     */
+	    MultiStartICP(ICPFactory factory, NearestNeighbor& nn, AbstractLog* pLog = nullptr);
+	    /**
+	     * @brief Aligns source with dest
+	     * @param source Source mesh, will be replaced by the winning start
+	     * @param dest Destination mesh
+	     * @return Information about the winning start
+	     */
+	    Result align(MeshType& source, AbstractMesh const& dest);
+	    /**
+	     * @return Amount of starts
+	     */
+	    unsigned int getStarts() const;
+	    /**
+	     * @brief Modifies the amount of starts
+	     * @param starts New amount, at least 1
+	     */
+	    void setStarts(unsigned int starts);
+	    /**
+	     * @return Maximum rotation angle of the perturbed starts
+	     */
+	    double getMaxAngle() const;
+	    /**
+	     * @brief Modifies the maximum rotation angle of the perturbed starts
+	     * @param angle New maximum angle in radians
+	     */
+	    void setMaxAngle(double angle);
+	    /**
+	     * @return Amount of ICP steps between two checkpoints
+	     */
+	    unsigned int getCheckpointSteps() const;
+	    /**
+	     * @brief Modifies the amount of ICP steps between two checkpoints
+	     * @param steps New amount
+	     */
+	    void setCheckpointSteps(unsigned int steps);
+	    /**
+	     * @brief Reseeds the random number generator used for the perturbations
+	     * @param seed New seed
+	     */
+	    void setSeed(unsigned int seed);
+	private:
+	    /**
+	     * @brief State of a single start
+	     */
+	    struct Start
+	    {
+		public:
+		    unsigned int index;
+		    std::unique_ptr<MeshType> pMesh;
+		    std::unique_ptr<ICP> pICP;
+		    double error;
+		    unsigned int steps;
+		    double time;
+	    };
+	    /**
+	     * @brief Rotates \p mesh around \p center
+	     * @param mesh Mesh to rotate
+	     * @param rotation Rotation to apply
+	     * @param center Center of rotation
+	     */
+	    void rotate(MeshType& mesh, Eigen::Matrix3d const& rotation, Eigen::Vector3d const& center) const;
+	    /**
+	     * @brief Computes the mean squared distance of all vertices of \p mesh to dest
+	     * @param mesh Mesh to compute error of
+	     * @param dest Destination mesh
+	     * @return Error value
+	     */
+	    double computeError(AbstractMesh const& mesh, AbstractMesh const& dest) const;
+
+	    ICPFactory m_factory;
+	    NearestNeighbor& m_nearestNeighbor;
+	    AbstractLog* m_pLog = nullptr;
+	    unsigned int m_starts = 8;
+	    double m_maxAngle = std::acos(0.0);
+	    unsigned int m_checkpointSteps = 5;
+	    std::mt19937 m_random;
+    };
+}
+
+#include "MultiStartICP.imp"
+
+#endif /* MULTISTARTICP_H_ */
@@ -13,42 +13,148 @@
 
 #include <vector>
 #include <algorithm>
+#include <Eigen/Core>
 #include <Eigen/Eigenvalues>
 #include <Eigen/Geometry>
+#include <Eigen/SVD>
 #include "ICP.h"
 #include "SFA/NearestNeighbor/NearestNeighbor.h"
 #include "SFA/Utility/AbstractMesh.h"
+#include "SFA/Utility/Parallel.h"
 
 namespace sfa
 {
     /**
      * @brief "Fake" ICP algorithm based on principal components of the models
-     * @details This "PCA-ICP" simply aligns the principal components of source and destination,
-     * 		one after another. It isn't really an ICP implementation as it doesn't rely on
-     * 		nearest neighbors. In fact, it does only work under certain assumptions.
+     * @details This "PCA-ICP" simply aligns the principal components of source and destination.
+     * 		It isn't really an ICP implementation as it doesn't rely on nearest neighbors. In
+     * 		fact, it does only work under certain assumptions.
      * 		Alignment will be improved if both source and destination have obvious principal
      * 		components (this should usually be the case for face models). If this is not the
      * 		case, the algorithm is likely to fail miserably.
+     * 		Mean and covariance of both meshes are computed in a single pass and cached for
+     * 		the mesh generation they belong to, thus aligning many copies of the same source
+     * 		with the same destination is cheap.
+     * 		If a nearest neighbor implementation is passed, the sign ambiguity of the axes isn't
+     * 		resolved by picking the smallest rotation. Instead, every proper rotation that maps
+     * 		the source axes onto the destination axes is refined by a few ICP iterations on a
+     * 		subsample of source in parallel. After each round the worse half is dropped until
+     * 		only the winner is left.
      */
     class PCA_ICP: public ICP
     {
 	public:
+	    /**
+	     * @brief Constructs a PCA-ICP that resolves ambiguous axes by picking the smallest rotation
+	     * @param pLog Log to use or nullptr to disable logging
+	     */
+	    PCA_ICP(AbstractLog* pLog = nullptr);
+	    /**
+	     * @brief Constructs a PCA-ICP that resolves ambiguous axes by racing all hypotheses
+	     * @param nn Nearest neighbor implementation to use for the refinement of the hypotheses
+	     * @param pLog Log to use or nullptr to disable logging
+	     */
+	    PCA_ICP(NearestNeighbor& nn, AbstractLog* pLog = nullptr);
 	    virtual ~PCA_ICP();
 	    /**
-	     * @brief Aligns one principal component after the other
+	     * @brief Aligns all three principal components at once
+	     * @details Does nothing if source has already been aligned since the last call to reset().
 	     * @param source Source mesh
 	     * @param dest Destination mesh
+	     * @return The amount of points used for the calculation
 	     */
 	    virtual unsigned int calcNextStep(AbstractMesh& source, AbstractMesh const& dest);
 	    /**
-	     * @brief Resets the the amount of already aligned dimensions to zero
+	     * @brief Computes the transformation that aligns source with dest without applying it
+	     * @param source Source mesh
+	     * @param dest Destination mesh
+	     * @return Rigid transformation to apply to source
+	     */
+	    Eigen::Isometry3d findPose(AbstractMesh const& source, AbstractMesh const& dest);
+	    /**
+	     * @brief Allows the next call to calcNextStep() to align again
+	     */
+	    virtual void reset();
+	    /**
+	     * @return Amount of source vertices used to evaluate the hypotheses
+	     */
+	    unsigned int getHypothesisSamples() const;
+	    /**
+	     * @brief Modifies the amount of source vertices used to evaluate the hypotheses
+	     * @param samples New amount
+	     */
+	    void setHypothesisSamples(unsigned int samples);
+	    /**
+	     * @return Amount of ICP iterations per hypothesis and round
+	     */
+	    unsigned int getHypothesisIterations() const;
+	    /**
+	     * @brief Modifies the amount of ICP iterations per hypothesis and round
+	     * @param iterations New amount
 	     */
-	    void reset();
+	    void setHypothesisIterations(unsigned int iterations);
 	private:
 	    /**
-	     * @brief Amount of dimensions already aligned
+	     * @brief Candidate pose for source
+	     */
+	    struct Hypothesis
+	    {
+		public:
+		    Eigen::Matrix3d rotation;
+		    Eigen::Vector3d translation;
+		    /**
+		     * @brief Mean squared distance of the subsample to dest after the last round
+		     */
+		    double error;
+	    };
+	    /**
+	     * @brief First and second moments of a mesh
+	     */
+	    struct Moments
+	    {
+		public:
+		    /**
+		     * @brief Generation of the mesh the moments are valid for
+		     */
+		    unsigned int generation = 0;
+		    unsigned int amountOfVertices = 0;
+		    Eigen::Vector3d mean = Eigen::Vector3d::Zero();
+		    /**
+		     * @brief Principal axes as columns, sorted by decreasing variance
+		     */
+		    Eigen::Matrix3d axes = Eigen::Matrix3d::Identity();
+	    };
+	    /**
+	     * @brief Makes sure \p moments are up to date for \p mesh
+	     * @param mesh Mesh to compute moments of
+	     * @param moments Cached moments to check and update
+	     */
+	    void updateMoments(AbstractMesh const& mesh, Moments& moments) const;
+	    /**
+	     * @brief Races all proper rotations between the principal frames
+	     * @param source Source mesh
+	     * @param dest Destination mesh
+	     * @return Pose of the winning hypothesis
+	     */
+	    Eigen::Isometry3d raceHypotheses(AbstractMesh const& source, AbstractMesh const& dest) const;
+	    /**
+	     * @brief Runs a few point-to-point ICP iterations for a single hypothesis
+	     * @param samples Subsample of source
+	     * @param dest Destination mesh
+	     * @param hypothesis Hypothesis to refine
+	     */
+	    void refineHypothesis(Eigen::Matrix3Xd const& samples, AbstractMesh const& dest,
+		    Hypothesis& hypothesis) const;
+
+	    NearestNeighbor* m_pNearestNeighbor = nullptr;
+	    unsigned int m_hypothesisSamples = 250;
+	    unsigned int m_hypothesisIterations = 2;
+	    Moments m_sourceMoments;
+	    Moments m_destMoments;
+	    /**
+	     * @brief Indicates if the last source has already been aligned
 	     */
-	    unsigned int m_index = 0;
+	    bool m_aligned = false;
     };
 }
 
@@ -0,0 +1,115 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Shape Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef PIPELINEICP_H_
+#define PIPELINEICP_H_
+
+#include <vector>
+#include <chrono>
+#include "ICP.h"
+#include "Correspondences.h"
+#include "PipelineStages.h"
+
+namespace sfa
+{
+    /**
+     * @brief ICP assembled from exchangeable stages
+     * @details Every step runs selection, matching, rejection, weighting, solving and applying
+     * 		in this order. All stages operate on the same correspondence buffer, which is kept
+     * 		across steps. Stages are not owned by the pipeline and have to outlive it.
+     */
+    class PipelineICP : public ICP
+    {
+	public:
+	    /**
+	     * @brief Accumulated time in seconds spent in each stage
+	     */
+	    struct StageTimes
+	    {
+		public:
+		    double selection = 0;
+		    double matching = 0;
+		    double rejection = 0;
+		    double weighting = 0;
+		    double solving = 0;
+		    double applying = 0;
+	    };
+
+	    /**
+	     * @brief Constructor
+	     * @param matcher Matcher to use
+	     * @param solver Solver to use
+	     * @param pLog Log to use or nullptr to disable logging
+	     */
+	    PipelineICP(Matcher& matcher, Solver& solver, AbstractLog* pLog = nullptr);
+	    virtual ~PipelineICP();
+	    virtual unsigned int calcNextStep(AbstractMesh& source, AbstractMesh const& dest);
+	    /**
+	     * @brief Replaces the selector
+	     * @param pSelector New selector or nullptr to use selectIndices()
+	     */
+	    void setSelector(Selector* pSelector);
+	    /**
+	     * @brief Appends a rejector
+	     * @details Rejectors are run in the order they were added, after the edge rejection
+	     * 		requested by PointSelection::NO_EDGES.
+	     * @param rejector Rejector to add
+	     */
+	    void addRejector(Rejector& rejector);
+	    /**
+	     * @brief Removes all rejectors added by addRejector()
+	     */
+	    void clearRejectors();
+	    /**
+	     * @brief Replaces the weighter
+	     * @param pWeighter New weighter or nullptr to weigh all pairs equally
+	     */
+	    void setWeighter(Weighter* pWeighter);
+	    /**
+	     * @brief Replaces the applier
+	     * @param pApplier New applier or nullptr to apply the transformation rigidly
+	     */
+	    void setApplier(Applier* pApplier);
+	    /**
+	     * @return The pairs used by the last step
+	     */
+	    Correspondences const& getCorrespondences() const;
+	    /**
+	     * @return Time spent in each stage since construction or the last call to resetStageTimes()
+	     */
+	    StageTimes const& getStageTimes() const;
+	    /**
+	     * @brief Sets all stage times to zero
+	     */
+	    void resetStageTimes();
+	private:
+	    typedef std::chrono::steady_clock Clock;
+
+	    /**
+	     * @brief Adds the time passed since \p begin to \p time and restarts \p begin
+	     * @param begin Start of the measured interval
+	     * @param time Accumulated time to add to
+	     */
+	    static void lap(Clock::time_point& begin, double& time);
+
+	    Matcher& m_matcher;
+	    Solver& m_solver;
+	    Selector* m_pSelector = nullptr;
+	    std::vector<Rejector*> m_rejectors;
+	    Weighter* m_pWeighter = nullptr;
+	    Applier* m_pApplier = nullptr;
+	    EdgeRejector m_edgeRejector;
+	    RigidApplier m_rigidApplier;
+	    Correspondences m_correspondences;
+	    StageTimes m_stageTimes;
+    };
+}
+
+#endif /* PIPELINEICP_H_ */
@@ -0,0 +1,297 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Shape Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef PIPELINESTAGES_H_
+#define PIPELINESTAGES_H_
+
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include <Eigen/SVD>
+#include "Correspondences.h"
+#include "SFA/Utility/AbstractMesh.h"
+#include "SFA/Utility/Arena.h"
+#include "SFA/Utility/Parallel.h"
+#include "SFA/NearestNeighbor/NearestNeighbor.h"
+
+namespace sfa
+{
+    /**
+     * @brief Pipeline stage that chooses the source vertices to find partners for
+     */
+    class Selector
+    {
+	public:
+	    virtual ~Selector();
+	    /**
+	     * @brief Replaces the content of \p c by one pair per selected vertex of \p source
+	     * @details Only the source indices need to be set.
+	     * @param source Source model
+	     * @param[out] c Correspondence buffer
+	     */
+	    virtual void select(AbstractMesh const& source, Correspondences& c) = 0;
+    };
+
+    /**
+     * @brief Pipeline stage that finds a destination vertex for every pair
+     */
+    class Matcher
+    {
+	public:
+	    virtual ~Matcher();
+	    /**
+	     * @brief Sets destination index and distance of all pairs in \p c
+	     * @param source Source model
+	     * @param dest Destination model
+	     * @param[in,out] c Correspondence buffer
+	     * @param threads Maximum amount of threads to use or 0 to use one per hardware thread
+	     */
+	    virtual void match(AbstractMesh const& source, AbstractMesh const& dest, Correspondences& c,
+		    unsigned int threads) = 0;
+    };
+
+    /**
+     * @brief Pipeline stage that removes unsuitable pairs
+     */
+    class Rejector
+    {
+	public:
+	    virtual ~Rejector();
+	    /**
+	     * @brief Removes all unsuitable pairs from \p c
+	     * @param source Source model
+	     * @param dest Destination model
+	     * @param[in,out] c Correspondence buffer
+	     */
+	    virtual void reject(AbstractMesh const& source, AbstractMesh const& dest, Correspondences& c) = 0;
+    };
+
+    /**
+     * @brief Pipeline stage that assigns a weight to every pair
+     */
+    class Weighter
+    {
+	public:
+	    virtual ~Weighter();
+	    /**
+	     * @brief Modifies the weights of all pairs in \p c
+	     * @param source Source model
+	     * @param dest Destination model
+	     * @param[in,out] c Correspondence buffer
+	     */
+	    virtual void weigh(AbstractMesh const& source, AbstractMesh const& dest, Correspondences& c) = 0;
+    };
+
+    /**
+     * @brief Pipeline stage that computes a transformation from a set of weighted pairs
+     */
+    class Solver
+    {
+	public:
+	    virtual ~Solver();
+	    /**
+	     * @brief Computes the transformation that moves \p source closer to \p dest
+	     * @param source Source model
+	     * @param dest Destination model
+	     * @param c Correspondence buffer
+	     * @param arena Arena to allocate temporaries from. It is reset by the caller.
+	     * @param threads Maximum amount of threads to use or 0 to use one per hardware thread
+	     * @param[out] transformation The computed transformation
+	     * @return True in case there were enough pairs to compute a transformation, otherwise false
+	     */
+	    virtual bool solve(AbstractMesh const& source, AbstractMesh const& dest, Correspondences const& c,
+		    Arena& arena, unsigned int threads, Eigen::Isometry3d& transformation) = 0;
+    };
+
+    /**
+     * @brief Pipeline stage that moves the source mesh
+     */
+    class Applier
+    {
+	public:
+	    virtual ~Applier();
+	    /**
+	     * @brief Applies \p transformation to \p source
+	     * @param source Source model
+	     * @param transformation Transformation computed by the solver
+	     */
+	    virtual void apply(AbstractMesh& source, Eigen::Isometry3d const& transformation) = 0;
+    };
+
+    /**
+     * @brief Matches every pair with the nearest neighbor of its source vertex
+     * @details Uses NearestNeighbor::findNearest() in parallel, thus no cache is read or written.
+     */
+    class NearestNeighborMatcher : public Matcher
+    {
+	public:
+	    /**
+	     * @brief Constructor
+	     * @param nn Nearest neighbor implementation to use
+	     */
+	    NearestNeighborMatcher(NearestNeighbor& nn);
+	    virtual void match(AbstractMesh const& source, AbstractMesh const& dest, Correspondences& c,
+		    unsigned int threads);
+	private:
+	    NearestNeighbor& m_nearestNeighbor;
+    };
+
+    /**
+     * @brief Rejects all pairs whose destination vertex is located on the edge of the destination mesh
+     */
+    class EdgeRejector : public Rejector
+    {
+	public:
+	    virtual void reject(AbstractMesh const& source, AbstractMesh const& dest, Correspondences& c);
+    };
+
+    /**
+     * @brief Rejects all pairs that are much farther apart than the median pair
+     */
+    class DistanceRejector : public Rejector
+    {
+	public:
+	    /**
+	     * @brief Constructor
+	     * @param factor Pairs farther apart than \p factor times the median distance are rejected
+	     */
+	    DistanceRejector(double factor = 3);
+	    virtual void reject(AbstractMesh const& source, AbstractMesh const& dest, Correspondences& c);
+	    /**
+	     * @return Multiple of the median distance above which pairs are rejected
+	     */
+	    double getFactor() const;
+	    /**
+	     * @brief Modifies the multiple of the median distance above which pairs are rejected
+	     * @param factor New factor
+	     */
+	    void setFactor(double factor);
+	private:
+	    double m_factor;
+	    /**
+	     * @brief Copy of the distances to find the median in, reused across calls
+	     */
+	    std::vector<double> m_distances;
+    };
+
+    /**
+     * @brief Scales the weight of every pair by 1 - distance / maximum distance
+     */
+    class DistanceWeighter : public Weighter
+    {
+	public:
+	    virtual void weigh(AbstractMesh const& source, AbstractMesh const& dest, Correspondences& c);
+    };
+
+    /**
+     * @brief Minimizes the weighted point-to-point distance of all pairs
+     * @details Moments of the pairs are accumulated in parallel. Needs at least 3 pairs.
+     */
+    class PointToPointSolver : public Solver
+    {
+	public:
+	    virtual bool solve(AbstractMesh const& source, AbstractMesh const& dest, Correspondences const& c,
+		    Arena& arena, unsigned int threads, Eigen::Isometry3d& transformation);
+	    /**
+	     * @brief Same as solve(), but accesses the meshes through their concrete type
+	     * @details Allows the compiler to resolve all per-pair calls statically.
+	     */
+	    template<class MeshType> bool solveFor(MeshType const& source, MeshType const& dest,
+		    Correspondences const& c, Arena& arena, unsigned int threads, Eigen::Isometry3d& transformation);
+	private:
+	    /**
+	     * @brief Weighted means and cross-covariance of a set of point pairs
+	     */
+	    struct PairMoments
+	    {
+		public:
+		    unsigned int amount = 0;
+		    double weight = 0;
+		    Eigen::Vector3d srcMean = Eigen::Vector3d::Zero();
+		    Eigen::Vector3d destMean = Eigen::Vector3d::Zero();
+		    /**
+		     * @brief Weighted sum of (x - srcMean) * (y - destMean)^T
+		     */
+		    Eigen::Matrix3d covariance = Eigen::Matrix3d::Zero();
+		    /**
+		     * @brief Adds a single point pair
+		     * @param x Source point
+		     * @param y Destination point
+		     * @param w Weight of the pair, has to be positive
+		     */
+		    void add(Eigen::Vector3d const& x, Eigen::Vector3d const& y, double w);
+		    /**
+		     * @brief Adds all point pairs of \p other
+		     * @param other Moments to merge into this
+		     */
+		    void merge(PairMoments const& other);
+	    };
+
+	    /**
+	     * @brief Amount of point pairs accumulated as one work item
+	     */
+	    static const unsigned int ChunkSize = 256;
+    };
+
+    /**
+     * @brief Minimizes the weighted point-to-plane distance of all pairs
+     * @details Uses the small angle approximation. The normal equations of the linearized problem
+     * 		are accumulated in parallel. Needs at least 6 pairs.
+     */
+    class PointToPlaneSolver : public Solver
+    {
+	public:
+	    virtual bool solve(AbstractMesh const& source, AbstractMesh const& dest, Correspondences const& c,
+		    Arena& arena, unsigned int threads, Eigen::Isometry3d& transformation);
+	    /**
+	     * @brief Same as solve(), but accesses the meshes through their concrete type
+	     * @details Allows the compiler to resolve all per-pair calls statically.
+	     */
+	    template<class MeshType> bool solveFor(MeshType const& source, MeshType const& dest,
+		    Correspondences const& c, Arena& arena, unsigned int threads, Eigen::Isometry3d& transformation);
+	private:
+	    typedef Eigen::Matrix<double, 6, 6> Matrix6d;
+	    typedef Eigen::Matrix<double, 6, 1> Vector6d;
+
+	    template<typename MatrixType> MatrixType pseudoInverse(const MatrixType &a,
+		    double epsilon = std::numeric_limits<typename MatrixType::Scalar>::epsilon());
+
+	    /**
+	     * @brief Normal equations of a set of point pairs
+	     */
+	    struct NormalEquations
+	    {
+		public:
+		    unsigned int amount = 0;
+		    Matrix6d AtA = Matrix6d::Zero();
+		    Vector6d Atb = Vector6d::Zero();
+	    };
+
+	    /**
+	     * @brief Amount of point pairs accumulated as one work item
+	     */
+	    static const unsigned int ChunkSize = 256;
+    };
+
+    /**
+     * @brief Applies a rigid transformation to coordinates and normals of all vertices
+     */
+    class RigidApplier : public Applier
+    {
+	public:
+	    virtual void apply(AbstractMesh& source, Eigen::Isometry3d const& transformation);
+    };
+}
+
+#include "PipelineStages.imp"
+
+#endif /* PIPELINESTAGES_H_ */
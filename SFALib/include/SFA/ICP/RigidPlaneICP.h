@@ -11,17 +11,17 @@
 #ifndef RIGIDPLANEICP_H_
 #define RIGIDPLANEICP_H_
 
-#include <limits>
-#include <Eigen/Core>
-#include <Eigen/Geometry>
-#include <Eigen/LU>
-#include <Eigen/SVD>
-#include "ICP.h"
+#include "PipelineICP.h"
 #include "SFA/NearestNeighbor/NearestNeighbor.h"
 
 namespace sfa
 {
-    class RigidPlaneICP : public ICP
+    /**
+     * @brief Rigid body point-to-plane ICP
+     * @details Pipeline of nearest neighbor matching and a PointToPlaneSolver. Correspondences are
+     * 		searched and accumulated in parallel.
+     */
+    class RigidPlaneICP : public PipelineICP
     {
 	public:
 	    /**
@@ -33,10 +33,9 @@ namespace sfa
 	    virtual ~RigidPlaneICP();
 	    virtual unsigned int calcNextStep(AbstractMesh& source, AbstractMesh const& dest);
 	private:
-	    template<typename MatrixType> MatrixType pseudoInverse(const MatrixType &a,
-		    double epsilon = std::numeric_limits<typename MatrixType::Scalar>::epsilon());
-
 	    NearestNeighbor& m_nearestNeighbor;
+	    NearestNeighborMatcher m_matcher;
+	    PointToPlaneSolver m_solver;
     };
 }
 
@@ -11,20 +11,21 @@
 #ifndef RIGIDPOINTICP_H_
 #define RIGIDPOINTICP_H_
 
-#include <Eigen/SVD>
-#include "ICP.h"
+#include "PipelineICP.h"
 #include "SFA/NearestNeighbor/NearestNeighbor.h"
 
 namespace sfa
 {
     /**
      * @brief Rigid body point-to-point ICP
+     * @details Pipeline of nearest neighbor matching and a PointToPointSolver. Correspondences are
+     * 		searched and accumulated in parallel.
      */
-    class RigidPointICP: public ICP
+    class RigidPointICP: public PipelineICP
     {
 	public:
 	    /**
-	     * @brief Constructs the icp object using nn to get the nearest neighbors
+	     * @brief Constructs the icp object using \p nn to get the nearest neighbors
 	     * @param nn Nearest neighbor implementation to use
 	     * @param pLog Log to use or nullptr to disable logging
 	     */
@@ -33,6 +34,8 @@ namespace sfa
 	    virtual unsigned int calcNextStep(AbstractMesh& source, AbstractMesh const& dest);
 	private:
 	    NearestNeighbor& m_nearestNeighbor;
+	    NearestNeighborMatcher m_matcher;
+	    PointToPointSolver m_solver;
     };
 }
 
@@ -12,9 +12,13 @@
 #define NEARESTNEIGHBOR_H_
 
 #include <vector>
+#include <cstdint>
 #include <stdexcept>
+#include <limits>
+#include <algorithm>
 #include <Eigen/Core>
 #include "SFA/Utility/AbstractMesh.h"
+#include "SFA/Utility/Parallel.h"
 
 namespace sfa
 {
@@ -33,6 +37,15 @@ namespace sfa
 	     * @return Number of the destination vertex that's closest to source
 	     */
 	    virtual unsigned int getNearest(unsigned int n, AbstractMesh const& source, AbstractMesh const& dest) = 0;
+	    /**
+	     * @brief Computes the vertex on dest that is closest to an arbitrary point
+	     * @details In contrast to getNearest() this doesn't touch any cache and may be called
+	     * 		from multiple threads at once. The default implementation is a linear search.
+	     * @param point Point to find the nearest neighbor for
+	     * @param dest Destination mesh
+	     * @return Number of the destination vertex that's closest to \p point
+	     */
+	    virtual unsigned int findNearest(Eigen::Vector3d const& point, AbstractMesh const& dest) const;
 	    /**
 	     * @brief Calculates all nearest neighbors for points on source on dest
 	     * @param points Points on source to calculate nearest neighbors for
@@ -41,12 +54,35 @@ namespace sfa
 	     * @return List of all nearest neighbors for the passed points
 	     */
 	    std::vector<Vertex> getAllNearest(std::vector<Vertex> points, AbstractMesh const& source, AbstractMesh const& dest);
+	    /**
+	     * @brief Calculates all nearest neighbors for points on source on dest
+	     * @param indices Indices of the points on source to calculate nearest neighbors for
+	     * @param source Source mesh
+	     * @param dest Destination mesh
+	     * @param[out] nearest Indices of the nearest neighbors on dest. Previous content is replaced,
+	     * 			   but memory is reused.
+	     */
+	    void getAllNearest(std::vector<uint32_t> const& indices, AbstractMesh const& source,
+		    AbstractMesh const& dest, std::vector<uint32_t>& nearest);
+	    /**
+	     * @brief Calculates all nearest neighbors for points on source on dest using several threads
+	     * @details Uses findNearest(), thus no cache is read or written.
+	     * @param indices Indices of the points on source to calculate nearest neighbors for
+	     * @param source Source mesh
+	     * @param dest Destination mesh
+	     * @param[out] nearest Indices of the nearest neighbors on dest. Previous content is replaced,
+	     * 			   but memory is reused.
+	     * @param threads Maximum amount of threads to use or 0 to use one per hardware thread
+	     */
+	    void findAllNearest(std::vector<uint32_t> const& indices, AbstractMesh const& source,
+		    AbstractMesh const& dest, std::vector<uint32_t>& nearest, unsigned int threads = 0) const;
 	    /**
 	     * @brief Computes the error between two meshes
 	     * @details Error is measured by the mean squared distance between points
 	     * 		and their nearest neighbors. Note that switching source and
 	     * 		dest can give a different result due to recalculation of
-	     * 		nearest neighbors.
+	     * 		nearest neighbors. Nearest neighbors are found in parallel using
+	     * 		findNearest().
 	     * @param source Source mesh
 	     * @param dest Destination mesh
 	     * @return Error value
@@ -73,6 +109,10 @@ namespace sfa
 	     */
 	    virtual void clearCache() = 0;
 	private:
+	    /**
+	     * @brief Amount of points handed to a thread at once
+	     */
+	    static const unsigned int ChunkSize = 256;
     };
 }
 
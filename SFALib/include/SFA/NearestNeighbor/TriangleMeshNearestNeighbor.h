@@ -0,0 +1,40 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Shape Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef TRIANGLEMESHNEARESTNEIGHBOR_H_
+#define TRIANGLEMESHNEARESTNEIGHBOR_H_
+
+#include "SFA/NearestNeighbor/NearestNeighbor.h"
+#include "SFA/Utility/TriangleMesh.h"
+
+namespace sfa
+{
+    /**
+     * @brief This nearest neighbor search uses the vertex tree kept by TriangleMesh
+     */
+    class TriangleMeshNearestNeighbor final : public NearestNeighbor
+    {
+	public:
+	    virtual unsigned int getNearest(unsigned int n, AbstractMesh const& source, AbstractMesh const& dest);
+	    virtual unsigned int findNearest(Eigen::Vector3d const& point, AbstractMesh const& dest) const;
+	    /**
+	     * @brief Finds the nearest neighbor of a point on a mesh without any runtime type checks
+	     * @param point Point to find the nearest neighbor for
+	     * @param dest Mesh to search on
+	     * @return Index of the nearest vertex on dest
+	     */
+	    unsigned int findNearest(Eigen::Vector3d const& point, TriangleMesh const& dest) const;
+	    virtual void clearCache();
+    };
+}
+
+
+
+#endif /* TRIANGLEMESHNEARESTNEIGHBOR_H_ */
@@ -11,8 +11,11 @@
 #ifndef ABSTRACTMESH_H_
 #define ABSTRACTMESH_H_
 
+#include <atomic>
+#include <stdexcept>
 #include <Eigen/Core>
 #include "SFA/Utility/Vertex.h"
+#include "SFA/Utility/Adjacency.h"
 
 namespace sfa
 {
@@ -37,6 +40,52 @@ namespace sfa
 	     * 		  (i.e. no vertex with this number exists)
 	     */
 	    virtual Vertex getVertex(unsigned int n) const = 0;
+	    /**
+	     * @brief Provides the coordinates of vertex n
+	     * @details In contrast to getVertex() this doesn't need to copy the neighborhood of the
+	     * 		vertex. The default implementation still does, meshes should override it.
+	     * @param n Number of the vertex
+	     * @return Coordinates of vertex n
+	     * @exception Throws an exception in case n is out of bounds
+	     */
+	    virtual Eigen::Vector3d getCoords(unsigned int n) const;
+	    /**
+	     * @brief Provides the normal of vertex n
+	     * @details See getCoords().
+	     * @param n Number of the vertex
+	     * @return Normal of vertex n
+	     * @exception Throws an exception in case n is out of bounds
+	     */
+	    virtual Eigen::Vector3d getNormal(unsigned int n) const;
+	    /**
+	     * @brief Checks if vertex n is located on the border of the mesh
+	     * @details See getCoords().
+	     * @param n Number of the vertex
+	     * @return True in case vertex n is an edge vertex, otherwise false
+	     * @exception Throws an exception in case n is out of bounds
+	     */
+	    virtual bool isEdge(unsigned int n) const;
+	    /**
+	     * @brief Provides the coordinates of all vertices at once
+	     * @details Column n holds the coordinates of vertex n. The view is backed by the mesh,
+	     * 		it reflects later calls to setVertex() and stays valid until the amount of
+	     * 		vertices changes.
+	     * @return Packed coordinates of all vertices
+	     */
+	    virtual Eigen::Map<Eigen::Matrix3Xd const> getPositions() const = 0;
+	    /**
+	     * @brief Provides the normals of all vertices at once
+	     * @details See getPositions().
+	     * @return Packed normals of all vertices
+	     */
+	    virtual Eigen::Map<Eigen::Matrix3Xd const> getNormals() const = 0;
+	    /**
+	     * @brief Provides the neighborhood of all vertices
+	     * @details Vertices are neighbors if they share a face. The reference stays valid until
+	     * 		the amount of vertices changes.
+	     * @return Adjacency with one node per vertex
+	     */
+	    virtual Adjacency const& getAdjacency() const = 0;
 	    /**
 	     * @brief Alters a vertex's position and normal
 	     * @param n ID of the vertex to modify
@@ -44,6 +93,23 @@ namespace sfa
 	     * @param normal New normal
 	     */
 	    virtual void setVertex(unsigned int n, Eigen::Vector3d const& coords, Eigen::Vector3d const& normal) = 0;
+	    /**
+	     * @brief Moves all vertices by a rigid transformation
+	     * @details Coordinates are mapped to R * coords + t, normals are rotated by R. The default
+	     * 		implementation calls setVertex() for every vertex, meshes should override it.
+	     * @param R Rotation
+	     * @param t Translation
+	     */
+	    virtual void applyTransform(Eigen::Matrix3d const& R, Eigen::Vector3d const& t);
+	    /**
+	     * @brief Replaces the coordinates of all vertices at once
+	     * @details Normals are kept. The default implementation calls setVertex() for every vertex,
+	     * 		meshes should override it.
+	     * @param positions New coordinates, column n holds the coordinates of vertex n
+	     * @exception Throws std::invalid_argument in case the amount of columns doesn't match the
+	     * 		  amount of vertices
+	     */
+	    virtual void setPositions(Eigen::Ref<Eigen::Matrix3Xd const> const& positions);
 	    /**
 	     * @return Amount of vertices of this mesh
 	     */
@@ -53,6 +119,27 @@ namespace sfa
 	     * @return Average vector of the mesh
 	     */
 	    virtual Eigen::Vector3d getAverage() const = 0;
+	    /**
+	     * @brief Provides a number identifying the current state of the mesh
+	     * @details The generation changes whenever vertices are modified. Algorithms may use it
+	     * 		to find out whether data they cached for a mesh is still up to date. Two meshes
+	     * 		only share a generation if one is an unmodified copy of the other.
+	     * @return The current generation of this mesh
+	     */
+	    virtual unsigned int getGeneration() const = 0;
+	    /**
+	     * @brief Provides a number identifying the shape of the mesh
+	     * @details Works like the generation, but rigid transformations keep the shape
+	     * 		generation. Algorithms may use it for cached data that doesn't depend on the pose.
+	     * @return The current shape generation of this mesh
+	     */
+	    virtual unsigned int getShapeGeneration() const = 0;
+	protected:
+	    /**
+	     * @brief Draws a new, globally unique generation number
+	     * @return The generation number
+	     */
+	    static unsigned int newGeneration();
     };
 }
 
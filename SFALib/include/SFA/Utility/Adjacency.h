@@ -0,0 +1,130 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Shape Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef ADJACENCY_H_
+#define ADJACENCY_H_
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include "SFA/Utility/Parallel.h"
+
+namespace sfa
+{
+    /**
+     * @brief Relation between nodes in compressed sparse row format
+     * @details The related nodes of node n are stored contiguously and in increasing order
+     * 		at indices [offsets[n], offsets[n + 1]) of one shared array. Used for mesh
+     * 		neighborhoods as well as for mapping one node to a group of others.
+     */
+    class Adjacency
+    {
+	public:
+	    /**
+	     * @brief View on the related nodes of a single node
+	     * @details Stays valid until the adjacency it was taken from is modified or destroyed.
+	     */
+	    class Range
+	    {
+		public:
+		    /**
+		     * @brief Constructs an empty range
+		     */
+		    Range();
+		    /**
+		     * @brief Constructs a range of the nodes in [\p first, \p last)
+		     * @param first First node
+		     * @param last One past the last node
+		     */
+		    Range(uint32_t const* first, uint32_t const* last);
+		    uint32_t const* begin() const;
+		    uint32_t const* end() const;
+		    /**
+		     * @return Amount of nodes in this range
+		     */
+		    unsigned int size() const;
+		    /**
+		     * @return True in case there are no nodes in this range
+		     */
+		    bool empty() const;
+		    /**
+		     * @param i Position within the range
+		     * @return Node at position \p i
+		     */
+		    uint32_t operator[](unsigned int i) const;
+		private:
+		    uint32_t const* m_first;
+		    uint32_t const* m_last;
+	    };
+
+	    /**
+	     * @brief Builds the adjacency of a triangle mesh
+	     * @details Nodes are adjacent if they share a triangle. Related nodes are counted,
+	     * 		scattered, sorted and deduplicated in parallel.
+	     * @param amountOfNodes Amount of nodes
+	     * @param triangles Three node indices per triangle
+	     * @param threads Maximum amount of threads to use or 0 to use one per hardware thread
+	     */
+	    void buildFromTriangles(unsigned int amountOfNodes, std::vector<uint32_t> const& triangles,
+		    unsigned int threads = 0);
+	    /**
+	     * @brief Builds a mapping from every group to its members
+	     * @details Afterwards node g is related to all indices i with groups[i] == g.
+	     * @param amountOfGroups Amount of groups
+	     * @param groups Group of every member. Members with a group of at least \p amountOfGroups
+	     * 		     don't belong to any group.
+	     */
+	    void buildFromGroups(unsigned int amountOfGroups, std::vector<uint32_t> const& groups);
+	    /**
+	     * @brief Removes all nodes
+	     */
+	    void clear();
+	    /**
+	     * @return Amount of nodes
+	     */
+	    unsigned int getAmountOfNodes() const;
+	    /**
+	     * @param n Index of the node
+	     * @return Amount of nodes related to node \p n
+	     */
+	    unsigned int getDegree(unsigned int n) const;
+	    /**
+	     * @param n Index of the node
+	     * @return All nodes related to node \p n in increasing order
+	     */
+	    Range getNeighbors(unsigned int n) const;
+	    /**
+	     * @brief Collects all nodes that can be reached from node \p n in at most \p k steps
+	     * @param n Index of the node
+	     * @param k Maximum amount of steps
+	     * @param[out] ring Reachable nodes other than \p n in increasing order. Previous content is
+	     * 		       replaced, but memory is reused.
+	     */
+	    void getRing(unsigned int n, unsigned int k, std::vector<uint32_t>& ring) const;
+	    /**
+	     * @return Offset of the first related node of every node, followed by the total amount
+	     */
+	    std::vector<uint32_t> const& getOffsets() const;
+	    /**
+	     * @return Related nodes of all nodes
+	     */
+	    std::vector<uint32_t> const& getIndices() const;
+	private:
+	    /**
+	     * @brief Amount of nodes handed to a thread at once
+	     */
+	    static const unsigned int ChunkSize = 1024;
+
+	    std::vector<uint32_t> m_offsets = std::vector<uint32_t>(1, 0);
+	    std::vector<uint32_t> m_indices;
+    };
+}
+
+#endif /* ADJACENCY_H_ */
@@ -0,0 +1,122 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Shape Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef ARENA_H_
+#define ARENA_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include <new>
+#include <stdexcept>
+#include <Eigen/Core>
+
+namespace sfa
+{
+    /**
+     * @brief Monotonic allocator for short-lived temporaries
+     * @details Memory is handed out by bumping an offset into a block and released all at once by
+     * 		reset(). If the current block is exhausted a bigger one is allocated. On reset all
+     * 		blocks are merged into a single one that is large enough for everything that was
+     * 		allocated before, thus a workload that needs the same amount of memory every time only
+     * 		allocates from the heap during its first run and the reset that follows it.
+     * 		Destructors of objects created in the arena are never called. Not thread-safe,
+     * 		memory should be allocated up front and then be filled by the workers.
+     */
+    class Arena
+    {
+	public:
+	    /**
+	     * @brief Constructor
+	     * @param initialSize Size of the first block in bytes
+	     */
+	    Arena(std::size_t initialSize = 4096);
+	    /**
+	     * @brief Copy constructor
+	     * @details Doesn't copy any memory, the new arena starts out empty.
+	     * @param other Arena to take the initial size from
+	     */
+	    Arena(Arena const& other);
+	    /**
+	     * @brief Copy assignment
+	     * @details Arenas only hold temporaries, thus this keeps everything as it is.
+	     * @param other Ignored
+	     * @return Reference to this arena
+	     */
+	    Arena& operator=(Arena const& other);
+	    /**
+	     * @brief Provides uninitialized memory
+	     * @param bytes Amount of bytes
+	     * @param alignment Alignment of the memory, has to be a power of two
+	     * @return Pointer to the memory, valid until the next call to reset()
+	     */
+	    void* allocate(std::size_t bytes, std::size_t alignment = 16);
+	    /**
+	     * @brief Provides uninitialized memory for \p amount objects of type \p T
+	     * @param amount Amount of objects
+	     * @return Pointer to the first object, valid until the next call to reset()
+	     */
+	    template<typename T> T* allocate(std::size_t amount);
+	    /**
+	     * @brief Creates \p amount copies of \p value
+	     * @param amount Amount of objects
+	     * @param value Value to copy
+	     * @return Pointer to the first object, valid until the next call to reset()
+	     */
+	    template<typename T> T* create(std::size_t amount, T const& value);
+	    /**
+	     * @brief Provides an uninitialized matrix
+	     * @param rows Amount of rows
+	     * @param cols Amount of columns
+	     * @return Map of the matrix, valid until the next call to reset()
+	     */
+	    template<typename MatrixType> Eigen::Map<MatrixType> allocateMatrix(unsigned int rows, unsigned int cols);
+	    /**
+	     * @brief Releases all memory handed out so far
+	     */
+	    void reset();
+	    /**
+	     * @return Amount of bytes handed out since the last call to reset()
+	     */
+	    std::size_t getUsed() const;
+	    /**
+	     * @return Amount of bytes currently allocated from the heap
+	     */
+	    std::size_t getCapacity() const;
+	    /**
+	     * @return Amount of heap allocations done by this arena so far
+	     */
+	    unsigned int getHeapAllocations() const;
+	private:
+	    /**
+	     * @brief Allocates a new block from the heap
+	     * @param size Minimum size of the block
+	     */
+	    void addBlock(std::size_t size);
+
+	    struct Block
+	    {
+		public:
+		    std::unique_ptr<char[]> data;
+		    std::size_t size = 0;
+	    };
+	    std::vector<Block> m_blocks;
+	    std::size_t m_offset = 0;
+	    std::size_t m_used = 0;
+	    std::size_t m_initialSize;
+	    unsigned int m_heapAllocations = 0;
+    };
+}
+
+#include "Arena.imp"
+
+#endif /* ARENA_H_ */
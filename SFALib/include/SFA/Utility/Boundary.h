@@ -0,0 +1,70 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Shape Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef BOUNDARY_H_
+#define BOUNDARY_H_
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include "SFA/Utility/Parallel.h"
+
+namespace sfa
+{
+    /**
+     * @brief Finds the boundary of a triangle mesh
+     * @details An edge used by exactly one triangle is a boundary edge, its vertices are boundary
+     * 		vertices. Edges are collected from all triangles and sorted in parallel, thus the
+     * 		boundary is found in O(F log F) without walking any neighborhoods.
+     */
+    class Boundary
+    {
+	public:
+	    /**
+	     * @brief Finds the boundary of a triangle mesh
+	     * @param amountOfVertices Amount of vertices
+	     * @param triangles Three vertex indices per triangle. Degenerated triangles are ignored.
+	     * @param threads Maximum amount of threads to use or 0 to use one per hardware thread
+	     */
+	    void build(unsigned int amountOfVertices, std::vector<uint32_t> const& triangles,
+		    unsigned int threads = 0);
+	    /**
+	     * @param n Index of the vertex
+	     * @return True in case vertex \p n is incident to a boundary edge
+	     */
+	    bool isBoundary(unsigned int n) const;
+	    /**
+	     * @return One flag per vertex, non-zero for boundary vertices
+	     */
+	    std::vector<char> const& getFlags() const;
+	    /**
+	     * @return Amount of boundary edges
+	     */
+	    unsigned int getAmountOfEdges() const;
+	    /**
+	     * @brief Provides the boundary loops
+	     * @details Every loop lists its vertices in the order given by the orientation of the
+	     * 		adjacent triangles. Without a manifold boundary a loop may also be an open chain.
+	     * @return All boundary loops
+	     */
+	    std::vector<std::vector<uint32_t>> const& getLoops() const;
+	private:
+	    /**
+	     * @brief Amount of triangles handed to a thread at once
+	     */
+	    static const unsigned int ChunkSize = 4096;
+
+	    std::vector<char> m_flags;
+	    unsigned int m_amountOfEdges = 0;
+	    std::vector<std::vector<uint32_t>> m_loops;
+    };
+}
+
+#endif /* BOUNDARY_H_ */
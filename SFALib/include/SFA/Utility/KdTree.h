@@ -0,0 +1,99 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Shape Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef SFA_KDTREE_H_
+#define SFA_KDTREE_H_
+
+#include <vector>
+#include <stdexcept>
+#include <queue>
+#include <utility>
+#include <limits>
+#include <algorithm>
+#include <Eigen/Core>
+
+namespace sfa
+{
+    /**
+     * @brief Static k-d tree over points of arbitrary, but fixed dimension
+     * @details In contrast to the DBGL implementation this one doesn't depend on any rendering
+     * 		types and works for high dimensional data like feature descriptors. The tree is
+     * 		built once and can't be modified afterwards. All queries are const and may be
+     * 		run from multiple threads at once.
+     * @tparam Dim Dimension of the points
+     */
+    template<int Dim> class KdTree
+    {
+	public:
+	    typedef Eigen::Matrix<double, Dim, 1> Point;
+	    typedef Eigen::Matrix<double, Dim, Eigen::Dynamic> PointList;
+
+	    /**
+	     * @brief Builds the tree
+	     * @param points Points to store, one per column. The column index is used as identifier.
+	     */
+	    void build(PointList const& points);
+	    /**
+	     * @return Amount of stored points
+	     */
+	    unsigned int size() const;
+	    /**
+	     * @brief Finds the stored point closest to \p query
+	     * @param query Point to search for
+	     * @param[out] pSqDist If not nullptr the squared distance to the nearest point is copied here
+	     * @return Index of the closest point
+	     * @exception std::out_of_range if the tree is empty
+	     */
+	    unsigned int findNearest(Point const& query, double* pSqDist = nullptr) const;
+	    /**
+	     * @brief Finds the \p k stored points closest to \p query
+	     * @param query Point to search for
+	     * @param k Amount of points to find
+	     * @param[out] out Indices of the closest points sorted by increasing distance. Previous
+	     * 		       content is replaced.
+	     */
+	    void findKNearest(Point const& query, unsigned int k, std::vector<unsigned int>& out) const;
+	private:
+	    /**
+	     * @brief Node of the tree, leafs have a negative split dimension
+	     */
+	    struct Node
+	    {
+		public:
+		    unsigned int begin;
+		    unsigned int end;
+		    int dim;
+		    double split;
+		    unsigned int left;
+		    unsigned int right;
+	    };
+	    typedef std::priority_queue<std::pair<double, unsigned int>> Candidates;
+
+	    /**
+	     * @brief Recursively builds the subtree over m_indices[begin] to m_indices[end - 1]
+	     * @return Index of the new node
+	     */
+	    unsigned int buildNode(unsigned int begin, unsigned int end);
+	    void searchNearest(unsigned int node, Point const& query, unsigned int& best, double& bestSqDist) const;
+	    void searchKNearest(unsigned int node, Point const& query, unsigned int k, Candidates& candidates) const;
+
+	    PointList m_points;
+	    std::vector<unsigned int> m_indices;
+	    std::vector<Node> m_nodes;
+	    /**
+	     * @brief Maximum amount of points per leaf
+	     */
+	    unsigned int m_leafSize = 8;
+    };
+}
+
+#include "KdTree.imp"
+
+#endif /* SFA_KDTREE_H_ */
@@ -0,0 +1,57 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Shape Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef MAPPEDFILE_H_
+#define MAPPEDFILE_H_
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <stdexcept>
+
+namespace sfa
+{
+    /**
+     * @brief Read-only view on the content of a file
+     * @details On POSIX systems the file is mapped into memory, thus pages are only loaded once
+     * 		they are accessed and no copy is made. Other systems fall back to reading the whole
+     * 		file into a buffer.
+     */
+    class MappedFile
+    {
+	public:
+	    /**
+	     * @brief Maps a file
+	     * @param path Path of the file
+	     * @exception Throws std::runtime_error in case the file can't be read
+	     */
+	    explicit MappedFile(std::string const& path);
+	    MappedFile(MappedFile const& other) = delete;
+	    ~MappedFile();
+	    /**
+	     * @return First character of the file or nullptr in case the file is empty
+	     */
+	    char const* data() const;
+	    /**
+	     * @return Size of the file in bytes
+	     */
+	    std::size_t size() const;
+	    MappedFile& operator=(MappedFile const& other) = delete;
+	private:
+	    char const* m_pData = nullptr;
+	    std::size_t m_size = 0;
+	    /**
+	     * @brief Content of the file in case it couldn't be mapped
+	     */
+	    std::vector<char> m_buffer;
+    };
+}
+
+#endif /* MAPPEDFILE_H_ */
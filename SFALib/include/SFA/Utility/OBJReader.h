@@ -0,0 +1,139 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Shape Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef OBJREADER_H_
+#define OBJREADER_H_
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include "SFA/Utility/Parallel.h"
+#include "SFA/Utility/MappedFile.h"
+
+namespace sfa
+{
+    /**
+     * @brief Reads the geometry of a Wavefront OBJ file without any rendering dependencies
+     * @details Only vertex coordinates, vertex normals and faces are read, everything else is
+     * 		skipped. Polygons are split into triangle fans. Negative indices are resolved
+     * 		relative to the amount of elements read so far.
+     * 		The data is split into line-aligned chunks that are processed in two parallel passes.
+     * 		The first one counts the elements of every chunk, thus the second one knows where
+     * 		in the output each chunk starts and parses numbers straight into place. Nothing is
+     * 		allocated per line or token.
+     */
+    class OBJReader
+    {
+	public:
+	    /**
+	     * @brief Normal index of triangle corners that don't reference a normal
+	     */
+	    static const uint32_t NoNormal = std::numeric_limits<uint32_t>::max();
+
+	    /**
+	     * @brief Reads a file
+	     * @details The file is memory mapped, see MappedFile. Previously read data is replaced.
+	     * @param path Path of the file
+	     * @param threads Maximum amount of threads to use or 0 to use one per hardware thread
+	     * @exception Throws std::runtime_error in case the file can't be read or is malformed
+	     */
+	    void read(std::string const& path, unsigned int threads = 0);
+	    /**
+	     * @brief Parses OBJ data from memory
+	     * @details Previously read data is replaced.
+	     * @param begin First character
+	     * @param end One past the last character
+	     * @param chunkSize Approximate amount of characters handed to a thread at once
+	     * @param threads Maximum amount of threads to use or 0 to use one per hardware thread
+	     * @exception Throws std::runtime_error in case the data is malformed
+	     */
+	    void parse(char const* begin, char const* end, std::size_t chunkSize = ChunkSize,
+		    unsigned int threads = 0);
+	    /**
+	     * @return Coordinates of all vertices, three consecutive values per vertex
+	     */
+	    std::vector<double> const& getPositions() const;
+	    /**
+	     * @return All vertex normals, three consecutive values per normal
+	     */
+	    std::vector<double> const& getNormals() const;
+	    /**
+	     * @return Three vertex indices per triangle
+	     */
+	    std::vector<uint32_t> const& getTriangles() const;
+	    /**
+	     * @return Normal index of every triangle corner or NoNormal
+	     */
+	    std::vector<uint32_t> const& getTriangleNormals() const;
+	private:
+	    /**
+	     * @brief Default amount of characters handed to a thread at once
+	     */
+	    static const std::size_t ChunkSize = 1 << 18;
+
+	    /**
+	     * @brief Range of whole lines along with the amount of elements in it
+	     * @details After counting, the amounts are turned into the offsets of the first element
+	     * 		of the chunk in the output.
+	     */
+	    struct Chunk
+	    {
+		char const* begin;
+		char const* end;
+		unsigned int firstLine = 0;
+		std::size_t positions = 0;
+		std::size_t normals = 0;
+		std::size_t triangles = 0;
+	    };
+
+	    /**
+	     * @brief Counts lines, vertices, normals and triangles of a chunk
+	     * @param chunk Chunk to count, the amounts are overwritten
+	     */
+	    void countChunk(Chunk& chunk) const;
+	    /**
+	     * @brief Parses a chunk into the preallocated output
+	     * @param chunk Chunk with the offsets of its first elements
+	     * @exception Throws std::runtime_error in case the chunk is malformed
+	     */
+	    void parseChunk(Chunk const& chunk);
+	    /**
+	     * @brief Parses three coordinates
+	     * @param cur First character after the keyword
+	     * @param end End of the line
+	     * @param[out] pOut Destination of the coordinates
+	     * @param line Line number for error messages
+	     * @exception Throws std::runtime_error in case a coordinate is missing
+	     */
+	    void parseVector(char const* cur, char const* end, double* pOut, unsigned int line) const;
+	    /**
+	     * @brief Resolves a possibly negative, one-based index
+	     * @param index Index as found in the file
+	     * @param amount Amount of elements read so far
+	     * @param line Line number for error messages
+	     * @return Zero-based index
+	     * @exception Throws std::runtime_error in case the index is out of bounds
+	     */
+	    uint32_t resolveIndex(long index, std::size_t amount, unsigned int line) const;
+
+	    std::vector<double> m_positions;
+	    std::vector<double> m_normals;
+	    std::vector<uint32_t> m_triangles;
+	    std::vector<uint32_t> m_triangleNormals;
+    };
+}
+
+#endif /* OBJREADER_H_ */
@@ -0,0 +1,113 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Shape Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef PARALLEL_H_
+#define PARALLEL_H_
+
+#include <atomic>
+#include <mutex>
+#include <exception>
+#include <vector>
+#include <algorithm>
+#include "SFA/Utility/Scheduler.h"
+#include "SFA/Utility/Arena.h"
+
+namespace sfa
+{
+    /**
+     * @brief Non-owning reference to a function that takes an index
+     * @details Unlike std::function it never copies the referenced function, thus it doesn't allocate
+     * 		no matter how much the function captures. The function has to outlive the reference.
+     */
+    class IndexFunction
+    {
+	public:
+	    /**
+	     * @brief Constructor
+	     * @param function Function to refer to
+	     */
+	    template<typename Function> IndexFunction(Function const& function);
+	    /**
+	     * @brief Calls the referenced function
+	     * @param index Index to pass on
+	     */
+	    void operator()(unsigned int index) const;
+	private:
+	    template<typename Function> static void call(void const* pFunction, unsigned int index);
+
+	    void const* m_pFunction;
+	    void (*m_pCall)(void const*, unsigned int);
+    };
+
+    /**
+     * @brief Calls \p body for every index in [\p begin, \p end), distributed over several threads
+     * @details Runs on the default Scheduler, the calling thread takes part in the work. Indices are
+     * 		handed out one at a time, thus this is meant for a small amount of expensive work items.
+     * 		May be called from within \p body or other tasks. If \p body throws, the remaining
+     * 		indices are skipped and the first exception is rethrown after all threads have finished.
+     * 		Doesn't allocate once the scheduler's queues are large enough.
+     * @param begin First index
+     * @param end One past the last index
+     * @param body Function to call for every index
+     * @param threads Maximum amount of threads to use or 0 to use all threads of the scheduler
+     */
+    void parallelFor(unsigned int begin, unsigned int end, IndexFunction body, unsigned int threads = 0);
+    /**
+     * @brief Accumulates a value over all indices in [\p begin, \p end) using several threads
+     * @details The range is split into chunks of \p chunkSize indices. Each chunk is accumulated
+     * 		into its own copy of \p identity by calling \p body(partial, index) for all its indices
+     * 		in order. Afterwards the partial results are merged into \p identity by calling
+     * 		\p combine(result, partial) in chunk order, thus the result doesn't depend on the
+     * 		amount of threads.
+     * @param begin First index
+     * @param end One past the last index
+     * @param chunkSize Amount of indices per chunk
+     * @param identity Initial value of the result and of every partial result
+     * @param body Accumulates a single index into a partial result
+     * @param combine Merges a partial result into the result
+     * @param threads Maximum amount of threads to use or 0 to use all threads of the scheduler
+     * @return The accumulated value
+     */
+    template<typename T, typename Body, typename Combine> T parallelReduce(unsigned int begin, unsigned int end,
+	    unsigned int chunkSize, T const& identity, Body const& body, Combine const& combine,
+	    unsigned int threads = 0);
+    /**
+     * @brief Accumulates a value over all indices in [\p begin, \p end) using several threads
+     * @details Same as above, but the partial results are stored in \p arena instead of the heap.
+     * @param begin First index
+     * @param end One past the last index
+     * @param chunkSize Amount of indices per chunk
+     * @param identity Initial value of the result and of every partial result
+     * @param body Accumulates a single index into a partial result
+     * @param combine Merges a partial result into the result
+     * @param arena Arena to allocate the partial results from
+     * @param threads Maximum amount of threads to use or 0 to use all threads of the scheduler
+     * @return The accumulated value
+     */
+    template<typename T, typename Body, typename Combine> T parallelReduce(unsigned int begin, unsigned int end,
+	    unsigned int chunkSize, T const& identity, Body const& body, Combine const& combine, Arena& arena,
+	    unsigned int threads = 0);
+    /**
+     * @brief Sorts the elements of a random access range using several threads
+     * @details Chunks of \p chunkSize elements are sorted independently, afterwards neighboring runs
+     * 		are merged pairwise until the whole range is sorted. Not stable.
+     * @param begin First element
+     * @param end One past the last element
+     * @param compare Strict weak ordering
+     * @param chunkSize Amount of elements sorted by a single thread at once
+     * @param threads Maximum amount of threads to use or 0 to use all threads of the scheduler
+     */
+    template<typename Iterator, typename Compare> void parallelSort(Iterator begin, Iterator end,
+	    Compare const& compare, unsigned int chunkSize = 1 << 14, unsigned int threads = 0);
+}
+
+#include "Parallel.imp"
+
+#endif /* PARALLEL_H_ */
@@ -0,0 +1,255 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Shape Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef SCHEDULER_H_
+#define SCHEDULER_H_
+
+#include <functional>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <stdexcept>
+#include <memory>
+#include <vector>
+#include <algorithm>
+
+namespace sfa
+{
+    class TaskGroup;
+
+    /**
+     * @brief Work-stealing thread pool shared by all parallel algorithms
+     * @details Every worker owns a queue. Tasks spawned by a worker go to its own queue and are
+     * 		processed last in, first out, idle workers steal the oldest tasks of other queues.
+     * 		Tasks spawned by other threads go to a shared queue. A thread that waits for tasks
+     * 		to finish keeps processing queued tasks in the meantime, thus tasks may spawn and
+     * 		wait for further tasks without blocking a worker.
+     */
+    class Scheduler
+    {
+	public:
+	    /**
+	     * @brief Constructor
+	     * @param threads Amount of threads that work on tasks, including the thread that waits for
+	     * 		      them. 0 to use one per hardware thread.
+	     */
+	    Scheduler(unsigned int threads = 0);
+	    Scheduler(Scheduler const& other) = delete;
+	    Scheduler& operator=(Scheduler const& other) = delete;
+	    /**
+	     * @brief Destructor, stops all workers
+	     * @details There may not be any unfinished tasks left.
+	     */
+	    ~Scheduler();
+	    /**
+	     * @return Amount of threads that work on tasks, including the waiting thread
+	     */
+	    unsigned int getThreads() const;
+	    /**
+	     * @brief Makes sure every queue can hold a certain amount of tasks without allocating
+	     * @details Queues grow on demand, but how many tasks are queued at once depends on timing.
+	     * 		Reserving the largest amount expected keeps queuing free of allocations.
+	     * @param tasks Amount of tasks every queue can hold afterwards
+	     */
+	    void reserve(unsigned int tasks);
+	    /**
+	     * @return The scheduler used by default, created on first use and kept until the program
+	     * 	       exits
+	     */
+	    static Scheduler& getDefault();
+	    /**
+	     * @brief Creates the default scheduler with a certain amount of threads
+	     * @param threads Amount of threads of the default scheduler, 0 for one per hardware thread
+	     * @exception Throws std::logic_error in case the default scheduler has already been created
+	     */
+	    static void setDefaultThreads(unsigned int threads);
+	private:
+	    friend class TaskGroup;
+	    struct Task
+	    {
+		public:
+		    std::function<void()> function;
+		    TaskGroup* pGroup = nullptr;
+	    };
+	    /**
+	     * @brief Double-ended queue of tasks stored in a ring buffer
+	     * @details The buffer only ever grows, thus queuing doesn't allocate once it is large
+	     * 		enough for the usual amount of tasks.
+	     */
+	    struct Queue
+	    {
+		public:
+		    /**
+		     * @brief Grows the buffer to hold at least \p capacity tasks
+		     * @param capacity Amount of tasks to hold
+		     */
+		    void reserve(unsigned int capacity);
+		    /**
+		     * @brief Appends a task to the back
+		     * @param task Task to append
+		     */
+		    void pushBack(Task task);
+		    /**
+		     * @brief Takes the newest task
+		     * @param[out] task Found task
+		     * @return True if there was a task, otherwise false
+		     */
+		    bool popBack(Task& task);
+		    /**
+		     * @brief Takes the oldest task
+		     * @param[out] task Found task
+		     * @return True if there was a task, otherwise false
+		     */
+		    bool popFront(Task& task);
+
+		    std::mutex mutex;
+		    std::vector<Task> tasks;
+		    unsigned int first = 0;
+		    unsigned int size = 0;
+	    };
+	    /**
+	     * @brief Queues a task
+	     * @param task Task to queue
+	     */
+	    void push(Task task);
+	    /**
+	     * @brief Runs one queued task if there is any
+	     * @return True if a task has been run, otherwise false
+	     */
+	    bool runOne();
+	    /**
+	     * @brief Takes a task from the own queue or steals one from another
+	     * @param[out] task Found task
+	     * @return True if a task has been found, otherwise false
+	     */
+	    bool pop(Task& task);
+	    /**
+	     * @brief Blocks until all tasks of \p group have finished or new tasks have been queued
+	     * @param group Group to wait for
+	     */
+	    void waitFor(TaskGroup const& group);
+	    /**
+	     * @brief Main loop of a worker thread
+	     * @param index Index of the worker's queue
+	     */
+	    void work(unsigned int index);
+	    /**
+	     * @return Index of the calling thread's queue, 0 (the shared queue) if it is not a worker
+	     */
+	    unsigned int getQueueIndex() const;
+
+	    /**
+	     * @brief Shared queue followed by one queue per worker
+	     */
+	    std::vector<std::unique_ptr<Queue>> m_queues;
+	    std::vector<std::thread> m_workers;
+	    std::atomic<unsigned int> m_queued;
+	    std::atomic<bool> m_stop;
+	    std::mutex m_sleepMutex;
+	    /**
+	     * @brief Notified whenever a task has been queued
+	     */
+	    std::condition_variable m_wakeUp;
+	    /**
+	     * @brief Notified whenever a group finishes or a task has been queued while threads wait
+	     * 	      for a group
+	     */
+	    std::condition_variable m_groupDone;
+	    /**
+	     * @brief Amount of threads blocked in waitFor(), guarded by m_sleepMutex
+	     */
+	    unsigned int m_waitingThreads = 0;
+	    static std::unique_ptr<Scheduler> s_pDefault;
+	    static std::once_flag s_defaultOnce;
+    };
+
+    /**
+     * @brief A set of tasks that can be waited for
+     */
+    class TaskGroup
+    {
+	public:
+	    /**
+	     * @brief Constructor
+	     * @param scheduler Scheduler to run the tasks on
+	     */
+	    TaskGroup(Scheduler& scheduler = Scheduler::getDefault());
+	    TaskGroup(TaskGroup const& other) = delete;
+	    TaskGroup& operator=(TaskGroup const& other) = delete;
+	    /**
+	     * @brief Destructor, waits for all tasks but drops their exceptions
+	     */
+	    ~TaskGroup();
+	    /**
+	     * @brief Queues a task
+	     * @param task Task to run
+	     */
+	    void run(std::function<void()> task);
+	    /**
+	     * @brief Processes queued tasks until all tasks of this group have finished
+	     * @details Blocks while there is nothing to process. If a task threw, the first exception
+	     * 		is rethrown.
+	     */
+	    void wait();
+	private:
+	    friend class Scheduler;
+	    /**
+	     * @brief Waits without rethrowing
+	     */
+	    void join();
+
+	    Scheduler& m_scheduler;
+	    std::atomic<unsigned int> m_pending;
+	    std::mutex m_errorMutex;
+	    std::exception_ptr m_error;
+    };
+
+    /**
+     * @brief Tasks with dependencies
+     * @details Tasks may only depend on tasks that have been added before, thus there can't be any
+     * 		cycles. Tasks whose dependencies are done run concurrently.
+     */
+    class TaskGraph
+    {
+	public:
+	    /**
+	     * @brief Adds a task
+	     * @param task Task to add
+	     * @param dependencies Tasks that have to be finished before \p task may run
+	     * @return Identifier of the added task
+	     */
+	    unsigned int add(std::function<void()> task,
+		    std::vector<unsigned int> const& dependencies = std::vector<unsigned int>());
+	    /**
+	     * @return Amount of tasks
+	     */
+	    unsigned int size() const;
+	    /**
+	     * @brief Runs all tasks and waits for them to finish
+	     * @details If a task throws, the tasks depending on it are skipped and the first exception is
+	     * 		rethrown after all other tasks have finished.
+	     * @param scheduler Scheduler to run the tasks on
+	     */
+	    void run(Scheduler& scheduler = Scheduler::getDefault());
+	private:
+	    struct Node
+	    {
+		public:
+		    std::function<void()> task;
+		    std::vector<unsigned int> successors;
+		    unsigned int dependencies = 0;
+	    };
+	    std::vector<Node> m_nodes;
+    };
+}
+
+#endif /* SCHEDULER_H_ */
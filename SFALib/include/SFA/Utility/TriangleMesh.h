@@ -0,0 +1,239 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Shape Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef TRIANGLEMESH_H_
+#define TRIANGLEMESH_H_
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include "SFA/Utility/AbstractMesh.h"
+#include "SFA/Utility/Parallel.h"
+#include "SFA/Utility/Boundary.h"
+#include "SFA/Utility/VertexWelder.h"
+#include "SFA/Utility/KdTree.h"
+#include "SFA/Utility/OBJReader.h"
+
+namespace sfa
+{
+    /**
+     * @brief Mesh implementation without any rendering dependencies
+     * @details Provides the same analysis as Model, i.e. vertices are welded, neighborhoods and
+     * 		boundary are computed from the faces, but keeps nothing but packed arrays. Thus it
+     * 		can be used for batch processing without an OpenGL context. Base vertices are the
+     * 		vertices as listed in the OBJ file.
+     */
+    class TriangleMesh final : public AbstractMesh
+    {
+	public:
+	    /**
+	     * @brief Copy of the state of a mesh that changes when its vertices are moved
+	     * @details See Model::Snapshot.
+	     */
+	    class Snapshot
+	    {
+		private:
+		    friend class TriangleMesh;
+
+		    std::vector<double> m_positions;
+		    std::vector<double> m_normals;
+		    std::shared_ptr<KdTree<3> const> m_vertexTree;
+		    Eigen::Matrix3d m_poseRotation;
+		    Eigen::Vector3d m_poseTranslation;
+		    std::mt19937 m_random;
+		    unsigned int m_generation = 0;
+		    unsigned int m_shapeGeneration = 0;
+	    };
+
+	    /**
+	     * @brief Loads a mesh from an OBJ file
+	     * @param path Path of the file
+	     * @exception Throws std::runtime_error in case the file can't be read
+	     */
+	    explicit TriangleMesh(std::string const& path);
+	    /**
+	     * @brief Constructs a mesh from previously read OBJ data
+	     * @param reader Reader holding the data
+	     */
+	    explicit TriangleMesh(OBJReader const& reader);
+	    /**
+	     * @brief Constructs a mesh from raw arrays
+	     * @details Normals are computed from the faces.
+	     * @param positions Coordinates of all vertices, three consecutive values per vertex
+	     * @param triangles Three vertex indices per triangle
+	     */
+	    TriangleMesh(std::vector<double> const& positions, std::vector<uint32_t> const& triangles);
+	    virtual unsigned int getID() const;
+	    virtual Vertex getVertex(unsigned int n) const;
+	    virtual Eigen::Vector3d getCoords(unsigned int n) const;
+	    virtual Eigen::Vector3d getNormal(unsigned int n) const;
+	    virtual bool isEdge(unsigned int n) const;
+	    virtual Eigen::Map<Eigen::Matrix3Xd const> getPositions() const;
+	    virtual Eigen::Map<Eigen::Matrix3Xd const> getNormals() const;
+	    virtual Adjacency const& getAdjacency() const;
+	    /**
+	     * @return Mapping from every vertex to the input vertices merged into it
+	     */
+	    Adjacency const& getBaseVertices() const;
+	    /**
+	     * @return Three vertex indices per triangle
+	     */
+	    std::vector<uint32_t> const& getTriangles() const;
+	    /**
+	     * @return All boundary loops of the mesh, each listing its vertices in order
+	     */
+	    std::vector<std::vector<uint32_t>> const& getBoundaryLoops() const;
+	    /**
+	     * @brief Finds the vertex closest to a point
+	     * @details Uses a tree over all vertices in the local frame of the mesh, see
+	     * 		Model::getVertexTree(). May be called from multiple threads at once.
+	     * @param point Point in the current coordinate frame of the mesh
+	     * @return Index of the closest vertex
+	     * @exception Throws std::out_of_range in case the mesh doesn't have any vertices
+	     */
+	    unsigned int findNearestVertex(Eigen::Vector3d const& point) const;
+	    /**
+	     * @brief Provides the rigid transformation applied since the vertex tree was built
+	     * @return Transformation from the local frame into the current coordinate frame
+	     */
+	    Eigen::Isometry3d getPose() const;
+	    /**
+	     * @brief Maps a point into the local frame of the mesh
+	     * @param coords Point in the current coordinate frame of the mesh
+	     * @return The point in the local frame, as used by the vertex tree
+	     */
+	    Eigen::Vector3d toLocalFrame(Eigen::Vector3d const& coords) const;
+	    virtual void setVertex(unsigned int n, Eigen::Vector3d const& coords, Eigen::Vector3d const& normal);
+	    /**
+	     * @brief Moves all vertices by a rigid transformation
+	     * @details Topology and vertex tree are kept, the transformation is only added to the pose.
+	     * @param R Rotation
+	     * @param t Translation
+	     */
+	    virtual void applyTransform(Eigen::Matrix3d const& R, Eigen::Vector3d const& t);
+	    /**
+	     * @brief Replaces the coordinates of all vertices at once
+	     * @details Normals are kept. The vertex tree is rebuilt.
+	     * @param positions New coordinates, column n holds the coordinates of vertex n
+	     * @exception Throws std::invalid_argument in case the amount of columns doesn't match the
+	     * 		  amount of vertices
+	     */
+	    virtual void setPositions(Eigen::Ref<Eigen::Matrix3Xd const> const& positions);
+	    virtual unsigned int getAmountOfVertices() const;
+	    Eigen::Vector3d getAverage() const;
+	    virtual unsigned int getGeneration() const;
+	    virtual unsigned int getShapeGeneration() const;
+	    void addNoise();
+	    void addHole();
+	    /**
+	     * @brief Removes several regions of the mesh at once
+	     * @details See Model::addHoles().
+	     * @param amount Amount of holes
+	     * @param radius Amount of neighborhood rings to remove around each center
+	     */
+	    void addHoles(unsigned int amount, unsigned int radius = 0);
+	    double rotateRandom(double maxAngle, double minAngle = 0);
+	    double translateRandom(double maxTranslation, double minTranslation = 0);
+	    /**
+	     * @brief Stores coordinates and normals of all vertices
+	     * @param snapshot Snapshot to overwrite
+	     */
+	    void saveSnapshot(Snapshot& snapshot) const;
+	    /**
+	     * @brief Resets coordinates and normals of all vertices to a previously saved state
+	     * @details See Model::restoreSnapshot().
+	     * @param snapshot Snapshot to restore
+	     * @exception Throws std::invalid_argument in case the snapshot doesn't fit the topology
+	     */
+	    void restoreSnapshot(Snapshot const& snapshot);
+	private:
+	    /**
+	     * @brief Everything derived from the faces, never modified once built
+	     */
+	    struct Topology
+	    {
+		/**
+		 * @brief Vertex of every input vertex or Removed
+		 */
+		std::vector<uint32_t> baseIndex2MeshIndex;
+		std::vector<uint32_t> triangles;
+		Adjacency neighbors;
+		Adjacency baseVertices;
+		Boundary boundary;
+	    };
+
+	    /**
+	     * @brief Marks input vertices that don't belong to any vertex anymore
+	     */
+	    static const uint32_t Removed = std::numeric_limits<uint32_t>::max();
+
+	    /**
+	     * @brief Welds the input vertices and computes normals and topology
+	     * @details Vertices that aren't used by any face are dropped.
+	     * @param positions Coordinates of all input vertices, three consecutive values per vertex
+	     * @param normals Normals referenced by \p triangleNormals, three consecutive values per normal
+	     * @param triangles Three input vertex indices per triangle
+	     * @param triangleNormals Normal index of every triangle corner, OBJReader::NoNormal to use
+	     * 	      the normal of the face. May be empty in case no corner has a normal.
+	     */
+	    void analyzeMesh(std::vector<double> const& positions, std::vector<double> const& normals,
+		    std::vector<uint32_t> const& triangles, std::vector<uint32_t> const& triangleNormals);
+	    /**
+	     * @brief Removes vertices along with all faces using them
+	     * @details Indices are compacted, the remaining vertices keep their order.
+	     * @param removed Non-zero for every vertex to remove
+	     */
+	    void removeVertices(std::vector<char> const& removed);
+	    /**
+	     * @brief Makes sure vertex \p n exists
+	     * @param n Number of the vertex
+	     * @exception Throws std::out_of_range in case n is out of bounds
+	     */
+	    void checkBounds(unsigned int n) const;
+	    /**
+	     * @brief Inserts all vertices into a new vertex tree
+	     */
+	    void rebuildVertexTree();
+
+	    /**
+	     * @brief Coordinates of all vertices, three consecutive values per vertex
+	     */
+	    std::vector<double> m_positions;
+	    /**
+	     * @brief Normals of all vertices, three consecutive values per vertex
+	     */
+	    std::vector<double> m_normals;
+	    std::shared_ptr<Topology const> m_topology;
+	    /**
+	     * @brief Tree of all vertices, shared between copies until one of them rebuilds it
+	     */
+	    std::shared_ptr<KdTree<3> const> m_vertexTree;
+	    /**
+	     * @brief Rotation from the local frame into the current coordinate frame
+	     */
+	    Eigen::Matrix3d m_poseRotation = Eigen::Matrix3d::Identity();
+	    /**
+	     * @brief Translation from the local frame into the current coordinate frame
+	     */
+	    Eigen::Vector3d m_poseTranslation = Eigen::Vector3d::Zero();
+	    std::mt19937 m_random;
+	    unsigned int m_generation = 0;
+	    unsigned int m_shapeGeneration = 0;
+    };
+}
+
+#endif /* TRIANGLEMESH_H_ */
@@ -12,12 +12,14 @@
 #define VERTEX_H_
 
 #include <Eigen/Core>
-#include <set>
+#include "SFA/Utility/Adjacency.h"
 
 namespace sfa
 {
     /**
      * @brief Contains all the data of a vertex needed for nearest neighbor search and icp
+     * @details Neighbors and base vertices refer to the storage of the mesh the vertex was taken
+     * 		from, thus they are only valid as long as the mesh isn't modified or destroyed.
      */
     struct Vertex
     {
@@ -35,17 +37,17 @@ namespace sfa
 	     */
 	    Eigen::Vector3d normal;
 	    /**
-	     * @brief Indices of all neighboring vertices
+	     * @brief Indices of all neighboring vertices in increasing order
 	     */
-	    std::set<unsigned int> neighbors;
+	    Adjacency::Range neighbors;
 	    /**
 	     * @brief Indices of all vertices that represent this vertex internally
 	     * @details For visualization vertices might need to be copied. E.g. in OpenGL
 	     * 		hard edges can only be displayed by copying the edge vertices. Thus
 	     * 		one "high-level" vertex (that is one used point) might have multiple
-	     * 		copies internally. This set is intended to abstract away those copies.
+	     * 		copies internally. This range is intended to abstract away those copies.
 	     */
-	    std::set<unsigned int> baseVertices;
+	    Adjacency::Range baseVertices;
 	    /**
 	     * @brief Indicates if the vertex is located on the edge of the mesh
 	     */
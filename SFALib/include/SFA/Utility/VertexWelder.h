@@ -0,0 +1,68 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Shape Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef VERTEXWELDER_H_
+#define VERTEXWELDER_H_
+
+#include <vector>
+#include <array>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include "SFA/Utility/Parallel.h"
+
+namespace sfa
+{
+    /**
+     * @brief Merges vertices that are closer to each other than a tolerance
+     * @details Vertices are quantised to a grid with a cell size equal to the tolerance and sorted
+     * 		by cell in parallel. Any vertex within the tolerance lies in the same or one of the 26
+     * 		surrounding cells, thus every vertex only compares against a few candidates.
+     */
+    class VertexWelder
+    {
+	public:
+	    /**
+	     * @brief Welds a set of vertices
+	     * @details Every vertex is merged into the vertex with the lowest index within \p tolerance.
+	     * 		Welded vertices are numbered in order of their first occurrence.
+	     * @param positions Coordinates of all vertices, three consecutive values per vertex
+	     * @param tolerance Maximum distance of vertices to merge, has to be positive
+	     * @param threads Maximum amount of threads to use or 0 to use one per hardware thread
+	     * @exception Throws std::invalid_argument in case \p tolerance isn't positive
+	     */
+	    void weld(std::vector<double> const& positions, double tolerance, unsigned int threads = 0);
+	    /**
+	     * @return Amount of vertices after welding
+	     */
+	    unsigned int getAmountOfVertices() const;
+	    /**
+	     * @return Index of the welded vertex for every input vertex
+	     */
+	    std::vector<uint32_t> const& getMapping() const;
+	    /**
+	     * @return Index of the first input vertex of every welded vertex
+	     */
+	    std::vector<uint32_t> const& getRepresentatives() const;
+	private:
+	    using Cell = std::array<int64_t, 3>;
+
+	    /**
+	     * @brief Amount of vertices handed to a thread at once
+	     */
+	    static const unsigned int ChunkSize = 4096;
+
+	    std::vector<uint32_t> m_mapping;
+	    std::vector<uint32_t> m_representatives;
+    };
+}
+
+#endif /* VERTEXWELDER_H_ */
@@ -0,0 +1,375 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Face Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include "SFA/ICP/BranchAndBoundICP.h"
+
+namespace sfa
+{
+    namespace
+    {
+	// M_PI isn't portable
+	const double Pi = std::acos(-1.0);
+    }
+
+    BranchAndBoundICP::BranchAndBoundICP(AbstractLog* pLog) : ICP(pLog)
+    {
+    }
+
+    BranchAndBoundICP::~BranchAndBoundICP()
+    {
+    }
+
+    unsigned int BranchAndBoundICP::calcNextStep(AbstractMesh& source, AbstractMesh const& dest)
+    {
+	// Global alignment only has to be done once
+	if(m_aligned)
+	    return 0;
+
+	Eigen::Isometry3d pose = findPose(source, dest);
+	source.applyTransform(pose.linear(), pose.translation());
+	m_aligned = true;
+
+	return std::min(m_samples, source.getAmountOfVertices());
+    }
+
+    Eigen::Isometry3d BranchAndBoundICP::findPose(AbstractMesh const& source, AbstractMesh const& dest)
+    {
+	updateDistanceField(dest);
+	m_evaluatedCubes = 0;
+	m_gap = 0;
+	auto const& indices = selectIndices(source);
+	unsigned int amount = std::min<unsigned int>(m_samples, indices.size());
+	if(amount == 0 || m_distanceField.points.cols() == 0)
+	    return Eigen::Isometry3d::Identity();
+
+	// Evenly spread subsample of the selection, centered at its mean and scaled like dest
+	Eigen::Matrix3Xd P(3, amount);
+	for (unsigned int i = 0; i < amount; i++)
+	    P.col(i) = source.getCoords(indices[static_cast<uint64_t>(i) * indices.size() / amount]);
+	Eigen::Vector3d sourceCenter = P.rowwise().mean();
+	P = (P.colwise() - sourceCenter) / m_distanceField.scale;
+	Eigen::VectorXd norms = P.colwise().norm().transpose();
+	double epsilon = m_threshold * amount;
+	double cellRadius = getCellRadius();
+
+	// Start out with the local optimum of aligned centers
+	Eigen::Matrix3d bestR = Eigen::Matrix3d::Identity();
+	Eigen::Vector3d bestT = Eigen::Vector3d::Zero();
+	double bestError = refine(P, bestR, bestT);
+
+	// Lowest bound of all cubes that have been dropped or aren't split any further
+	double lowestDropped = std::numeric_limits<double>::infinity();
+	std::priority_queue<Cube> cubes;
+	cubes.push({Eigen::Vector3d::Zero(), Pi, 0});
+	while(!cubes.empty())
+	{
+	    Cube cube = cubes.top();
+	    if(cube.lowerBound >= bestError - epsilon)
+		break;
+	    if(m_maxCubes > 0 && m_evaluatedCubes >= m_maxCubes)
+	    {
+		if (m_pLog != nullptr)
+		    m_pLog->warning("Stopped after %u rotation cubes.", m_evaluatedCubes);
+		break;
+	    }
+	    cubes.pop();
+
+	    // Bound all children in parallel
+	    struct Child
+	    {
+		public:
+		    Cube cube;
+		    bool valid;
+		    bool leaf;
+		    double estimate;
+		    Eigen::Vector3d translation;
+	    } children[8];
+	    double halfSide = cube.halfSide / 2;
+	    double currentBest = bestError;
+	    parallelFor(0, 8, [&](unsigned int j)
+	    {
+		Child& child = children[j];
+		child.cube.center = cube.center + halfSide * Eigen::Vector3d((j & 1) ? 1 : -1, (j & 2) ? 1 : -1, (j & 4) ? 1 : -1);
+		child.cube.halfSide = halfSide;
+		// Cubes completely outside of the ball of radius pi don't contain any new rotations
+		child.valid = child.cube.center.norm() - std::sqrt(3.0) * halfSide <= Pi;
+		if(!child.valid)
+		    return;
+		Eigen::Matrix3Xd X = toRotation(child.cube.center) * P;
+		child.translation = Eigen::Vector3d::Zero();
+		double unusedBound;
+		child.estimate = searchTranslation(X, Eigen::VectorXd::Zero(amount), currentBest, child.translation,
+			unusedBound);
+		double maxAngle = std::sqrt(3.0) * halfSide;
+		Eigen::VectorXd gammaR = 2 * std::sin(std::min(maxAngle / 2, Pi / 2)) * norms;
+		Eigen::Vector3d unusedTranslation;
+		searchTranslation(X, gammaR, currentBest, unusedTranslation, child.cube.lowerBound);
+		// Rotations finer than the distance transform can't tighten the bounds
+		child.leaf = gammaR.maxCoeff() < cellRadius;
+	    });
+	    m_evaluatedCubes += 8;
+
+	    for (auto& child : children)
+	    {
+		if(!child.valid)
+		    continue;
+		// Possibly better solution found, let ICP tighten it and measure its exact error
+		if(child.estimate < bestError)
+		{
+		    Eigen::Matrix3d R = toRotation(child.cube.center);
+		    Eigen::Vector3d t = child.translation;
+		    double error = refine(P, R, t);
+		    if(error < bestError)
+		    {
+			bestR = R;
+			bestT = t;
+			bestError = error;
+		    }
+		}
+		if(child.cube.lowerBound < bestError - epsilon && !child.leaf)
+		    cubes.push(child.cube);
+		else
+		    lowestDropped = std::min(lowestDropped, child.cube.lowerBound);
+	    }
+	}
+	if(!cubes.empty())
+	    lowestDropped = std::min(lowestDropped, cubes.top().lowerBound);
+	m_gap = std::max(bestError - lowestDropped, 0.0) / amount;
+	if (m_pLog != nullptr)
+	    m_pLog->info("Evaluated %u rotation cubes, mean squared error %f, gap %f.", m_evaluatedCubes,
+		    bestError / amount, m_gap);
+
+	// Undo normalization
+	Eigen::Isometry3d pose = Eigen::Isometry3d::Identity();
+	pose.linear() = bestR;
+	pose.translation() = m_distanceField.scale * bestT + m_distanceField.center - bestR * sourceCenter;
+	return pose;
+    }
+
+    void BranchAndBoundICP::reset()
+    {
+	m_aligned = false;
+    }
+
+    unsigned int BranchAndBoundICP::getSamples() const
+    {
+	return m_samples;
+    }
+
+    void BranchAndBoundICP::setSamples(unsigned int samples)
+    {
+	m_samples = samples;
+    }
+
+    double BranchAndBoundICP::getThreshold() const
+    {
+	return m_threshold;
+    }
+
+    void BranchAndBoundICP::setThreshold(double threshold)
+    {
+	m_threshold = threshold;
+    }
+
+    unsigned int BranchAndBoundICP::getResolution() const
+    {
+	return m_resolution;
+    }
+
+    void BranchAndBoundICP::setResolution(unsigned int resolution)
+    {
+	m_resolution = std::max(resolution, 2u);
+    }
+
+    unsigned int BranchAndBoundICP::getEvaluatedCubes() const
+    {
+	return m_evaluatedCubes;
+    }
+
+    unsigned int BranchAndBoundICP::getMaxCubes() const
+    {
+	return m_maxCubes;
+    }
+
+    void BranchAndBoundICP::setMaxCubes(unsigned int cubes)
+    {
+	m_maxCubes = cubes;
+    }
+
+    double BranchAndBoundICP::getGap() const
+    {
+	return m_gap;
+    }
+
+    bool BranchAndBoundICP::Cube::operator<(Cube const& other) const
+    {
+	return lowerBound > other.lowerBound;
+    }
+
+    void BranchAndBoundICP::updateDistanceField(AbstractMesh const& dest)
+    {
+	auto& field = m_distanceField;
+	if(field.generation == dest.getGeneration() && field.amountOfVertices == dest.getAmountOfVertices()
+		&& field.resolution == m_resolution)
+	    return;
+	field.generation = dest.getGeneration();
+	field.amountOfVertices = dest.getAmountOfVertices();
+	field.resolution = m_resolution;
+	field.points = dest.getPositions();
+	field.distances.clear();
+	if(dest.getAmountOfVertices() == 0)
+	    return;
+
+	// Normalize dest to [-1,1]^3
+	Eigen::Vector3d min = field.points.rowwise().minCoeff();
+	Eigen::Vector3d max = field.points.rowwise().maxCoeff();
+	field.center = (min + max) / 2;
+	field.scale = std::max((max - min).maxCoeff() / 2, 1e-12);
+	field.points = (field.points.colwise() - field.center) / field.scale;
+	field.tree.build(field.points);
+
+	// Sample distances at cell centers of a grid covering [-2,2]^3
+	unsigned int res = m_resolution;
+	double cellSize = 4.0 / res;
+	field.distances.resize(res * res * res);
+	parallelFor(0, res, [&](unsigned int z)
+	{
+	    for (unsigned int y = 0; y < res; y++)
+	    {
+		for (unsigned int x = 0; x < res; x++)
+		{
+		    Eigen::Vector3d p(x + 0.5, y + 0.5, z + 0.5);
+		    p = p * cellSize - Eigen::Vector3d::Constant(2);
+		    double sqDist = 0;
+		    field.tree.findNearest(p, &sqDist);
+		    field.distances[(z * res + y) * res + x] = std::sqrt(sqDist);
+		}
+	    }
+	});
+	if (m_pLog != nullptr)
+	    m_pLog->info("Computed distance transform with %u cells.", static_cast<unsigned int>(field.distances.size()));
+    }
+
+    double BranchAndBoundICP::sampleDistance(Eigen::Vector3d const& x, double& lower) const
+    {
+	auto const& field = m_distanceField;
+	unsigned int res = field.resolution;
+	// Closest cell, points outside of the grid use the one at its border
+	Eigen::Vector3d clamped = x.cwiseMax(-2).cwiseMin(2);
+	Eigen::Vector3d cell = (clamped + Eigen::Vector3d::Constant(2)) * (res / 4.0);
+	unsigned int ix = std::min<unsigned int>(cell.x(), res - 1);
+	unsigned int iy = std::min<unsigned int>(cell.y(), res - 1);
+	unsigned int iz = std::min<unsigned int>(cell.z(), res - 1);
+	Eigen::Vector3d center(ix + 0.5, iy + 0.5, iz + 0.5);
+	center = center * (4.0 / res) - Eigen::Vector3d::Constant(2);
+	// Distances are 1-Lipschitz, so they fall short of the sample by at most the offset
+	double sample = field.distances[(iz * res + iy) * res + ix];
+	lower = std::max(sample - (x - center).norm(), 0.0);
+	return sample;
+    }
+
+    double BranchAndBoundICP::computeError(Eigen::Matrix3Xd const& X) const
+    {
+	double error = 0;
+	for (unsigned int i = 0; i < X.cols(); i++)
+	{
+	    double sqDist = 0;
+	    m_distanceField.tree.findNearest(X.col(i), &sqDist);
+	    error += sqDist;
+	}
+	return error;
+    }
+
+    double BranchAndBoundICP::searchTranslation(Eigen::Matrix3Xd const& X, Eigen::VectorXd const& gammaR,
+	    double bestError, Eigen::Vector3d& translation, double& lowerBound) const
+    {
+	double epsilon = m_threshold * X.cols();
+	double cellRadius = getCellRadius();
+	// Estimates only guide the search. Every translation lies in a cube that is dropped, not
+	// split any further or still queued, thus the lowest bound of those is a strict one.
+	lowerBound = std::numeric_limits<double>::infinity();
+	std::priority_queue<Cube> cubes;
+	// Source center may be anywhere within the bounding box of dest
+	cubes.push({Eigen::Vector3d::Zero(), 1, 0});
+	while(!cubes.empty())
+	{
+	    Cube cube = cubes.top();
+	    if(cube.lowerBound >= bestError - epsilon)
+		break;
+	    cubes.pop();
+	    double halfSide = cube.halfSide / 2;
+	    double gammaT = std::sqrt(3.0) * halfSide;
+	    for (unsigned int j = 0; j < 8; j++)
+	    {
+		Eigen::Vector3d center = cube.center + halfSide * Eigen::Vector3d((j & 1) ? 1 : -1, (j & 2) ? 1 : -1, (j & 4) ? 1 : -1);
+		double estimate = 0;
+		double lower = 0;
+		for (unsigned int i = 0; i < X.cols(); i++)
+		{
+		    double lowerDist;
+		    double d = sampleDistance(X.col(i) + center, lowerDist);
+		    double e = std::max(d - gammaR[i], 0.0);
+		    double l = std::max(lowerDist - gammaR[i] - gammaT, 0.0);
+		    estimate += e * e;
+		    lower += l * l;
+		}
+		if(estimate < bestError)
+		{
+		    bestError = estimate;
+		    translation = center;
+		}
+		if(lower < bestError - epsilon && gammaT >= cellRadius)
+		    cubes.push({center, halfSide, lower});
+		else
+		    lowerBound = std::min(lowerBound, lower);
+	    }
+	}
+	if(!cubes.empty())
+	    lowerBound = std::min(lowerBound, cubes.top().lowerBound);
+	return bestError;
+    }
+
+    double BranchAndBoundICP::getCellRadius() const
+    {
+	return std::sqrt(3.0) / 2 * 4.0 / m_distanceField.resolution;
+    }
+
+    double BranchAndBoundICP::refine(Eigen::Matrix3Xd const& P, Eigen::Matrix3d& R, Eigen::Vector3d& t) const
+    {
+	auto const& field = m_distanceField;
+	Eigen::Matrix3Xd Y(3, P.cols());
+	for (unsigned int iteration = 0; iteration < m_refineIterations; iteration++)
+	{
+	    Eigen::Matrix3Xd X = (R * P).colwise() + t;
+	    for (unsigned int i = 0; i < X.cols(); i++)
+		Y.col(i) = field.points.col(field.tree.findNearest(X.col(i)));
+	    Eigen::Vector3d xMean = X.rowwise().mean();
+	    Eigen::Vector3d yMean = Y.rowwise().mean();
+	    Eigen::Matrix3d H = (X.colwise() - xMean) * (Y.colwise() - yMean).transpose();
+	    Eigen::JacobiSVD<Eigen::Matrix3d> svd(H, Eigen::ComputeFullU | Eigen::ComputeFullV);
+	    Eigen::Matrix3d D = Eigen::Matrix3d::Identity();
+	    D(2, 2) = (svd.matrixV() * svd.matrixU().transpose()).determinant();
+	    Eigen::Matrix3d dR = svd.matrixV() * D * svd.matrixU().transpose();
+	    R = dR * R;
+	    t = dR * t + yMean - dR * xMean;
+	    if((dR - Eigen::Matrix3d::Identity()).norm() < 1e-9 && (yMean - xMean).norm() < 1e-9)
+		break;
+	}
+	return computeError((R * P).colwise() + t);
+    }
+
+    Eigen::Matrix3d BranchAndBoundICP::toRotation(Eigen::Vector3d const& r)
+    {
+	double angle = r.norm();
+	if(angle <= 0)
+	    return Eigen::Matrix3d::Identity();
+	return Eigen::AngleAxisd(angle, r / angle).toRotationMatrix();
+    }
+}
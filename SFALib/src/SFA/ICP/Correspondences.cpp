@@ -0,0 +1,32 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Face Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include "SFA/ICP/Correspondences.h"
+
+namespace sfa
+{
+    unsigned int Correspondences::size() const
+    {
+	return source.size();
+    }
+
+    void Correspondences::resize(unsigned int size)
+    {
+	source.resize(size, 0);
+	dest.resize(size, 0);
+	distance.resize(size, 0);
+	weight.resize(size, 1);
+    }
+
+    void Correspondences::clear()
+    {
+	resize(0);
+    }
+}
@@ -0,0 +1,284 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Face Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include "SFA/ICP/FPFH_ICP.h"
+
+namespace sfa
+{
+    FPFH_ICP::FPFH_ICP(AbstractLog* pLog) : ICP(pLog)
+    {
+    }
+
+    FPFH_ICP::~FPFH_ICP()
+    {
+    }
+
+    unsigned int FPFH_ICP::calcNextStep(AbstractMesh& source, AbstractMesh const& dest)
+    {
+	// Global alignment only has to be done once
+	if(m_aligned)
+	    return 0;
+
+	unsigned int inliers = 0;
+	Eigen::Isometry3d pose = findPose(source, dest, &inliers);
+	source.applyTransform(pose.linear(), pose.translation());
+	m_aligned = true;
+
+	return inliers;
+    }
+
+    Eigen::Isometry3d FPFH_ICP::findPose(AbstractMesh const& source, AbstractMesh const& dest, unsigned int* pInliers)
+    {
+	// Both meshes are independent of each other
+	bool updated[2] = {false, false};
+	TaskGroup group;
+	group.run([&]()
+	{
+	    updated[0] = updateFeatures(source, m_sourceFeatures, false);
+	});
+	updated[1] = updateFeatures(dest, m_destFeatures, true);
+	group.wait();
+	if (m_pLog != nullptr && (updated[0] || updated[1]))
+	    m_pLog->info("Computed %u feature histograms.",
+		    (updated[0] ? m_sourceFeatures.amountOfVertices : 0) + (updated[1] ? m_destFeatures.amountOfVertices : 0));
+	if(pInliers != nullptr)
+	    *pInliers = 0;
+
+	// Match the selected source vertices with the most similar destination vertices
+	auto const& indices = selectIndices(source);
+	unsigned int amount = indices.size();
+	if(amount < 3 || m_destFeatures.tree.size() == 0)
+	    return Eigen::Isometry3d::Identity();
+	Eigen::Matrix3Xd X(3, amount);
+	Eigen::Matrix3Xd Y(3, amount);
+	for (unsigned int i = 0; i < amount; i++)
+	{
+	    X.col(i) = source.getCoords(indices[i]);
+	    Y.col(i) = dest.getCoords(m_destFeatures.tree.findNearest(m_sourceFeatures.features.col(indices[i])));
+	}
+	double inlierDistance = m_inlierDistance > 0 ? m_inlierDistance : 2 * m_destFeatures.averageEdgeLength;
+	double sqInlierDistance = inlierDistance * inlierDistance;
+
+	// Matches are verified in random order, thus the first ones form a random subsample
+	std::vector<unsigned int> order(amount);
+	for (unsigned int i = 0; i < amount; i++)
+	    order[i] = i;
+	std::shuffle(order.begin(), order.end(), m_random);
+
+	std::uniform_int_distribution<unsigned int> rand_match(0, amount - 1);
+	Eigen::Isometry3d bestPose = Eigen::Isometry3d::Identity();
+	unsigned int bestInliers = 0;
+	Eigen::Matrix3Xd sampleX(3, 3);
+	Eigen::Matrix3Xd sampleY(3, 3);
+	for (unsigned int iteration = 0; iteration < m_iterations; iteration++)
+	{
+	    unsigned int a = rand_match(m_random), b = rand_match(m_random), c = rand_match(m_random);
+	    if(a == b || b == c || a == c)
+		continue;
+	    sampleX << X.col(a), X.col(b), X.col(c);
+	    sampleY << Y.col(a), Y.col(b), Y.col(c);
+	    // Rigid transformations preserve distances, reject samples whose edges don't match
+	    bool consistent = true;
+	    for (unsigned int j = 0; j < 3 && consistent; j++)
+	    {
+		double lengthX = (sampleX.col(j) - sampleX.col((j + 1) % 3)).norm();
+		double lengthY = (sampleY.col(j) - sampleY.col((j + 1) % 3)).norm();
+		consistent = std::min(lengthX, lengthY) > 0.9 * std::max(lengthX, lengthY) && lengthX > inlierDistance;
+	    }
+	    if(!consistent)
+		continue;
+	    Eigen::Isometry3d pose = estimatePose(sampleX, sampleY);
+
+	    // Count inliers, but stop as soon as the hypothesis can't win anymore or performs
+	    // badly on the subsample
+	    unsigned int inliers = 0;
+	    for (unsigned int j = 0; j < amount; j++)
+	    {
+		if(inliers + (amount - j) <= bestInliers)
+		    break;
+		if(j == m_verificationSamples && inliers * amount < bestInliers * m_verificationSamples / 2)
+		    break;
+		unsigned int k = order[j];
+		if((pose * X.col(k) - Y.col(k)).squaredNorm() < sqInlierDistance)
+		    inliers++;
+	    }
+	    if(inliers > bestInliers)
+	    {
+		bestInliers = inliers;
+		bestPose = pose;
+	    }
+	}
+	if(bestInliers < 3)
+	    return Eigen::Isometry3d::Identity();
+
+	// Refine using all inliers of the best hypothesis
+	Eigen::Matrix3Xd inlierX(3, bestInliers);
+	Eigen::Matrix3Xd inlierY(3, bestInliers);
+	unsigned int inliers = 0;
+	for (unsigned int i = 0; i < amount && inliers < bestInliers; i++)
+	{
+	    if((bestPose * X.col(i) - Y.col(i)).squaredNorm() < sqInlierDistance)
+	    {
+		inlierX.col(inliers) = X.col(i);
+		inlierY.col(inliers) = Y.col(i);
+		inliers++;
+	    }
+	}
+	if (m_pLog != nullptr)
+	    m_pLog->info("Found %u inliers among %u feature matches.", inliers, amount);
+	if(pInliers != nullptr)
+	    *pInliers = inliers;
+	return estimatePose(inlierX.leftCols(inliers), inlierY.leftCols(inliers));
+    }
+
+    double FPFH_ICP::computeFeatures(AbstractMesh const& mesh, Features& features) const
+    {
+	unsigned int amount = mesh.getAmountOfVertices();
+	features.setZero(3 * Bins, amount);
+	if(amount == 0)
+	    return 0;
+
+	// Copy positions and normals once
+	Eigen::Matrix3Xd coords = mesh.getPositions();
+	Eigen::Matrix3Xd normals = mesh.getNormals();
+	for (unsigned int i = 0; i < amount; i++)
+	    normals.col(i).normalize();
+	Adjacency const& adjacency = mesh.getAdjacency();
+	// Extend to two-rings, fall back to nearest neighbors where the mesh doesn't help
+	std::vector<std::vector<unsigned int>> neighborhoods(amount);
+	std::atomic<bool> sparse(false);
+	unsigned int chunks = (amount + m_chunkSize - 1) / m_chunkSize;
+	parallelFor(0, chunks, [&](unsigned int chunk)
+	{
+	    for (unsigned int i = chunk * m_chunkSize; i < std::min(amount, (chunk + 1) * m_chunkSize); i++)
+	    {
+		adjacency.getRing(i, 2, neighborhoods[i]);
+		if(neighborhoods[i].size() < 3)
+		    sparse = true;
+	    }
+	});
+	KdTree<3> tree;
+	if(sparse)
+	    tree.build(coords);
+	double edgeLength = 0;
+	unsigned int edges = 0;
+	for (unsigned int i = 0; i < amount; i++)
+	{
+	    for (auto neighbor : adjacency.getNeighbors(i))
+		edgeLength += (coords.col(i) - coords.col(neighbor)).norm();
+	    edges += adjacency.getDegree(i);
+	}
+
+	// Simplified histograms of the angles between each vertex and its neighbors
+	auto normalize = [](Features::ColXpr histogram)
+	{
+	    for (unsigned int f = 0; f < 3; f++)
+	    {
+		double sum = histogram.segment<Bins>(f * Bins).sum();
+		if(sum > 0)
+		    histogram.segment<Bins>(f * Bins) *= 100 / sum;
+	    }
+	};
+	const double Pi = std::acos(-1.0);
+	auto bin = [](double value, double min, double max)
+	{
+	    int index = static_cast<int>((value - min) / (max - min) * Bins);
+	    return static_cast<unsigned int>(std::max(0, std::min<int>(index, Bins - 1)));
+	};
+	Features spfh(3 * Bins, amount);
+	spfh.setZero();
+	parallelFor(0, chunks, [&](unsigned int chunk)
+	{
+	    for (unsigned int i = chunk * m_chunkSize; i < std::min(amount, (chunk + 1) * m_chunkSize); i++)
+	    {
+		auto& neighborhood = neighborhoods[i];
+		if(neighborhood.size() < 3)
+		{
+		    tree.findKNearest(coords.col(i), m_nearestNeighbors + 1, neighborhood);
+		    neighborhood.erase(std::remove(neighborhood.begin(), neighborhood.end(), i), neighborhood.end());
+		}
+		Eigen::Vector3d u = normals.col(i);
+		for (auto neighbor : neighborhood)
+		{
+		    Eigen::Vector3d d = coords.col(neighbor) - coords.col(i);
+		    double distance = d.norm();
+		    Eigen::Vector3d v = u.cross(d);
+		    if(distance <= 0 || v.norm() <= 0)
+			continue;
+		    d /= distance;
+		    v.normalize();
+		    Eigen::Vector3d w = u.cross(v);
+		    Eigen::Vector3d n = normals.col(neighbor);
+		    spfh(bin(v.dot(n), -1, 1), i)++;
+		    spfh(Bins + bin(u.dot(d), -1, 1), i)++;
+		    spfh(2 * Bins + bin(std::atan2(w.dot(n), u.dot(n)), -Pi, Pi), i)++;
+		}
+		normalize(spfh.col(i));
+	    }
+	});
+	// Add the weighted histograms of the neighbors
+	parallelFor(0, chunks, [&](unsigned int chunk)
+	{
+	    for (unsigned int i = chunk * m_chunkSize; i < std::min(amount, (chunk + 1) * m_chunkSize); i++)
+	    {
+		features.col(i) = spfh.col(i);
+		if(neighborhoods[i].empty())
+		    continue;
+		for (auto neighbor : neighborhoods[i])
+		{
+		    double distance = (coords.col(neighbor) - coords.col(i)).norm();
+		    if(distance > 0)
+			features.col(i) += spfh.col(neighbor) / (distance * neighborhoods[i].size());
+		}
+		normalize(features.col(i));
+	    }
+	});
+
+	return edges > 0 ? edgeLength / edges : 0;
+    }
+
+    void FPFH_ICP::reset()
+    {
+	m_aligned = false;
+    }
+
+    unsigned int FPFH_ICP::getIterations() const
+    {
+	return m_iterations;
+    }
+
+    void FPFH_ICP::setIterations(unsigned int iterations)
+    {
+	m_iterations = iterations;
+    }
+
+    double FPFH_ICP::getInlierDistance() const
+    {
+	return m_inlierDistance;
+    }
+
+    void FPFH_ICP::setInlierDistance(double distance)
+    {
+	m_inlierDistance = distance;
+    }
+
+    bool FPFH_ICP::updateFeatures(AbstractMesh const& mesh, FeatureCache& cache, bool buildTree) const
+    {
+	// Histograms don't change under rigid transformations
+	if(cache.shapeGeneration == mesh.getShapeGeneration() && cache.amountOfVertices == mesh.getAmountOfVertices())
+	    return false;
+	cache.averageEdgeLength = computeFeatures(mesh, cache.features);
+	if(buildTree)
+	    cache.tree.build(cache.features);
+	cache.shapeGeneration = mesh.getShapeGeneration();
+	cache.amountOfVertices = mesh.getAmountOfVertices();
+	return true;
+    }
+}
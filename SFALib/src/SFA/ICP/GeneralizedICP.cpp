@@ -0,0 +1,163 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Face Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include "SFA/ICP/GeneralizedICP.h"
+
+namespace sfa
+{
+    GeneralizedICP::GeneralizedICP(NearestNeighbor& nn, AbstractLog* pLog) : ICP(pLog), m_nearestNeighbor(nn)
+    {
+    }
+
+    GeneralizedICP::~GeneralizedICP()
+    {
+    }
+
+    unsigned int GeneralizedICP::calcNextStep(AbstractMesh& source, AbstractMesh const& dest)
+    {
+	// Make sure the cached covariances match both meshes
+	updateCovariances(source, m_sourceCache);
+	updateCovariances(dest, m_destCache);
+	// Temporaries of the previous step aren't needed anymore
+	m_arena.reset();
+	// Select points
+	selectIndices(source);
+	m_nearestNeighbor.findAllNearest(m_selection, source, dest, m_nearest, m_threads);
+	// Sort out edge points on dest
+	rejectEdgePairs(dest);
+	auto amountOfPoints = m_selection.size();
+	if (amountOfPoints < 3)
+	{
+	    if (m_pLog != nullptr)
+		m_pLog->warning("Not enough point pairs to compute a transformation.");
+	    m_nearestNeighbor.clearCache();
+	    return amountOfPoints;
+	}
+	// Gather point pairs and rotate covariances into the current frames of source and destination
+	auto srcCoords = m_arena.allocateMatrix<Eigen::Matrix3Xd>(3, amountOfPoints);
+	auto destCoords = m_arena.allocateMatrix<Eigen::Matrix3Xd>(3, amountOfPoints);
+	auto srcCovariances = m_arena.allocate<Eigen::Matrix3d>(amountOfPoints);
+	auto destCovariances = m_arena.allocate<Eigen::Matrix3d>(amountOfPoints);
+	auto const& srcRot = m_sourceCache.rotation;
+	auto const& destRot = m_destCache.rotation;
+	for (unsigned int i = 0; i < amountOfPoints; i++)
+	{
+	    srcCoords.col(i) = source.getCoords(m_selection[i]);
+	    destCoords.col(i) = dest.getCoords(m_nearest[i]);
+	    new (srcCovariances + i) Eigen::Matrix3d(srcRot * m_sourceCache.covariances[m_selection[i]] * srcRot.transpose());
+	    new (destCovariances + i) Eigen::Matrix3d(destRot * m_destCache.covariances[m_nearest[i]] * destRot.transpose());
+	}
+	// Gauss-Newton iterations to minimize the sum of Mahalanobis distances
+	Eigen::Matrix3d R = Eigen::Matrix3d::Identity();
+	Eigen::Vector3d t = Eigen::Vector3d::Zero();
+	for (unsigned int iteration = 0; iteration < m_maxIterations; iteration++)
+	{
+	    Eigen::Matrix<double, 6, 6> H = Eigen::Matrix<double, 6, 6>::Zero();
+	    Eigen::Matrix<double, 6, 1> g = Eigen::Matrix<double, 6, 1>::Zero();
+	    for (unsigned int k = 0; k < amountOfPoints; k++)
+	    {
+		Eigen::Vector3d p = R * srcCoords.col(k);
+		Eigen::Vector3d d = destCoords.col(k) - p - t;
+		Eigen::Matrix3d omega = (destCovariances[k] + R * srcCovariances[k] * R.transpose()).inverse();
+		// Jacobian of the residual with respect to (rotation, translation)
+		Eigen::Matrix<double, 3, 6> J;
+		J << 0, -p.z(), p.y(), -1, 0, 0,
+		     p.z(), 0, -p.x(), 0, -1, 0,
+		     -p.y(), p.x(), 0, 0, 0, -1;
+		H += J.transpose() * omega * J;
+		g += J.transpose() * omega * d;
+	    }
+	    Eigen::Matrix<double, 6, 1> x = -H.ldlt().solve(g); // x = (omega_x, omega_y, omega_z, tx, ty, tz)
+	    Eigen::Vector3d w = x.head<3>();
+	    double angle = w.norm();
+	    if (angle > 0)
+		R = Eigen::AngleAxisd(angle, w / angle).toRotationMatrix() * R;
+	    t += x.tail<3>();
+	    if (x.squaredNorm() < m_convergenceThreshold)
+		break;
+	}
+	// Apply values to all vertices of source
+	unsigned int generation = source.getGeneration();
+	source.applyTransform(R, t);
+	keepSelectionCaches(source, generation);
+	// The cached source covariances just rotate along
+	m_sourceCache.rotation = R * m_sourceCache.rotation;
+	m_sourceCache.generation = source.getGeneration();
+	// Clear nearest neighbor cache
+	m_nearestNeighbor.clearCache();
+
+	return amountOfPoints;
+    }
+
+    unsigned int GeneralizedICP::getMaxIterations() const
+    {
+	return m_maxIterations;
+    }
+
+    void GeneralizedICP::setMaxIterations(unsigned int iterations)
+    {
+	m_maxIterations = iterations;
+    }
+
+    unsigned int GeneralizedICP::getCovarianceComputations() const
+    {
+	return m_covarianceComputations;
+    }
+
+    void GeneralizedICP::updateCovariances(AbstractMesh const& mesh, CovarianceCache& cache)
+    {
+	if (cache.generation == mesh.getGeneration() && cache.covariances.size() == mesh.getAmountOfVertices())
+	    return;
+	cache.covariances.resize(mesh.getAmountOfVertices());
+	for (unsigned int i = 0; i < mesh.getAmountOfVertices(); i++)
+	    cache.covariances[i] = computeCovariance(mesh, i);
+	cache.rotation = Eigen::Matrix3d::Identity();
+	cache.generation = mesh.getGeneration();
+	m_covarianceComputations++;
+	if (m_pLog != nullptr)
+	    m_pLog->info("Computed %u vertex covariances.", static_cast<unsigned int>(cache.covariances.size()));
+    }
+
+    Eigen::Matrix3d GeneralizedICP::computeCovariance(AbstractMesh const& mesh, unsigned int n) const
+    {
+	// Without a proper neighbor ring fall back to the vertex normal
+	auto neighbors = mesh.getAdjacency().getNeighbors(n);
+	if (neighbors.size() < 2)
+	    return planeCovariance(mesh.getNormal(n));
+	// Covariance of the vertex and its neighbors
+	std::vector<Eigen::Vector3d> points;
+	points.reserve(neighbors.size() + 1);
+	points.push_back(mesh.getCoords(n));
+	for (auto neighbor : neighbors)
+	    points.push_back(mesh.getCoords(neighbor));
+	Eigen::Vector3d mean = Eigen::Vector3d::Zero();
+	for (auto const& point : points)
+	    mean += point;
+	mean /= points.size();
+	Eigen::Matrix3d covariance = Eigen::Matrix3d::Zero();
+	for (auto const& point : points)
+	    covariance += (point - mean) * (point - mean).transpose();
+	covariance /= points.size();
+	// The eigenvector of the smallest eigenvalue is the surface normal. Eigenvalues are
+	// sorted in increasing order. If the second one is zero as well the ring is degenerated.
+	Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> solver;
+	solver.computeDirect(covariance);
+	if (solver.info() != Eigen::Success || solver.eigenvalues()[1] <= 0)
+	    return planeCovariance(mesh.getNormal(n));
+	return planeCovariance(solver.eigenvectors().col(0));
+    }
+
+    Eigen::Matrix3d GeneralizedICP::planeCovariance(Eigen::Vector3d const& normal) const
+    {
+	// Rotation of diag(epsilon, 1, 1) such that the first axis matches the normal
+	Eigen::Vector3d n = normal.normalized();
+	return Eigen::Matrix3d::Identity() - (1 - m_epsilon) * n * n.transpose();
+    }
+}
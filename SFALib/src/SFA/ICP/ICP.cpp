@@ -23,60 +23,283 @@ namespace sfa
     {
     }
 
+    void ICP::reset()
+    {
+    }
+
     std::vector<Vertex> ICP::selectPoints(AbstractMesh& source)
     {
-	// Copy all vertices
+	// Copy all selected vertices
+	auto const& indices = selectIndices(source);
 	std::vector<Vertex> vertices;
-	// Initialize random number generator
-	std::uniform_int_distribution<uint32_t> rand_uint_0_1(0,1);
-	// Remove all the ones we don't need
-	for(unsigned int i = 0; i < source.getAmountOfVertices(); i++)
+	vertices.reserve(indices.size());
+	for (auto index : indices)
+	    vertices.push_back(source.getVertex(index));
+	return vertices;
+    }
+
+    std::vector<uint32_t> const& ICP::selectIndices(AbstractMesh const& source)
+    {
+	// Reuse the memory of the last selection
+	m_selection.clear();
+	if(m_selectionPercentage <= 0)
+	    return m_selection;
+	// Covariance and normal-space sampling pick the percentage on their own
+	if(m_selectionMethod & (PointSelection::COVARIANCE | PointSelection::NORMAL_SPACE))
 	{
-	    auto vertex = source.getVertex(i);
-	    bool insert = true;
-	    if (insert && (m_selectionMethod & PointSelection::NO_EDGES))
-		insert = !vertex.isEdge;
-	    if(insert && (m_selectionMethod & PointSelection::RANDOM))
-		insert = rand_uint_0_1(m_random);
-	    if(insert && (m_selectionMethod & PointSelection::EVERY_SECOND))
-		insert = (i % 2 != 0);
-	    if(insert && (m_selectionMethod & PointSelection::EVERY_THIRD))
-		insert = (i % 3 != 0);
-	    if(insert && (m_selectionMethod & PointSelection::EVERY_FOURTH))
-		insert = (i % 4 != 0);
-	    if(insert && (m_selectionMethod & PointSelection::EVERY_FIFTH))
-		insert = (i % 5 != 0);
-	    if(insert)
-		vertices.push_back(vertex);
+	    if(m_selectionMethod & PointSelection::COVARIANCE)
+		selectCovariance(source);
+	    else
+		selectNormalSpace(source);
+	    if (m_pLog != nullptr)
+		m_pLog->info("Selected %u points on source mesh.", static_cast<unsigned int>(m_selection.size()));
+	    return m_selection;
 	}
-	// Pick n% of those already selected
-	if(m_selectionPercentage < 1)
+	// Evaluate all filters in one pass
+	uint32_t amount = source.getAmountOfVertices();
+	m_selection.reserve(amount);
+	for(uint32_t i = 0; i < amount; i++)
 	{
-	    if(m_selectionPercentage <= 0)
-	    {
-		vertices.clear();
-		return vertices;
-	    }
-
-	    double elementsToPick = vertices.size() * m_selectionPercentage;
-	    for(auto it = vertices.begin(); it != vertices.end(); ++it)
+	    if(isSelectable(source, i))
+		m_selection.push_back(i);
+	}
+	// Pick n% of those already selected. Every candidate is kept with probability
+	// needed / left which yields exactly the wanted amount in a single pass.
+	uint32_t left = m_selection.size();
+	uint32_t needed = getSelectionAmount(left);
+	if(needed < left)
+	{
+	    uint32_t kept = 0;
+	    std::uniform_real_distribution<double> rand_double(0, 1);
+	    for(uint32_t i = 0; i < m_selection.size() && needed > 0; i++, left--)
 	    {
-		double needed = elementsToPick;
-		double left = std::distance(it, vertices.end());
-		double probability = needed / left;
-		std::uniform_real_distribution<double> rand_double(0, 1);
-		if(rand_double(m_random) <= probability)
-		    elementsToPick--;
-		else
+		if(rand_double(m_random) * left < needed)
 		{
-		    vertices.erase(it);
-		    --it;
+		    m_selection[kept++] = m_selection[i];
+		    needed--;
 		}
 	    }
+	    m_selection.resize(kept);
 	}
 	if (m_pLog != nullptr)
-	    m_pLog->info("Selected %d points on source mesh.", vertices.size());
-	return vertices;
+	    m_pLog->info("Selected %u points on source mesh.", static_cast<unsigned int>(m_selection.size()));
+	return m_selection;
+    }
+
+    bool ICP::isSelectable(AbstractMesh const& source, uint32_t i)
+    {
+	// Cheap index based filters first
+	if(((m_selectionMethod & PointSelection::EVERY_SECOND) && i % 2 == 0)
+		|| ((m_selectionMethod & PointSelection::EVERY_THIRD) && i % 3 == 0)
+		|| ((m_selectionMethod & PointSelection::EVERY_FOURTH) && i % 4 == 0)
+		|| ((m_selectionMethod & PointSelection::EVERY_FIFTH) && i % 5 == 0))
+	    return false;
+	if((m_selectionMethod & PointSelection::RANDOM) && !std::uniform_int_distribution<uint32_t>(0, 1)(m_random))
+	    return false;
+	if((m_selectionMethod & PointSelection::NO_EDGES) && source.isEdge(i))
+	    return false;
+	return true;
+    }
+
+    void ICP::selectNormalSpace(AbstractMesh const& source)
+    {
+	updateNormalBuckets(source);
+	auto& buckets = m_normalBuckets;
+	uint32_t needed = getSelectionAmount(source.getAmountOfVertices());
+	m_selection.reserve(needed);
+	// Start every bucket at a random position so successive steps use different points
+	buckets.active.clear();
+	for(uint32_t b = 0; b + 1 < buckets.offsets.size(); b++)
+	{
+	    uint32_t size = buckets.offsets[b + 1] - buckets.offsets[b];
+	    if(size > 0)
+	    {
+		buckets.starts[b] = std::uniform_int_distribution<uint32_t>(0, size - 1)(m_random);
+		buckets.active.push_back(b);
+	    }
+	}
+	// Draw one point from every bucket per round until enough points have been found
+	for(uint32_t round = 0; m_selection.size() < needed && !buckets.active.empty(); round++)
+	{
+	    unsigned int stillActive = 0;
+	    for(unsigned int i = 0; i < buckets.active.size() && m_selection.size() < needed; i++)
+	    {
+		uint32_t b = buckets.active[i];
+		uint32_t size = buckets.offsets[b + 1] - buckets.offsets[b];
+		uint32_t index = buckets.members[buckets.offsets[b] + (buckets.starts[b] + round) % size];
+		if(isSelectable(source, index))
+		    m_selection.push_back(index);
+		if(round + 1 < size)
+		    buckets.active[stillActive++] = b;
+	    }
+	    buckets.active.resize(stillActive);
+	}
+	// Sorted indices make for more cache friendly access later on
+	std::sort(m_selection.begin(), m_selection.end());
+    }
+
+    void ICP::updateNormalBuckets(AbstractMesh const& source)
+    {
+	auto& buckets = m_normalBuckets;
+	if(buckets.pMesh == &source && buckets.generation == source.getGeneration()
+		&& buckets.amountOfVertices == source.getAmountOfVertices())
+	    return;
+	// Buckets are equally sized in the cosine of the polar angle and in the azimuth, which
+	// makes them cover equal areas on the unit sphere
+	const unsigned int zBuckets = m_normalBucketResolution;
+	const unsigned int phiBuckets = 2 * m_normalBucketResolution;
+	const double Pi = std::acos(-1.0);
+	uint32_t amount = source.getAmountOfVertices();
+	std::vector<uint32_t> bucketOf(amount);
+	buckets.offsets.assign(zBuckets * phiBuckets + 1, 0);
+	for(uint32_t i = 0; i < amount; i++)
+	{
+	    Eigen::Vector3d normal = source.getNormal(i).normalized();
+	    double z = std::max(-1.0, std::min(1.0, normal.z()));
+	    double phi = std::atan2(normal.y(), normal.x());
+	    unsigned int zIndex = std::min<unsigned int>((z + 1) / 2 * zBuckets, zBuckets - 1);
+	    unsigned int phiIndex = std::min<unsigned int>((phi + Pi) / (2 * Pi) * phiBuckets, phiBuckets - 1);
+	    bucketOf[i] = zIndex * phiBuckets + phiIndex;
+	    buckets.offsets[bucketOf[i] + 1]++;
+	}
+	// Counting sort of the vertices by bucket
+	for(unsigned int b = 1; b < buckets.offsets.size(); b++)
+	    buckets.offsets[b] += buckets.offsets[b - 1];
+	buckets.members.resize(amount);
+	std::vector<uint32_t> fill(buckets.offsets.begin(), buckets.offsets.end() - 1);
+	for(uint32_t i = 0; i < amount; i++)
+	    buckets.members[fill[bucketOf[i]]++] = i;
+	// Shuffle every bucket once, then any consecutive run of members is a random subset
+	for(unsigned int b = 0; b + 1 < buckets.offsets.size(); b++)
+	    std::shuffle(buckets.members.begin() + buckets.offsets[b], buckets.members.begin() + buckets.offsets[b + 1], m_random);
+	buckets.starts.resize(zBuckets * phiBuckets);
+	buckets.pMesh = &source;
+	buckets.generation = source.getGeneration();
+	buckets.amountOfVertices = amount;
+    }
+
+    void ICP::keepSelectionCaches(AbstractMesh const& source, unsigned int previousGeneration)
+    {
+	if(m_normalBuckets.pMesh == &source && m_normalBuckets.generation == previousGeneration)
+	    m_normalBuckets.generation = source.getGeneration();
+	if(m_stableOrder.pMesh == &source && m_stableOrder.generation == previousGeneration)
+	    m_stableOrder.generation = source.getGeneration();
+    }
+
+    void ICP::selectCovariance(AbstractMesh const& source)
+    {
+	updateStableOrder(source);
+	uint32_t needed = getSelectionAmount(source.getAmountOfVertices());
+	m_selection.reserve(needed);
+	for(uint32_t i = 0; i < m_stableOrder.order.size() && m_selection.size() < needed; i++)
+	{
+	    if(isSelectable(source, m_stableOrder.order[i]))
+		m_selection.push_back(m_stableOrder.order[i]);
+	}
+	std::sort(m_selection.begin(), m_selection.end());
+    }
+
+    void ICP::updateStableOrder(AbstractMesh const& source)
+    {
+	if(m_stableOrder.pMesh == &source && m_stableOrder.generation == source.getGeneration()
+		&& m_stableOrder.amountOfVertices == source.getAmountOfVertices())
+	    return;
+	typedef Eigen::Matrix<double, 6, 1> Vector6d;
+	typedef Eigen::Matrix<double, 6, 6> Matrix6d;
+	uint32_t amount = source.getAmountOfVertices();
+	// Center and scale the points so rotations and translations are weighed equally
+	Eigen::Vector3d center = Eigen::Vector3d::Zero();
+	for(uint32_t i = 0; i < amount; i++)
+	    center += source.getCoords(i);
+	center /= std::max(amount, 1u);
+	double scale = 0;
+	for(uint32_t i = 0; i < amount; i++)
+	    scale += (source.getCoords(i) - center).norm();
+	scale = scale > 0 ? amount / scale : 1;
+	// Point-to-plane constraint of every vertex and their covariance
+	Eigen::Matrix<double, 6, Eigen::Dynamic> constraints(6, amount);
+	for(uint32_t i = 0; i < amount; i++)
+	{
+	    Eigen::Vector3d normal = source.getNormal(i);
+	    constraints.col(i) << ((source.getCoords(i) - center) * scale).cross(normal), normal;
+	}
+	Matrix6d covariance = constraints * constraints.transpose();
+	Eigen::SelfAdjointEigenSolver<Matrix6d> solver(covariance);
+	// Squared contribution of every vertex to every eigenvector
+	Eigen::Matrix<double, 6, Eigen::Dynamic> contribution = (solver.eigenvectors().transpose() * constraints).cwiseAbs2();
+	// One list per eigenvector, sorted by decreasing contribution
+	std::vector<uint32_t> lists[6];
+	for(unsigned int k = 0; k < 6; k++)
+	{
+	    lists[k].resize(amount);
+	    for(uint32_t i = 0; i < amount; i++)
+		lists[k][i] = i;
+	    std::sort(lists[k].begin(), lists[k].end(), [&contribution, k](uint32_t a, uint32_t b)
+	    {
+		return contribution(k, a) > contribution(k, b);
+	    });
+	}
+	// Always take the best remaining vertex for the eigenvector that is constrained the least
+	std::vector<bool> used(amount, false);
+	uint32_t positions[6] = {0, 0, 0, 0, 0, 0};
+	Vector6d constrained = Vector6d::Zero();
+	m_stableOrder.order.clear();
+	m_stableOrder.order.reserve(amount);
+	while(m_stableOrder.order.size() < amount)
+	{
+	    unsigned int k;
+	    constrained.minCoeff(&k);
+	    while(used[lists[k][positions[k]]])
+		positions[k]++;
+	    uint32_t index = lists[k][positions[k]];
+	    used[index] = true;
+	    m_stableOrder.order.push_back(index);
+	    constrained += contribution.col(index);
+	}
+	m_stableOrder.pMesh = &source;
+	m_stableOrder.generation = source.getGeneration();
+	m_stableOrder.amountOfVertices = amount;
+    }
+
+    Eigen::Isometry3d ICP::estimatePose(Eigen::Matrix3Xd const& X, Eigen::Matrix3Xd const& Y)
+    {
+	Eigen::Vector3d xMean = X.rowwise().mean();
+	Eigen::Vector3d yMean = Y.rowwise().mean();
+	Eigen::Matrix3d H = (X.colwise() - xMean) * (Y.colwise() - yMean).transpose();
+	Eigen::JacobiSVD<Eigen::Matrix3d> svd(H, Eigen::ComputeFullU | Eigen::ComputeFullV);
+	// Make sure the result is a rotation rather than a reflection
+	Eigen::Matrix3d D = Eigen::Matrix3d::Identity();
+	D(2, 2) = (svd.matrixV() * svd.matrixU().transpose()).determinant();
+	Eigen::Isometry3d pose = Eigen::Isometry3d::Identity();
+	pose.linear() = svd.matrixV() * D * svd.matrixU().transpose();
+	pose.translation() = yMean - pose.linear() * xMean;
+	return pose;
+    }
+
+    uint32_t ICP::getSelectionAmount(uint32_t candidates) const
+    {
+	uint32_t amount = static_cast<uint32_t>(std::floor(candidates * std::min(m_selectionPercentage, 1.0) + 0.5));
+	if(m_selectionBudget > 0)
+	    amount = std::min<uint32_t>(amount, m_selectionBudget);
+	return amount;
+    }
+
+    void ICP::rejectEdgePairs(AbstractMesh const& dest)
+    {
+	if(!(m_selectionMethod & PointSelection::NO_EDGES))
+	    return;
+	unsigned int kept = 0;
+	for (unsigned int i = 0; i < m_nearest.size(); i++)
+	{
+	    if (!dest.isEdge(m_nearest[i]))
+	    {
+		m_selection[kept] = m_selection[i];
+		m_nearest[kept] = m_nearest[i];
+		kept++;
+	    }
+	}
+	m_selection.resize(kept);
+	m_nearest.resize(kept);
     }
 
     Eigen::Vector3d ICP::getAverage(std::vector<Vertex> const& points) const
@@ -115,4 +338,36 @@ namespace sfa
     {
 	m_selectionPercentage = percentage;
     }
+
+    unsigned int const& ICP::getSelectionBudget() const
+    {
+	return m_selectionBudget;
+    }
+
+    void ICP::setSelectionBudget(unsigned int budget)
+    {
+	m_selectionBudget = budget;
+    }
+
+    void ICP::setSeed(unsigned int seed)
+    {
+	m_random.seed(seed);
+	// Buckets are shuffled with the generator, so they have to be rebuilt to be reproducible
+	m_normalBuckets.pMesh = nullptr;
+    }
+
+    unsigned int ICP::getThreads() const
+    {
+	return m_threads;
+    }
+
+    void ICP::setThreads(unsigned int threads)
+    {
+	m_threads = threads;
+    }
+
+    Arena const& ICP::getArena() const
+    {
+	return m_arena;
+    }
 }
@@ -0,0 +1,307 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Face Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include "SFA/ICP/LandmarkICP.h"
+
+namespace sfa
+{
+    LandmarkICP::LandmarkICP(AbstractLog* pLog) : ICP(pLog)
+    {
+    }
+
+    LandmarkICP::~LandmarkICP()
+    {
+    }
+
+    unsigned int LandmarkICP::calcNextStep(AbstractMesh& source, AbstractMesh const& dest)
+    {
+	// Coarse alignment only has to be done once
+	if(m_aligned)
+	    return 0;
+
+	unsigned int pairs = 0;
+	Eigen::Isometry3d pose = findPose(source, dest, &pairs);
+	source.applyTransform(pose.linear(), pose.translation());
+	m_aligned = true;
+
+	return pairs;
+    }
+
+    Eigen::Isometry3d LandmarkICP::findPose(AbstractMesh const& source, AbstractMesh const& dest, unsigned int* pPairs)
+    {
+	// Both meshes are independent of each other
+	TaskGroup group;
+	group.run([&]()
+	{
+	    updateLandmarks(source, m_sourceLandmarks);
+	});
+	updateLandmarks(dest, m_destLandmarks);
+	group.wait();
+	if(pPairs != nullptr)
+	    *pPairs = 0;
+	auto const& src = m_sourceLandmarks;
+	auto const& dst = m_destLandmarks;
+	unsigned int ns = src.landmarks.size();
+	unsigned int nd = dst.landmarks.size();
+	if(ns < 3 || nd < 3)
+	    return Eigen::Isometry3d::Identity();
+
+	// Try every source triplet against every ordered destination triplet with the same
+	// convexity and distances
+	double tolerance = m_tolerance * dst.size;
+	Eigen::Isometry3d bestPose = Eigen::Isometry3d::Identity();
+	unsigned int bestMatches = 0;
+	double bestError = 0;
+	std::vector<int> pairs;
+	Eigen::Matrix3Xd X(3, 3);
+	Eigen::Matrix3Xd Y(3, 3);
+	for (unsigned int a = 0; a < ns; a++)
+	{
+	    for (unsigned int b = a + 1; b < ns; b++)
+	    {
+		for (unsigned int c = b + 1; c < ns; c++)
+		{
+		    unsigned int triplet[3] = {a, b, c};
+		    for (unsigned int i = 0; i < nd; i++)
+		    {
+			for (unsigned int j = 0; j < nd; j++)
+			{
+			    for (unsigned int k = 0; k < nd; k++)
+			    {
+				unsigned int candidate[3] = {i, j, k};
+				if(i == j || j == k || i == k)
+				    continue;
+				bool consistent = true;
+				for (unsigned int e = 0; e < 3 && consistent; e++)
+				{
+				    unsigned int s0 = triplet[e], s1 = triplet[(e + 1) % 3];
+				    unsigned int d0 = candidate[e], d1 = candidate[(e + 1) % 3];
+				    double srcLength = (src.positions.col(s0) - src.positions.col(s1)).norm();
+				    double destLength = (dst.positions.col(d0) - dst.positions.col(d1)).norm();
+				    consistent = src.convex[s0] == dst.convex[d0] && std::abs(srcLength - destLength) < tolerance;
+				}
+				if(!consistent)
+				    continue;
+				X << src.positions.col(a), src.positions.col(b), src.positions.col(c);
+				Y << dst.positions.col(i), dst.positions.col(j), dst.positions.col(k);
+				Eigen::Isometry3d pose = estimatePose(X, Y);
+				double error = 0;
+				unsigned int matches = matchLandmarks(pose, tolerance, pairs, error);
+				if(matches > bestMatches || (matches == bestMatches && error < bestError))
+				{
+				    bestMatches = matches;
+				    bestError = error;
+				    bestPose = pose;
+				}
+			    }
+			}
+		    }
+		}
+	    }
+	}
+	if(bestMatches < 3)
+	    return Eigen::Isometry3d::Identity();
+
+	// Refine using all matching landmarks
+	double error = 0;
+	matchLandmarks(bestPose, tolerance, pairs, error);
+	Eigen::Matrix3Xd allX(3, bestMatches);
+	Eigen::Matrix3Xd allY(3, bestMatches);
+	unsigned int matches = 0;
+	for (unsigned int i = 0; i < ns && matches < bestMatches; i++)
+	{
+	    if(pairs[i] < 0)
+		continue;
+	    allX.col(matches) = src.positions.col(i);
+	    allY.col(matches) = dst.positions.col(pairs[i]);
+	    matches++;
+	}
+	if (m_pLog != nullptr)
+	    m_pLog->info("Matched %u of %u landmarks.", matches, ns);
+	if(pPairs != nullptr)
+	    *pPairs = matches;
+	return estimatePose(allX.leftCols(matches), allY.leftCols(matches));
+    }
+
+    void LandmarkICP::computeCurvatures(AbstractMesh const& mesh, std::vector<Curvature>& curvatures) const
+    {
+	unsigned int amount = mesh.getAmountOfVertices();
+	curvatures.assign(amount, Curvature());
+
+	// Copy positions and normals once
+	Eigen::Matrix3Xd coords = mesh.getPositions();
+	Eigen::Matrix3Xd normals = mesh.getNormals();
+	for (unsigned int i = 0; i < amount; i++)
+	    normals.col(i).normalize();
+	Adjacency const& adjacency = mesh.getAdjacency();
+
+	unsigned int chunks = (amount + m_chunkSize - 1) / m_chunkSize;
+	parallelFor(0, chunks, [&](unsigned int chunk)
+	{
+	    std::vector<uint32_t> neighborhood;
+	    for (unsigned int i = chunk * m_chunkSize; i < std::min(amount, (chunk + 1) * m_chunkSize); i++)
+	    {
+		// Three neighbors determine the fit exactly and make it very sensitive to noise,
+		// such sparse vertices use their two-ring instead
+		auto ring = adjacency.getNeighbors(i);
+		neighborhood.assign(ring.begin(), ring.end());
+		if(neighborhood.size() < 5)
+		    adjacency.getRing(i, 2, neighborhood);
+		if(neighborhood.size() < 3)
+		    continue;
+		// Fit the height field h(x,y) = a x^2 + b x y + c y^2 over the tangent plane
+		Eigen::Vector3d n = normals.col(i);
+		Eigen::Vector3d e1 = n.unitOrthogonal();
+		Eigen::Vector3d e2 = n.cross(e1);
+		Eigen::Matrix3d AtA = Eigen::Matrix3d::Zero();
+		Eigen::Vector3d Atb = Eigen::Vector3d::Zero();
+		for (auto neighbor : neighborhood)
+		{
+		    Eigen::Vector3d d = coords.col(neighbor) - coords.col(i);
+		    double x = d.dot(e1);
+		    double y = d.dot(e2);
+		    Eigen::Vector3d row(x * x, x * y, y * y);
+		    AtA += row * row.transpose();
+		    Atb += row * d.dot(n);
+		}
+		Eigen::LDLT<Eigen::Matrix3d> ldlt(AtA);
+		if(ldlt.info() != Eigen::Success || !ldlt.isPositive())
+		    continue;
+		Eigen::Vector3d abc = ldlt.solve(Atb);
+		// Eigenvalues of the second fundamental form [[2a, b], [b, 2c]], negated so convex
+		// regions that bend away from the normal are positive
+		double mean = -(abc[0] + abc[2]);
+		double deviation = std::sqrt((abc[0] - abc[2]) * (abc[0] - abc[2]) + abc[1] * abc[1]);
+		curvatures[i].max = mean + deviation;
+		curvatures[i].min = mean - deviation;
+	    }
+	});
+    }
+
+    void LandmarkICP::findLandmarks(AbstractMesh const& mesh, std::vector<Curvature> const& curvatures,
+	    std::vector<uint32_t>& landmarks) const
+    {
+	landmarks.clear();
+	unsigned int amount = std::min<unsigned int>(mesh.getAmountOfVertices(), curvatures.size());
+	if(amount == 0)
+	    return;
+
+	// Sort all inner vertices by curvedness
+	std::vector<uint32_t> candidates;
+	std::vector<double> curvedness(amount);
+	auto positions = mesh.getPositions();
+	Eigen::Vector3d min = positions.rowwise().minCoeff();
+	Eigen::Vector3d max = positions.rowwise().maxCoeff();
+	for (unsigned int i = 0; i < amount; i++)
+	{
+	    curvedness[i] = std::sqrt((curvatures[i].max * curvatures[i].max + curvatures[i].min * curvatures[i].min) / 2);
+	    if(!mesh.isEdge(i) && curvedness[i] > 0)
+		candidates.push_back(i);
+	}
+	std::sort(candidates.begin(), candidates.end(), [&curvedness](uint32_t a, uint32_t b)
+	{
+	    return curvedness[a] > curvedness[b];
+	});
+
+	// Greedily pick the strongest ones, suppressing their surroundings
+	double radius = m_suppressionRadius * (max - min).norm();
+	std::vector<Eigen::Vector3d> picked;
+	for (unsigned int i = 0; i < candidates.size() && landmarks.size() < m_landmarks; i++)
+	{
+	    Eigen::Vector3d coords = positions.col(candidates[i]);
+	    bool isolated = true;
+	    for (unsigned int j = 0; j < picked.size() && isolated; j++)
+		isolated = (picked[j] - coords).norm() >= radius;
+	    if(isolated)
+	    {
+		landmarks.push_back(candidates[i]);
+		picked.push_back(coords);
+	    }
+	}
+    }
+
+    void LandmarkICP::reset()
+    {
+	m_aligned = false;
+    }
+
+    unsigned int LandmarkICP::getLandmarks() const
+    {
+	return m_landmarks;
+    }
+
+    void LandmarkICP::setLandmarks(unsigned int landmarks)
+    {
+	m_landmarks = std::max(landmarks, 3u);
+    }
+
+    void LandmarkICP::updateLandmarks(AbstractMesh const& mesh, LandmarkCache& cache) const
+    {
+	if(cache.generation == mesh.getGeneration() && cache.amountOfVertices == mesh.getAmountOfVertices())
+	    return;
+	// Curvatures don't change under rigid transformations, thus landmarks only have to be searched
+	// again if the shape changed
+	if(cache.shapeGeneration != mesh.getShapeGeneration() || cache.amountOfVertices != mesh.getAmountOfVertices())
+	{
+	    std::vector<Curvature> curvatures;
+	    computeCurvatures(mesh, curvatures);
+	    findLandmarks(mesh, curvatures, cache.landmarks);
+	    cache.convex.resize(cache.landmarks.size());
+	    for (unsigned int i = 0; i < cache.landmarks.size(); i++)
+	    {
+		auto const& curvature = curvatures[cache.landmarks[i]];
+		cache.convex[i] = curvature.max + curvature.min > 0;
+	    }
+	    cache.shapeGeneration = mesh.getShapeGeneration();
+	}
+	cache.positions.resize(3, cache.landmarks.size());
+	for (unsigned int i = 0; i < cache.landmarks.size(); i++)
+	    cache.positions.col(i) = mesh.getCoords(cache.landmarks[i]);
+	cache.size = 0;
+	if(mesh.getAmountOfVertices() > 0)
+	{
+	    auto positions = mesh.getPositions();
+	    cache.size = (positions.rowwise().maxCoeff() - positions.rowwise().minCoeff()).norm();
+	}
+	cache.generation = mesh.getGeneration();
+	cache.amountOfVertices = mesh.getAmountOfVertices();
+    }
+
+    unsigned int LandmarkICP::matchLandmarks(Eigen::Isometry3d const& pose, double tolerance, std::vector<int>& pairs,
+	    double& error) const
+    {
+	auto const& src = m_sourceLandmarks;
+	auto const& dst = m_destLandmarks;
+	pairs.assign(src.landmarks.size(), -1);
+	error = 0;
+	unsigned int matches = 0;
+	double sqTolerance = tolerance * tolerance;
+	for (unsigned int i = 0; i < src.landmarks.size(); i++)
+	{
+	    Eigen::Vector3d x = pose * src.positions.col(i);
+	    double bestSqDist = sqTolerance;
+	    for (unsigned int j = 0; j < dst.landmarks.size(); j++)
+	    {
+		double sqDist = (x - dst.positions.col(j)).squaredNorm();
+		if(src.convex[i] == dst.convex[j] && sqDist < bestSqDist)
+		{
+		    bestSqDist = sqDist;
+		    pairs[i] = j;
+		}
+	    }
+	    if(pairs[i] >= 0)
+	    {
+		matches++;
+		error += bestSqDist;
+	    }
+	}
+	return matches;
+    }
+}
@@ -12,121 +12,205 @@
 
 namespace sfa
 {
+    PCA_ICP::PCA_ICP(AbstractLog* pLog) : ICP(pLog)
+    {
+    }
+
+    PCA_ICP::PCA_ICP(NearestNeighbor& nn, AbstractLog* pLog) : ICP(pLog), m_pNearestNeighbor(&nn)
+    {
+    }
+
     PCA_ICP::~PCA_ICP()
     {
     }
 
     unsigned int PCA_ICP::calcNextStep(AbstractMesh& source, AbstractMesh const& dest)
     {
-	// Only 3 principal components...
-	if(m_index >= 3)
+	// All principal components are aligned at once
+	if(m_aligned)
 	    return 0;
 
-	auto srcAvg = source.getAverage();
-	auto destAvg = dest.getAverage();
-	auto amountOfPointsSource = source.getAmountOfVertices();
-	auto amountOfPointsDest = dest.getAmountOfVertices();
+	Eigen::Isometry3d pose = findPose(source, dest);
+	Eigen::Matrix3d R = pose.linear();
+	Eigen::Vector3d t = pose.translation();
+
+	// Apply values to all vertices of source
+	source.applyTransform(R, t);
+	// The moments of the transformed source are known without another pass
+	m_sourceMoments.mean = R * m_sourceMoments.mean + t;
+	m_sourceMoments.axes = R * m_sourceMoments.axes;
+	m_sourceMoments.generation = source.getGeneration();
+	m_aligned = true;
+
+	return source.getAmountOfVertices();
+    }
+
+    Eigen::Isometry3d PCA_ICP::findPose(AbstractMesh const& source, AbstractMesh const& dest)
+    {
+	updateMoments(source, m_sourceMoments);
+	updateMoments(dest, m_destMoments);
+	if(m_pNearestNeighbor != nullptr)
+	    return raceHypotheses(source, dest);
+
+	// Since eigenvectors may point in either direction, flip every source axis such that it
+	// needs the minimal rotation onto the corresponding destination axis
+	Eigen::Matrix3d srcAxes = m_sourceMoments.axes;
+	Eigen::Matrix3d const& destAxes = m_destMoments.axes;
+	for (unsigned int i = 0; i < 3; i++)
+	{
+	    if(srcAxes.col(i).dot(destAxes.col(i)) < 0)
+		srcAxes.col(i) *= -1;
+	}
+	// We can't be sure that both coordinate systems have the same handedness. In that case
+	// the axis with the least variance is sacrificed to get a proper rotation.
+	if(srcAxes.determinant() * destAxes.determinant() < 0)
+	    srcAxes.col(2) *= -1;
+	Eigen::Isometry3d pose = Eigen::Isometry3d::Identity();
+	pose.linear() = destAxes * srcAxes.transpose();
+	pose.translation() = m_destMoments.mean - pose.linear() * m_sourceMoments.mean;
+	return pose;
+    }
+
+    void PCA_ICP::reset()
+    {
+	m_aligned = false;
+    }
+
+    unsigned int PCA_ICP::getHypothesisSamples() const
+    {
+	return m_hypothesisSamples;
+    }
+
+    void PCA_ICP::setHypothesisSamples(unsigned int samples)
+    {
+	m_hypothesisSamples = samples;
+    }
+
+    unsigned int PCA_ICP::getHypothesisIterations() const
+    {
+	return m_hypothesisIterations;
+    }
+
+    void PCA_ICP::setHypothesisIterations(unsigned int iterations)
+    {
+	m_hypothesisIterations = iterations;
+    }
+
+    void PCA_ICP::updateMoments(AbstractMesh const& mesh, Moments& moments) const
+    {
+	unsigned int amount = mesh.getAmountOfVertices();
+	if(moments.generation == mesh.getGeneration() && moments.amountOfVertices == amount)
+	    return;
+	moments.generation = mesh.getGeneration();
+	moments.amountOfVertices = amount;
+	if(amount == 0)
+	    return;
 
-	// Align next principal component
-	// Calculate X & Y
-	Eigen::MatrixXd X(3, amountOfPointsSource);
-	Eigen::MatrixXd Y(3, amountOfPointsDest);
-	for (unsigned int i = 0; i < amountOfPointsSource; i++)
+	// Sums are taken relative to the first vertex to avoid cancellation
+	auto positions = mesh.getPositions();
+	Eigen::Vector3d origin = positions.col(0);
+	Eigen::Vector3d sum = Eigen::Vector3d::Zero();
+	Eigen::Matrix3d sumSquares = Eigen::Matrix3d::Zero();
+	for (unsigned int i = 0; i < amount; i++)
 	{
-	    auto srcVertex = source.getVertex(i).coords;
-	    auto corSrcVertex = srcVertex - srcAvg;
-	    X(0, i) = corSrcVertex.x();
-	    X(1, i) = corSrcVertex.y();
-	    X(2, i) = corSrcVertex.z();
+	    Eigen::Vector3d d = positions.col(i) - origin;
+	    sum += d;
+	    sumSquares.selfadjointView<Eigen::Lower>().rankUpdate(d);
 	}
-	for (unsigned int i = 0; i < amountOfPointsDest; i++)
+	Eigen::Vector3d mean = sum / amount;
+	Eigen::Matrix3d covariance = sumSquares.selfadjointView<Eigen::Lower>();
+	covariance = covariance / amount - mean * mean.transpose();
+	moments.mean = origin + mean;
+
+	// Eigenvalues are returned in increasing order
+	Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> solver;
+	solver.computeDirect(covariance);
+	moments.axes = solver.eigenvectors().rowwise().reverse();
+    }
+
+    Eigen::Isometry3d PCA_ICP::raceHypotheses(AbstractMesh const& source, AbstractMesh const& dest) const
+    {
+	// Evenly spread subsample of source
+	unsigned int amount = std::min(m_hypothesisSamples, source.getAmountOfVertices());
+	Eigen::Matrix3Xd samples(3, amount);
+	for (unsigned int i = 0; i < amount; i++)
+	    samples.col(i) = source.getCoords(static_cast<uint64_t>(i) * source.getAmountOfVertices() / amount);
+
+	// Every combination of axis directions that yields a proper rotation
+	Eigen::Matrix3d const& srcAxes = m_sourceMoments.axes;
+	Eigen::Matrix3d const& destAxes = m_destMoments.axes;
+	double handedness = srcAxes.determinant() * destAxes.determinant();
+	std::vector<Hypothesis> hypotheses;
+	for (unsigned int flips = 0; flips < 8; flips++)
 	{
-	    auto destVertex = dest.getVertex(i).coords;
-	    auto corDestVertex = destVertex - destAvg;
-	    Y(0, i) = corDestVertex.x();
-	    Y(1, i) = corDestVertex.y();
-	    Y(2, i) = corDestVertex.z();
+	    Eigen::Vector3d signs((flips & 1) ? -1 : 1, (flips & 2) ? -1 : 1, (flips & 4) ? -1 : 1);
+	    if(signs.prod() * handedness < 0)
+		continue;
+	    Hypothesis hypothesis;
+	    hypothesis.rotation = destAxes * signs.asDiagonal() * srcAxes.transpose();
+	    hypothesis.translation = m_destMoments.mean - hypothesis.rotation * m_sourceMoments.mean;
+	    hypothesis.error = 0;
+	    hypotheses.push_back(hypothesis);
 	}
-	// Compute eigenvectors and -values
-	Eigen::EigenSolver<Eigen::MatrixXd> eigenX(X * X.transpose(), true);
-	Eigen::EigenSolver<Eigen::MatrixXd> eigenY(Y * Y.transpose(), true);
 
-	// Sort by eigenvalue
-	struct EigenValVec
+	// Refine all remaining hypotheses, then drop the worse half. The winner has already been
+	// refined in the round that decided it.
+	auto byError = [](Hypothesis const& a, Hypothesis const& b)
 	{
-	    public:
-		Eigen::Vector3d vector;
-		double value;
+	    return a.error < b.error;
 	};
-	std::vector<EigenValVec> srcVectors, destVectors;
-	for (unsigned int i = 0; i < 3; i++)
+	while(true)
 	{
-	    Eigen::Vector3d curSrcVec = eigenX.pseudoEigenvectors().col(i);
-	    double curSrcVal = eigenX.pseudoEigenvalueMatrix()(i, i);
-	    srcVectors.push_back( {
-		curSrcVec, curSrcVal
-	    });
-	    Eigen::Vector3d curDestVec = eigenY.pseudoEigenvectors().col(i);
-	    double curDestVal = eigenY.pseudoEigenvalueMatrix()(i, i);
-	    destVectors.push_back( {
-		curDestVec, curDestVal
+	    parallelFor(0, hypotheses.size(), [&](unsigned int i)
+	    {
+		refineHypothesis(samples, dest, hypotheses[i]);
 	    });
+	    std::sort(hypotheses.begin(), hypotheses.end(), byError);
+	    if (m_pLog != nullptr)
+		m_pLog->info("Best of %u hypotheses: %f", static_cast<unsigned int>(hypotheses.size()), hypotheses[0].error);
+	    hypotheses.resize((hypotheses.size() + 1) / 2);
+	    if(hypotheses.size() == 1)
+		break;
 	}
-	struct SortByValue
-	{
-		bool operator()(EigenValVec i, EigenValVec j)
-		{
-		    return (i.value > j.value);
-		}
-	} comparator;
-	std::sort(srcVectors.begin(), srcVectors.end(), comparator);
-	std::sort(destVectors.begin(), destVectors.end(), comparator);
-
-	// Rotate source such that its chosen principal component matches the one of destination.
-	// Since we can't be sure that both coordinate systems have the same handedness we have to
-	// choose the minimal rotation, either the one onto the destination vector or the one onto
-	// the negative destination vector
-	auto srcEigenVec = srcVectors[m_index].vector.normalized();
-	auto destEigenVec = destVectors[m_index].vector.normalized();
-	Eigen::Vector3d vec;
-	auto theta1 = srcEigenVec.dot(destEigenVec);
-	if (theta1 < -1.0)
-	    theta1 = -1.0f;
-	else if (theta1 > 1.0)
-	    theta1 = 1.0f;
-	auto theta2 = (-srcEigenVec).dot(destEigenVec);
-	if (theta2 < -1.0)
-	    theta2 = -1.0f;
-	else if (theta2 > 1.0)
-	    theta2 = 1.0f;
-	auto angle1 = std::acos(theta1);
-	auto angle2 = std::acos(theta2);
-	if(angle1 < angle2)
-	    vec = srcEigenVec;
-	else
-	    vec = -srcEigenVec;
-	Eigen::Quaterniond R = Eigen::Quaterniond::FromTwoVectors(vec, destEigenVec);
-	auto t = destAvg - R * srcAvg;
-	// Apply values to all vertices of source
-	for (unsigned int i = 0; i < source.getAmountOfVertices(); i++)
-	{
-	    auto vertex = source.getVertex(i);
-	    auto coords = R * vertex.coords + t;
-	    // Should be okay to use the same R for normal since the inverse of a rotation matrix
-	    // is its transpose. Thus the correct matrix is transpose(transpose(R)) = R.
-	    auto normal = R * vertex.normal;
-	    source.setVertex(i, coords, normal);
-	}
-
-	// Increment index
-	m_index++;
 
-	return source.getAmountOfVertices();
+	Eigen::Isometry3d pose = Eigen::Isometry3d::Identity();
+	pose.linear() = hypotheses[0].rotation;
+	pose.translation() = hypotheses[0].translation;
+	return pose;
     }
 
-    void PCA_ICP::reset()
+    void PCA_ICP::refineHypothesis(Eigen::Matrix3Xd const& samples, AbstractMesh const& dest,
+	    Hypothesis& hypothesis) const
     {
-	m_index = 0;
-    }
+	unsigned int amount = samples.cols();
+	if(amount == 0)
+	    return;
+	Eigen::Matrix3Xd X(3, amount);
+	Eigen::Matrix3Xd Y(3, amount);
+	for (unsigned int iteration = 0; iteration <= m_hypothesisIterations; iteration++)
+	{
+	    X = (hypothesis.rotation * samples).colwise() + hypothesis.translation;
+	    hypothesis.error = 0;
+	    for (unsigned int i = 0; i < amount; i++)
+	    {
+		Y.col(i) = dest.getCoords(m_pNearestNeighbor->findNearest(X.col(i), dest));
+		hypothesis.error += (X.col(i) - Y.col(i)).squaredNorm();
+	    }
+	    hypothesis.error /= amount;
+	    // Last pass only measures the error
+	    if(iteration == m_hypothesisIterations)
+		break;
 
+	    // Point-to-point alignment of the current pairs
+	    Eigen::Vector3d xMean = X.rowwise().mean();
+	    Eigen::Vector3d yMean = Y.rowwise().mean();
+	    Eigen::Matrix3d H = (X.colwise() - xMean) * (Y.colwise() - yMean).transpose();
+	    Eigen::JacobiSVD<Eigen::Matrix3d> svd(H, Eigen::ComputeFullU | Eigen::ComputeFullV);
+	    Eigen::Matrix3d D = Eigen::Matrix3d::Identity();
+	    D(2, 2) = (svd.matrixV() * svd.matrixU().transpose()).determinant();
+	    Eigen::Matrix3d R = svd.matrixV() * D * svd.matrixU().transpose();
+	    hypothesis.rotation = R * hypothesis.rotation;
+	    hypothesis.translation = R * hypothesis.translation + yMean - R * xMean;
+	}
+    }
 }
@@ -0,0 +1,123 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Face Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include "SFA/ICP/PipelineICP.h"
+
+namespace sfa
+{
+    PipelineICP::PipelineICP(Matcher& matcher, Solver& solver, AbstractLog* pLog) : ICP(pLog),
+	    m_matcher(matcher), m_solver(solver)
+    {
+    }
+
+    PipelineICP::~PipelineICP()
+    {
+    }
+
+    unsigned int PipelineICP::calcNextStep(AbstractMesh& source, AbstractMesh const& dest)
+    {
+	// Temporaries of the previous step aren't needed anymore
+	m_arena.reset();
+	Correspondences& c = m_correspondences;
+	auto begin = Clock::now();
+	// Select points
+	if (m_pSelector != nullptr)
+	    m_pSelector->select(source, c);
+	else
+	{
+	    auto const& selection = selectIndices(source);
+	    c.resize(selection.size());
+	    std::copy(selection.begin(), selection.end(), c.source.begin());
+	}
+	std::fill(c.weight.begin(), c.weight.end(), 1);
+	lap(begin, m_stageTimes.selection);
+	// Find partners
+	m_matcher.match(source, dest, c, m_threads);
+	lap(begin, m_stageTimes.matching);
+	// Sort out unsuitable pairs
+	if (m_selectionMethod & PointSelection::NO_EDGES)
+	    m_edgeRejector.reject(source, dest, c);
+	for (auto pRejector : m_rejectors)
+	    pRejector->reject(source, dest, c);
+	lap(begin, m_stageTimes.rejection);
+	if (m_pWeighter != nullptr)
+	    m_pWeighter->weigh(source, dest, c);
+	lap(begin, m_stageTimes.weighting);
+	// Compute and apply transformation
+	Eigen::Isometry3d transformation = Eigen::Isometry3d::Identity();
+	bool solved = m_solver.solve(source, dest, c, m_arena, m_threads, transformation);
+	lap(begin, m_stageTimes.solving);
+	if (!solved)
+	{
+	    if (m_pLog != nullptr)
+		m_pLog->warning("Not enough point pairs to compute a transformation.");
+	    return c.size();
+	}
+	if (m_pApplier != nullptr)
+	    m_pApplier->apply(source, transformation);
+	else
+	{
+	    // Only the rigid applier is known to keep the selection caches valid
+	    unsigned int generation = source.getGeneration();
+	    m_rigidApplier.apply(source, transformation);
+	    keepSelectionCaches(source, generation);
+	}
+	lap(begin, m_stageTimes.applying);
+
+	return c.size();
+    }
+
+    void PipelineICP::setSelector(Selector* pSelector)
+    {
+	m_pSelector = pSelector;
+    }
+
+    void PipelineICP::addRejector(Rejector& rejector)
+    {
+	m_rejectors.push_back(&rejector);
+    }
+
+    void PipelineICP::clearRejectors()
+    {
+	m_rejectors.clear();
+    }
+
+    void PipelineICP::setWeighter(Weighter* pWeighter)
+    {
+	m_pWeighter = pWeighter;
+    }
+
+    void PipelineICP::setApplier(Applier* pApplier)
+    {
+	m_pApplier = pApplier;
+    }
+
+    Correspondences const& PipelineICP::getCorrespondences() const
+    {
+	return m_correspondences;
+    }
+
+    PipelineICP::StageTimes const& PipelineICP::getStageTimes() const
+    {
+	return m_stageTimes;
+    }
+
+    void PipelineICP::resetStageTimes()
+    {
+	m_stageTimes = StageTimes();
+    }
+
+    void PipelineICP::lap(Clock::time_point& begin, double& time)
+    {
+	auto end = Clock::now();
+	time += std::chrono::duration<double>(end - begin).count();
+	begin = end;
+    }
+}
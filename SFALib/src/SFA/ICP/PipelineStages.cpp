@@ -0,0 +1,142 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Face Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include "SFA/ICP/PipelineStages.h"
+
+namespace sfa
+{
+    Selector::~Selector()
+    {
+    }
+
+    Matcher::~Matcher()
+    {
+    }
+
+    Rejector::~Rejector()
+    {
+    }
+
+    Weighter::~Weighter()
+    {
+    }
+
+    Solver::~Solver()
+    {
+    }
+
+    Applier::~Applier()
+    {
+    }
+
+    NearestNeighborMatcher::NearestNeighborMatcher(NearestNeighbor& nn) : m_nearestNeighbor(nn)
+    {
+    }
+
+    void NearestNeighborMatcher::match(AbstractMesh const& source, AbstractMesh const& dest, Correspondences& c,
+	    unsigned int threads)
+    {
+	m_nearestNeighbor.findAllNearest(c.source, source, dest, c.dest, threads);
+	for (unsigned int i = 0; i < c.size(); i++)
+	    c.distance[i] = (dest.getCoords(c.dest[i]) - source.getCoords(c.source[i])).norm();
+    }
+
+    void EdgeRejector::reject(AbstractMesh const& /* source */, AbstractMesh const& dest, Correspondences& c)
+    {
+	c.removeIf([&](unsigned int i)
+	{
+	    return dest.isEdge(c.dest[i]);
+	});
+    }
+
+    DistanceRejector::DistanceRejector(double factor) : m_factor(factor)
+    {
+    }
+
+    void DistanceRejector::reject(AbstractMesh const& /* source */, AbstractMesh const& /* dest */,
+	    Correspondences& c)
+    {
+	if (c.size() == 0)
+	    return;
+	m_distances.assign(c.distance.begin(), c.distance.end());
+	auto median = m_distances.begin() + m_distances.size() / 2;
+	std::nth_element(m_distances.begin(), median, m_distances.end());
+	double threshold = m_factor * *median;
+	c.removeIf([&](unsigned int i)
+	{
+	    return c.distance[i] > threshold;
+	});
+    }
+
+    double DistanceRejector::getFactor() const
+    {
+	return m_factor;
+    }
+
+    void DistanceRejector::setFactor(double factor)
+    {
+	m_factor = factor;
+    }
+
+    void DistanceWeighter::weigh(AbstractMesh const& /* source */, AbstractMesh const& /* dest */,
+	    Correspondences& c)
+    {
+	double maxDistance = 0;
+	for (unsigned int i = 0; i < c.size(); i++)
+	    maxDistance = std::max(maxDistance, c.distance[i]);
+	if (maxDistance <= 0)
+	    return;
+	for (unsigned int i = 0; i < c.size(); i++)
+	    c.weight[i] *= 1 - c.distance[i] / maxDistance;
+    }
+
+    bool PointToPointSolver::solve(AbstractMesh const& source, AbstractMesh const& dest,
+	    Correspondences const& c, Arena& arena, unsigned int threads, Eigen::Isometry3d& transformation)
+    {
+	return solveFor(source, dest, c, arena, threads, transformation);
+    }
+
+    void PointToPointSolver::PairMoments::add(Eigen::Vector3d const& x, Eigen::Vector3d const& y, double w)
+    {
+	// Streaming update, numerically stable in contrast to summing up raw products
+	amount++;
+	weight += w;
+	Eigen::Vector3d srcDelta = x - srcMean;
+	srcMean += srcDelta * w / weight;
+	destMean += (y - destMean) * w / weight;
+	covariance += w * srcDelta * (y - destMean).transpose();
+    }
+
+    void PointToPointSolver::PairMoments::merge(PairMoments const& other)
+    {
+	if (other.amount == 0)
+	    return;
+	double total = weight + other.weight;
+	Eigen::Vector3d srcDelta = other.srcMean - srcMean;
+	Eigen::Vector3d destDelta = other.destMean - destMean;
+	double factor = weight * other.weight / total;
+	covariance += other.covariance + factor * srcDelta * destDelta.transpose();
+	srcMean += srcDelta * (other.weight / total);
+	destMean += destDelta * (other.weight / total);
+	amount += other.amount;
+	weight = total;
+    }
+
+    bool PointToPlaneSolver::solve(AbstractMesh const& source, AbstractMesh const& dest,
+	    Correspondences const& c, Arena& arena, unsigned int threads, Eigen::Isometry3d& transformation)
+    {
+	return solveFor(source, dest, c, arena, threads, transformation);
+    }
+
+    void RigidApplier::apply(AbstractMesh& source, Eigen::Isometry3d const& transformation)
+    {
+	source.applyTransform(transformation.linear(), transformation.translation());
+    }
+}
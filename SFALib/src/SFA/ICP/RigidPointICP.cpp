@@ -12,7 +12,8 @@
 
 namespace sfa
 {
-    RigidPointICP::RigidPointICP(NearestNeighbor& nn, AbstractLog* pLog) : ICP(pLog), m_nearestNeighbor(nn)
+    RigidPointICP::RigidPointICP(NearestNeighbor& nn, AbstractLog* pLog) : PipelineICP(m_matcher, m_solver, pLog),
+	    m_nearestNeighbor(nn), m_matcher(nn)
     {
     }
 
@@ -22,61 +23,9 @@ namespace sfa
 
     unsigned int RigidPointICP::calcNextStep(AbstractMesh& source, AbstractMesh const& dest)
     {
-	// Select points
-	auto sourcePoints = selectPoints(source);
-	auto nearestPoints = m_nearestNeighbor.getAllNearest(sourcePoints, source, dest);
-	// Sort out edge points on dest
-	if((m_selectionMethod & NO_EDGES))
-	{
-	    for (unsigned int i = 0; i < nearestPoints.size(); i++)
-	    {
-		if (nearestPoints[i].isEdge)
-		{
-		    nearestPoints.erase(nearestPoints.begin() + i);
-		    sourcePoints.erase(sourcePoints.begin() + i);
-		}
-	    }
-	}
-	// Calc averages
-	auto srcAvg = getAverage(sourcePoints);
-	auto destAvg = getAverage(nearestPoints);
-	auto amountOfPoints = sourcePoints.size();
-	Eigen::MatrixXd X(3, amountOfPoints);
-	Eigen::MatrixXd Y(3, amountOfPoints);
-	// Fill X and Y
-	for(unsigned int i = 0; i < amountOfPoints; i++)
-	{
-	    auto srcVertex = sourcePoints[i].coords;
-	    auto corSrcVertex = srcVertex - srcAvg;
-	    X(0,i) = corSrcVertex.x();
-	    X(1,i) = corSrcVertex.y();
-	    X(2,i) = corSrcVertex.z();
-	    auto destVertex = nearestPoints[i].coords;
-	    auto corDestVertex = destVertex - destAvg;
-	    Y(0, i) = corDestVertex.x();
-	    Y(1, i) = corDestVertex.y();
-	    Y(2, i) = corDestVertex.z();
-	}
-	// Calculate optimal rotation
-	auto XYT = X * Y.transpose();
-	Eigen::JacobiSVD<Eigen::MatrixXd> svd(XYT, Eigen::ComputeThinU | Eigen::ComputeThinV);
-	auto R = svd.matrixV() * svd.matrixU().transpose();
-	// Translation
-	auto t = destAvg - R * srcAvg;
-	// Apply values to all vertices of source
-	for (unsigned int i = 0; i < source.getAmountOfVertices(); i++)
-	{
-	    auto vertex = source.getVertex(i);
-	    auto coords = R * vertex.coords + t;
-	    // Should be okay to use the same R for normal since the inverse of a rotation matrix
-	    // is its transpose. Thus the correct matrix is transpose(transpose(R)) = R.
-	    auto normal = R * vertex.normal;
-	    source.setVertex(i, coords, normal);
-	}
+	unsigned int amount = PipelineICP::calcNextStep(source, dest);
 	// Clear nearest neighbor cache
 	m_nearestNeighbor.clearCache();
-
-	return sourcePoints.size();
+	return amount;
     }
 }
-
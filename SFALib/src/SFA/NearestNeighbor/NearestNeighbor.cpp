@@ -16,6 +16,17 @@ namespace sfa
     {
     }
 
+    unsigned int NearestNeighbor::findNearest(Eigen::Vector3d const& point, AbstractMesh const& dest) const
+    {
+	if(dest.getAmountOfVertices() <= 0)
+	    throw std::invalid_argument("Destination mesh doesn't have any vertices!");
+
+	// Scan the packed coordinates, the first of several equally near vertices wins
+	Eigen::Matrix3Xd::Index nearest = 0;
+	(dest.getPositions().colwise() - point).colwise().squaredNorm().minCoeff(&nearest);
+	return nearest;
+    }
+
     std::vector<Vertex> NearestNeighbor::getAllNearest(std::vector<Vertex> points, AbstractMesh const& source,
 	    AbstractMesh const& dest)
     {
@@ -27,24 +38,45 @@ namespace sfa
 	return vertices;
     }
 
+    void NearestNeighbor::getAllNearest(std::vector<uint32_t> const& indices, AbstractMesh const& source,
+	    AbstractMesh const& dest, std::vector<uint32_t>& nearest)
+    {
+	nearest.resize(indices.size());
+	for(unsigned int i = 0; i < indices.size(); i++)
+	    nearest[i] = getNearest(indices[i], source, dest);
+    }
+
+    void NearestNeighbor::findAllNearest(std::vector<uint32_t> const& indices, AbstractMesh const& source,
+	    AbstractMesh const& dest, std::vector<uint32_t>& nearest, unsigned int threads) const
+    {
+	nearest.resize(indices.size());
+	unsigned int amount = indices.size();
+	unsigned int chunks = (amount + ChunkSize - 1) / ChunkSize;
+	parallelFor(0, chunks, [&](unsigned int chunk)
+	{
+	    for(unsigned int i = chunk * ChunkSize; i < std::min(amount, (chunk + 1) * ChunkSize); i++)
+		nearest[i] = findNearest(source.getCoords(indices[i]), dest);
+	}, threads);
+    }
+
     double NearestNeighbor::computeError(AbstractMesh const& source, AbstractMesh const& dest)
     {
 	// Check if arguments are valid
 	if(source.getAmountOfVertices() <= 0 || dest.getAmountOfVertices() <= 0)
 	    throw std::invalid_argument("Source and/or destination mesh don't have any vertices!");
 
-	double error = 0;
 	unsigned int amount = source.getAmountOfVertices();
-	for(unsigned int i = 0; i < amount; i++)
+	auto sourcePositions = source.getPositions();
+	auto destPositions = dest.getPositions();
+	double error = parallelReduce(0, amount, ChunkSize, 0.0, [&](double& partial, unsigned int i)
 	{
-	    unsigned int nearestNum = getNearest(i, source, dest);
-	    auto sourceVert = source.getVertex(i);
-	    auto destVert = dest.getVertex(nearestNum);
-	    auto s = sourceVert.coords;
-	    auto d = destVert.coords;
-	    auto con = s - d;
-	    error += con.squaredNorm();
-	}
+	    Eigen::Vector3d s = sourcePositions.col(i);
+	    Eigen::Vector3d d = destPositions.col(findNearest(s, dest));
+	    partial += (s - d).squaredNorm();
+	}, [](double& result, double partial)
+	{
+	    result += partial;
+	});
 	error /= amount;
 	return error;
     }
@@ -56,31 +88,26 @@ namespace sfa
 	if(source.getAmountOfVertices() <= 0 || dest.getAmountOfVertices() <= 0)
 	    throw std::invalid_argument("Source and/or destination mesh don't have any vertices!");
 
-	double error = 0;
 	unsigned int amount = source.getAmountOfVertices();
-	if (numMatches != nullptr)
-	    (*numMatches) = 0;
-	for(unsigned int i = 0; i < amount; i++)
+	bool checkMatches = numMatches != nullptr || matches != nullptr;
+	std::vector<char> isMatching(checkMatches ? amount : 0, false);
+	auto sourcePositions = source.getPositions();
+	auto destPositions = dest.getPositions();
+	double error = parallelReduce(0, amount, ChunkSize, 0.0, [&](double& partial, unsigned int i)
 	{
-	    unsigned int targetIndex = pairs[i];
-
-	    if(numMatches != nullptr || matches != nullptr)
-	    {
-		// Get nearest neighbor and check if it matches with the one defined by pairs
-		unsigned int nearestNum = getNearest(i, source, dest);
-		bool isMatching = nearestNum == targetIndex;
-		if (matches != nullptr)
-		    matches->push_back(isMatching);
-		if(numMatches != nullptr && isMatching)
-		    (*numMatches)++;
-	    }
-	    auto sourceVert = source.getVertex(i);
-	    auto destVert = dest.getVertex(targetIndex);
-	    auto s = sourceVert.coords;
-	    auto d = destVert.coords;
-	    auto con = s - d;
-	    error += con.squaredNorm();
-	}
+	    Eigen::Vector3d s = sourcePositions.col(i);
+	    // Get nearest neighbor and check if it matches with the one defined by pairs
+	    if(checkMatches)
+		isMatching[i] = findNearest(s, dest) == pairs[i];
+	    partial += (s - destPositions.col(pairs[i])).squaredNorm();
+	}, [](double& result, double partial)
+	{
+	    result += partial;
+	});
+	if (numMatches != nullptr)
+	    (*numMatches) = std::count(isMatching.begin(), isMatching.end(), true);
+	if (matches != nullptr)
+	    matches->insert(matches->end(), isMatching.begin(), isMatching.end());
 	error /= amount;
 	return error;
     }
@@ -25,20 +25,7 @@ namespace sfa
 	    curIndex = cached->second;
 	else
 	{
-	    // Start out with "infinite" distance
-	    double minSqDist = std::numeric_limits<double>::max();
-	    Vertex sourceVertex = source.getVertex(n);
-	    // Iterate over all destination vertices
-	    for (unsigned int i = 0; i < dest.getAmountOfVertices(); i++)
-	    {
-		Vertex destVertex = dest.getVertex(i);
-		double sqDist = (sourceVertex.coords - destVertex.coords).squaredNorm();
-		if (sqDist < minSqDist)
-		{
-		    minSqDist = sqDist;
-		    curIndex = i;
-		}
-	    }
+	    curIndex = findNearest(source.getCoords(n), dest);
 	    m_cache.insert({n, curIndex});
 	}
 	return curIndex;
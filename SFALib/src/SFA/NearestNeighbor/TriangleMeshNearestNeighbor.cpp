@@ -0,0 +1,41 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Face Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include "SFA/NearestNeighbor/TriangleMeshNearestNeighbor.h"
+
+namespace sfa
+{
+    unsigned int TriangleMeshNearestNeighbor::getNearest(unsigned int n, AbstractMesh const& source,
+	    AbstractMesh const& dest)
+    {
+	// Check if arguments are valid
+	if (source.getAmountOfVertices() <= 0 || dest.getAmountOfVertices() <= 0)
+	    throw std::invalid_argument("Source and/or destination mesh don't have any vertices!");
+
+	return findNearest(source.getCoords(n), dynamic_cast<const TriangleMesh&>(dest));
+    }
+
+    unsigned int TriangleMeshNearestNeighbor::findNearest(Eigen::Vector3d const& point, AbstractMesh const& dest) const
+    {
+	return findNearest(point, dynamic_cast<const TriangleMesh&>(dest));
+    }
+
+    unsigned int TriangleMeshNearestNeighbor::findNearest(Eigen::Vector3d const& point, TriangleMesh const& dest) const
+    {
+	if (dest.getAmountOfVertices() <= 0)
+	    throw std::invalid_argument("Destination mesh doesn't have any vertices!");
+
+	return dest.findNearestVertex(point);
+    }
+
+    void TriangleMeshNearestNeighbor::clearCache()
+    {
+    }
+}
@@ -15,4 +15,39 @@ namespace sfa
     AbstractMesh::~AbstractMesh()
     {
     }
+
+    Eigen::Vector3d AbstractMesh::getCoords(unsigned int n) const
+    {
+	return getVertex(n).coords;
+    }
+
+    Eigen::Vector3d AbstractMesh::getNormal(unsigned int n) const
+    {
+	return getVertex(n).normal;
+    }
+
+    bool AbstractMesh::isEdge(unsigned int n) const
+    {
+	return getVertex(n).isEdge;
+    }
+
+    void AbstractMesh::applyTransform(Eigen::Matrix3d const& R, Eigen::Vector3d const& t)
+    {
+	for (unsigned int i = 0; i < getAmountOfVertices(); i++)
+	    setVertex(i, R * getCoords(i) + t, R * getNormal(i));
+    }
+
+    void AbstractMesh::setPositions(Eigen::Ref<Eigen::Matrix3Xd const> const& positions)
+    {
+	if (positions.cols() != getAmountOfVertices())
+	    throw std::invalid_argument("Amount of positions doesn't match the amount of vertices.");
+	for (unsigned int i = 0; i < getAmountOfVertices(); i++)
+	    setVertex(i, positions.col(i), getNormal(i));
+    }
+
+    unsigned int AbstractMesh::newGeneration()
+    {
+	static std::atomic<unsigned int> curGeneration(0);
+	return ++curGeneration;
+    }
 }
@@ -0,0 +1,176 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Face Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include "SFA/Utility/Adjacency.h"
+
+namespace sfa
+{
+    Adjacency::Range::Range() : m_first(nullptr), m_last(nullptr)
+    {
+    }
+
+    Adjacency::Range::Range(uint32_t const* first, uint32_t const* last) : m_first(first), m_last(last)
+    {
+    }
+
+    uint32_t const* Adjacency::Range::begin() const
+    {
+	return m_first;
+    }
+
+    uint32_t const* Adjacency::Range::end() const
+    {
+	return m_last;
+    }
+
+    unsigned int Adjacency::Range::size() const
+    {
+	return m_last - m_first;
+    }
+
+    bool Adjacency::Range::empty() const
+    {
+	return m_first == m_last;
+    }
+
+    uint32_t Adjacency::Range::operator[](unsigned int i) const
+    {
+	return m_first[i];
+    }
+
+    void Adjacency::buildFromTriangles(unsigned int amountOfNodes, std::vector<uint32_t> const& triangles,
+	    unsigned int threads)
+    {
+	// First pass counts two candidates per triangle corner, duplicates included
+	std::vector<uint32_t> candidateOffsets(amountOfNodes + 1, 0);
+	for (unsigned int i = 0; i + 2 < triangles.size(); i += 3)
+	{
+	    for (unsigned int j = 0; j < 3; j++)
+		candidateOffsets[triangles[i + j] + 1] += 2;
+	}
+	for (unsigned int n = 0; n < amountOfNodes; n++)
+	    candidateOffsets[n + 1] += candidateOffsets[n];
+	std::vector<uint32_t> candidates(candidateOffsets.back());
+	std::vector<uint32_t> cursor(candidateOffsets.begin(), candidateOffsets.end() - 1);
+	for (unsigned int i = 0; i + 2 < triangles.size(); i += 3)
+	{
+	    for (unsigned int j = 0; j < 3; j++)
+	    {
+		uint32_t node = triangles[i + j];
+		candidates[cursor[node]++] = triangles[i + (j + 1) % 3];
+		candidates[cursor[node]++] = triangles[i + (j + 2) % 3];
+	    }
+	}
+
+	// Sort and deduplicate every node's candidates, which yields the final degrees
+	std::vector<uint32_t> degrees(amountOfNodes);
+	unsigned int chunks = (amountOfNodes + ChunkSize - 1) / ChunkSize;
+	parallelFor(0, chunks, [&](unsigned int chunk)
+	{
+	    for (unsigned int n = chunk * ChunkSize; n < std::min(amountOfNodes, (chunk + 1) * ChunkSize); n++)
+	    {
+		auto first = candidates.begin() + candidateOffsets[n];
+		auto last = candidates.begin() + candidateOffsets[n + 1];
+		std::sort(first, last);
+		degrees[n] = std::unique(first, last) - first;
+	    }
+	}, threads);
+
+	// Second pass compacts the unique candidates
+	m_offsets.assign(amountOfNodes + 1, 0);
+	for (unsigned int n = 0; n < amountOfNodes; n++)
+	    m_offsets[n + 1] = m_offsets[n] + degrees[n];
+	m_indices.resize(m_offsets.back());
+	parallelFor(0, chunks, [&](unsigned int chunk)
+	{
+	    for (unsigned int n = chunk * ChunkSize; n < std::min(amountOfNodes, (chunk + 1) * ChunkSize); n++)
+	    {
+		std::copy(candidates.begin() + candidateOffsets[n],
+			candidates.begin() + candidateOffsets[n] + degrees[n], m_indices.begin() + m_offsets[n]);
+	    }
+	}, threads);
+    }
+
+    void Adjacency::buildFromGroups(unsigned int amountOfGroups, std::vector<uint32_t> const& groups)
+    {
+	m_offsets.assign(amountOfGroups + 1, 0);
+	for (auto group : groups)
+	{
+	    if (group < amountOfGroups)
+		m_offsets[group + 1]++;
+	}
+	for (unsigned int g = 0; g < amountOfGroups; g++)
+	    m_offsets[g + 1] += m_offsets[g];
+	m_indices.resize(m_offsets.back());
+	std::vector<uint32_t> cursor(m_offsets.begin(), m_offsets.end() - 1);
+	for (unsigned int i = 0; i < groups.size(); i++)
+	{
+	    if (groups[i] < amountOfGroups)
+		m_indices[cursor[groups[i]]++] = i;
+	}
+    }
+
+    void Adjacency::clear()
+    {
+	m_offsets.assign(1, 0);
+	m_indices.clear();
+    }
+
+    unsigned int Adjacency::getAmountOfNodes() const
+    {
+	return m_offsets.size() - 1;
+    }
+
+    unsigned int Adjacency::getDegree(unsigned int n) const
+    {
+	return m_offsets[n + 1] - m_offsets[n];
+    }
+
+    Adjacency::Range Adjacency::getNeighbors(unsigned int n) const
+    {
+	return Range(m_indices.data() + m_offsets[n], m_indices.data() + m_offsets[n + 1]);
+    }
+
+    void Adjacency::getRing(unsigned int n, unsigned int k, std::vector<uint32_t>& ring) const
+    {
+	ring.clear();
+	if (k == 0)
+	    return;
+	// Breadth first search, rings are small enough to check for duplicates linearly
+	auto visit = [&](Range range)
+	{
+	    for (auto node : range)
+	    {
+		if (node != n && std::find(ring.begin(), ring.end(), node) == ring.end())
+		    ring.push_back(node);
+	    }
+	};
+	visit(getNeighbors(n));
+	unsigned int frontier = 0;
+	for (unsigned int step = 1; step < k; step++)
+	{
+	    unsigned int size = ring.size();
+	    for (unsigned int i = frontier; i < size; i++)
+		visit(getNeighbors(ring[i]));
+	    frontier = size;
+	}
+	std::sort(ring.begin(), ring.end());
+    }
+
+    std::vector<uint32_t> const& Adjacency::getOffsets() const
+    {
+	return m_offsets;
+    }
+
+    std::vector<uint32_t> const& Adjacency::getIndices() const
+    {
+	return m_indices;
+    }
+}
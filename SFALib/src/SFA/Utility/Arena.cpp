@@ -0,0 +1,91 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Face Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include "SFA/Utility/Arena.h"
+
+namespace sfa
+{
+    Arena::Arena(std::size_t initialSize) : m_initialSize(initialSize)
+    {
+    }
+
+    Arena::Arena(Arena const& other) : m_initialSize(other.m_initialSize)
+    {
+    }
+
+    Arena& Arena::operator=(Arena const& /* other */)
+    {
+	return *this;
+    }
+
+    void* Arena::allocate(std::size_t bytes, std::size_t alignment)
+    {
+	if(alignment == 0 || (alignment & (alignment - 1)) != 0)
+	    throw std::invalid_argument("Alignment has to be a power of two!");
+
+	if(!m_blocks.empty())
+	{
+	    auto& block = m_blocks.back();
+	    std::uintptr_t address = reinterpret_cast<std::uintptr_t>(block.data.get()) + m_offset;
+	    std::size_t padding = (alignment - address % alignment) % alignment;
+	    if(m_offset + padding + bytes <= block.size)
+	    {
+		m_offset += padding + bytes;
+		m_used += padding + bytes;
+		return reinterpret_cast<void*>(address + padding);
+	    }
+	}
+	// Grow geometrically so the amount of blocks stays small until the next reset
+	std::size_t size = m_blocks.empty() ? m_initialSize : 2 * m_blocks.back().size;
+	addBlock(std::max(size, bytes + alignment));
+	return allocate(bytes, alignment);
+    }
+
+    void Arena::reset()
+    {
+	// Merge all blocks into one that fits everything needed since the last reset
+	if(m_blocks.size() > 1)
+	{
+	    std::size_t size = getCapacity();
+	    m_blocks.clear();
+	    addBlock(size);
+	}
+	m_offset = 0;
+	m_used = 0;
+    }
+
+    std::size_t Arena::getUsed() const
+    {
+	return m_used;
+    }
+
+    std::size_t Arena::getCapacity() const
+    {
+	std::size_t capacity = 0;
+	for(auto const& block : m_blocks)
+	    capacity += block.size;
+	return capacity;
+    }
+
+    unsigned int Arena::getHeapAllocations() const
+    {
+	return m_heapAllocations;
+    }
+
+    void Arena::addBlock(std::size_t size)
+    {
+	Block block;
+	block.data.reset(new char[size]);
+	block.size = size;
+	m_blocks.push_back(std::move(block));
+	m_offset = 0;
+	m_heapAllocations++;
+    }
+}
@@ -0,0 +1,116 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Face Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include "SFA/Utility/Boundary.h"
+
+namespace sfa
+{
+    void Boundary::build(unsigned int amountOfVertices, std::vector<uint32_t> const& triangles,
+	    unsigned int threads)
+    {
+	// Key every directed edge by its undirected vertex pair (lower index in the high bits),
+	// the lowest bit remembers whether the direction was flipped
+	unsigned int amountOfTriangles = triangles.size() / 3;
+	std::vector<uint64_t> keys(3 * amountOfTriangles);
+	unsigned int chunks = (amountOfTriangles + ChunkSize - 1) / ChunkSize;
+	parallelFor(0, chunks, [&](unsigned int chunk)
+	{
+	    for (unsigned int t = chunk * ChunkSize; t < std::min(amountOfTriangles, (chunk + 1) * ChunkSize); t++)
+	    {
+		for (unsigned int j = 0; j < 3; j++)
+		{
+		    uint64_t from = triangles[3 * t + j];
+		    uint64_t to = triangles[3 * t + (j + 1) % 3];
+		    if (from == to)
+			keys[3 * t + j] = UINT64_MAX;
+		    else if (from < to)
+			keys[3 * t + j] = from << 33 | to << 1;
+		    else
+			keys[3 * t + j] = to << 33 | from << 1 | 1;
+		}
+	    }
+	}, threads);
+	parallelSort(keys.begin(), keys.end(), std::less<uint64_t>(), ChunkSize, threads);
+
+	// Edges that appear only once are boundary edges
+	m_flags.assign(amountOfVertices, false);
+	std::vector<std::pair<uint32_t, uint32_t>> edges;
+	for (unsigned int i = 0; i < keys.size() && keys[i] != UINT64_MAX;)
+	{
+	    unsigned int j = i + 1;
+	    while (j < keys.size() && keys[j] >> 1 == keys[i] >> 1)
+		j++;
+	    if (j == i + 1)
+	    {
+		uint32_t lower = keys[i] >> 33;
+		uint32_t upper = (keys[i] >> 1) & 0xFFFFFFFF;
+		m_flags[lower] = true;
+		m_flags[upper] = true;
+		if (keys[i] & 1)
+		    edges.push_back(std::make_pair(upper, lower));
+		else
+		    edges.push_back(std::make_pair(lower, upper));
+	    }
+	    i = j;
+	}
+	m_amountOfEdges = edges.size();
+
+	// Chain boundary edges into loops, edges are sorted by their start vertex
+	std::sort(edges.begin(), edges.end());
+	std::vector<char> used(edges.size(), false);
+	m_loops.clear();
+	for (unsigned int e = 0; e < edges.size(); e++)
+	{
+	    if (used[e])
+		continue;
+	    std::vector<uint32_t> loop;
+	    unsigned int current = e;
+	    while (true)
+	    {
+		used[current] = true;
+		loop.push_back(edges[current].first);
+		uint32_t next = edges[current].second;
+		if (next == edges[e].first)
+		    break;
+		auto it = std::lower_bound(edges.begin(), edges.end(), std::make_pair(next, uint32_t(0)));
+		while (it != edges.end() && it->first == next && used[it - edges.begin()])
+		    ++it;
+		if (it == edges.end() || it->first != next)
+		{
+		    // Open chain
+		    loop.push_back(next);
+		    break;
+		}
+		current = it - edges.begin();
+	    }
+	    m_loops.push_back(std::move(loop));
+	}
+    }
+
+    bool Boundary::isBoundary(unsigned int n) const
+    {
+	return m_flags[n];
+    }
+
+    std::vector<char> const& Boundary::getFlags() const
+    {
+	return m_flags;
+    }
+
+    unsigned int Boundary::getAmountOfEdges() const
+    {
+	return m_amountOfEdges;
+    }
+
+    std::vector<std::vector<uint32_t>> const& Boundary::getLoops() const
+    {
+	return m_loops;
+    }
+}
@@ -0,0 +1,85 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Face Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include "SFA/Utility/MappedFile.h"
+
+#ifdef _WIN32
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace sfa
+{
+#ifdef _WIN32
+    MappedFile::MappedFile(std::string const& path)
+    {
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if (!file.is_open())
+	    throw std::runtime_error("Unable to open " + path);
+	m_size = file.tellg();
+	m_buffer.resize(m_size);
+	file.seekg(0);
+	if (!file.read(m_buffer.data(), m_size))
+	    throw std::runtime_error("Unable to read " + path);
+	m_pData = m_size > 0 ? m_buffer.data() : nullptr;
+    }
+
+    MappedFile::~MappedFile()
+    {
+    }
+#else
+    MappedFile::MappedFile(std::string const& path)
+    {
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+	    throw std::runtime_error("Unable to open " + path);
+	struct stat info;
+	if (fstat(fd, &info) != 0)
+	{
+	    close(fd);
+	    throw std::runtime_error("Unable to read " + path);
+	}
+	m_size = info.st_size;
+	// Empty files can't be mapped
+	if (m_size > 0)
+	{
+	    void* pMapping = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	    if (pMapping == MAP_FAILED)
+	    {
+		close(fd);
+		throw std::runtime_error("Unable to map " + path);
+	    }
+	    m_pData = static_cast<char const*>(pMapping);
+	}
+	// The mapping stays valid after closing the descriptor
+	close(fd);
+    }
+
+    MappedFile::~MappedFile()
+    {
+	if (m_pData != nullptr)
+	    munmap(const_cast<char*>(m_pData), m_size);
+    }
+#endif
+
+    char const* MappedFile::data() const
+    {
+	return m_pData;
+    }
+
+    std::size_t MappedFile::size() const
+    {
+	return m_size;
+    }
+}
@@ -0,0 +1,385 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Face Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include "SFA/Utility/OBJReader.h"
+
+namespace sfa
+{
+    namespace
+    {
+	// Powers of ten that are exactly representable as double
+	const double ExactPowersOf10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12,
+		1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+	enum class LineType
+	{
+	    Other, Position, Normal, Face
+	};
+
+	inline bool isBlank(char c)
+	{
+	    return c == ' ' || c == '\t' || c == '\r';
+	}
+
+	inline char const* skipBlanks(char const* cur, char const* end)
+	{
+	    while (cur < end && isBlank(*cur))
+		cur++;
+	    return cur;
+	}
+
+	inline char const* findLineEnd(char const* cur, char const* end)
+	{
+	    auto lineEnd = static_cast<char const*>(std::memchr(cur, '\n', end - cur));
+	    return lineEnd != nullptr ? lineEnd : end;
+	}
+
+	// Moves cur past the keyword of the line
+	inline LineType classify(char const*& cur, char const* lineEnd)
+	{
+	    cur = skipBlanks(cur, lineEnd);
+	    if (lineEnd - cur < 2)
+		return LineType::Other;
+	    if (cur[0] == 'v' && isBlank(cur[1]))
+	    {
+		cur += 1;
+		return LineType::Position;
+	    }
+	    if (cur[0] == 'f' && isBlank(cur[1]))
+	    {
+		cur += 1;
+		return LineType::Face;
+	    }
+	    if (lineEnd - cur >= 3 && cur[0] == 'v' && cur[1] == 'n' && isBlank(cur[2]))
+	    {
+		cur += 2;
+		return LineType::Normal;
+	    }
+	    return LineType::Other;
+	}
+
+	// Returns a pointer past the number or cur in case there is no number
+	char const* parseDouble(char const* cur, char const* end, double& value)
+	{
+	    char const* start = cur;
+	    bool negative = cur < end && *cur == '-';
+	    if (cur < end && (*cur == '-' || *cur == '+'))
+		cur++;
+	    // Up to 19 significant digits fit into the mantissa, further ones are dropped
+	    uint64_t mantissa = 0;
+	    int digits = 0;
+	    int exponent = 0;
+	    bool anyDigit = false;
+	    for (; cur < end && *cur >= '0' && *cur <= '9'; cur++)
+	    {
+		anyDigit = true;
+		if (digits < 19)
+		{
+		    mantissa = 10 * mantissa + (*cur - '0');
+		    if (mantissa != 0)
+			digits++;
+		}
+		else
+		    exponent++;
+	    }
+	    if (cur < end && *cur == '.')
+	    {
+		for (cur++; cur < end && *cur >= '0' && *cur <= '9'; cur++)
+		{
+		    anyDigit = true;
+		    if (digits < 19)
+		    {
+			mantissa = 10 * mantissa + (*cur - '0');
+			if (mantissa != 0)
+			    digits++;
+			exponent--;
+		    }
+		}
+	    }
+	    if (!anyDigit)
+		return start;
+	    if (cur < end && (*cur == 'e' || *cur == 'E'))
+	    {
+		char const* exponentBegin = cur + 1;
+		bool negativeExponent = exponentBegin < end && *exponentBegin == '-';
+		if (exponentBegin < end && (*exponentBegin == '-' || *exponentBegin == '+'))
+		    exponentBegin++;
+		int explicitExponent = 0;
+		char const* exponentEnd = exponentBegin;
+		for (; exponentEnd < end && *exponentEnd >= '0' && *exponentEnd <= '9'; exponentEnd++)
+		{
+		    if (explicitExponent < 10000)
+			explicitExponent = 10 * explicitExponent + (*exponentEnd - '0');
+		}
+		// An 'e' without digits isn't part of the number
+		if (exponentEnd != exponentBegin)
+		{
+		    exponent += negativeExponent ? -explicitExponent : explicitExponent;
+		    cur = exponentEnd;
+		}
+	    }
+	    // Both factors are exact in this range, thus the result is correctly rounded
+	    if (mantissa == 0)
+		value = 0;
+	    else if (mantissa < (uint64_t(1) << 53) && exponent >= -22 && exponent <= 22)
+		value = exponent < 0 ? mantissa / ExactPowersOf10[-exponent] : mantissa * ExactPowersOf10[exponent];
+	    else
+		value = static_cast<double>(mantissa * std::pow(10.0L, exponent));
+	    if (negative)
+		value = -value;
+	    return cur;
+	}
+
+	// Returns a pointer past the number or cur in case there is no number
+	char const* parseIndex(char const* cur, char const* end, long& value)
+	{
+	    char const* start = cur;
+	    bool negative = cur < end && *cur == '-';
+	    if (cur < end && (*cur == '-' || *cur == '+'))
+		cur++;
+	    char const* digitsBegin = cur;
+	    value = 0;
+	    for (; cur < end && *cur >= '0' && *cur <= '9'; cur++)
+	    {
+		if (value <= std::numeric_limits<uint32_t>::max())
+		    value = 10 * value + (*cur - '0');
+	    }
+	    if (cur == digitsBegin)
+		return start;
+	    if (negative)
+		value = -value;
+	    return cur;
+	}
+    }
+
+    const uint32_t OBJReader::NoNormal;
+    const std::size_t OBJReader::ChunkSize;
+
+    void OBJReader::read(std::string const& path, unsigned int threads)
+    {
+	MappedFile file(path);
+	parse(file.data(), file.data() + file.size(), ChunkSize, threads);
+    }
+
+    void OBJReader::parse(char const* begin, char const* end, std::size_t chunkSize, unsigned int threads)
+    {
+	// Split into chunks of whole lines
+	chunkSize = std::max<std::size_t>(chunkSize, 1);
+	std::vector<Chunk> chunks;
+	for (char const* cur = begin; cur < end;)
+	{
+	    Chunk chunk;
+	    chunk.begin = cur;
+	    chunk.end = static_cast<std::size_t>(end - cur) > chunkSize ? cur + chunkSize : end;
+	    if (chunk.end < end)
+	    {
+		char const* lineEnd = findLineEnd(chunk.end, end);
+		chunk.end = lineEnd < end ? lineEnd + 1 : end;
+	    }
+	    chunks.push_back(chunk);
+	    cur = chunk.end;
+	}
+
+	// Count elements and turn the amounts into offsets
+	parallelFor(0, chunks.size(), [&](unsigned int i)
+	{
+	    countChunk(chunks[i]);
+	}, threads);
+	Chunk total;
+	// Exclusive prefix sums: every chunk receives the total of all previous ones
+	for (auto& chunk : chunks)
+	{
+	    std::swap(chunk.firstLine, total.firstLine);
+	    total.firstLine += chunk.firstLine;
+	    std::swap(chunk.positions, total.positions);
+	    total.positions += chunk.positions;
+	    std::swap(chunk.normals, total.normals);
+	    total.normals += chunk.normals;
+	    std::swap(chunk.triangles, total.triangles);
+	    total.triangles += chunk.triangles;
+	}
+
+	// Parse straight into the output, memory is reused if there was a previous file
+	m_positions.resize(3 * total.positions);
+	m_normals.resize(3 * total.normals);
+	m_triangles.resize(3 * total.triangles);
+	m_triangleNormals.resize(3 * total.triangles);
+	parallelFor(0, chunks.size(), [&](unsigned int i)
+	{
+	    parseChunk(chunks[i]);
+	}, threads);
+    }
+
+    std::vector<double> const& OBJReader::getPositions() const
+    {
+	return m_positions;
+    }
+
+    std::vector<double> const& OBJReader::getNormals() const
+    {
+	return m_normals;
+    }
+
+    std::vector<uint32_t> const& OBJReader::getTriangles() const
+    {
+	return m_triangles;
+    }
+
+    std::vector<uint32_t> const& OBJReader::getTriangleNormals() const
+    {
+	return m_triangleNormals;
+    }
+
+    void OBJReader::countChunk(Chunk& chunk) const
+    {
+	chunk.firstLine = 0;
+	chunk.positions = 0;
+	chunk.normals = 0;
+	chunk.triangles = 0;
+	for (char const* cur = chunk.begin; cur < chunk.end;)
+	{
+	    char const* lineEnd = findLineEnd(cur, chunk.end);
+	    chunk.firstLine++;
+	    switch (classify(cur, lineEnd))
+	    {
+		case LineType::Position:
+		    chunk.positions++;
+		    break;
+		case LineType::Normal:
+		    chunk.normals++;
+		    break;
+		case LineType::Face:
+		{
+		    // Every corner is one token, a polygon is split into corners - 2 triangles
+		    unsigned int corners = 0;
+		    while (true)
+		    {
+			cur = skipBlanks(cur, lineEnd);
+			if (cur == lineEnd || *cur == '#')
+			    break;
+			corners++;
+			while (cur < lineEnd && !isBlank(*cur))
+			    cur++;
+		    }
+		    if (corners > 2)
+			chunk.triangles += corners - 2;
+		    break;
+		}
+		default:
+		    break;
+	    }
+	    cur = lineEnd + 1;
+	}
+    }
+
+    void OBJReader::parseChunk(Chunk const& chunk)
+    {
+	std::size_t positions = chunk.positions;
+	std::size_t normals = chunk.normals;
+	std::size_t triangles = chunk.triangles;
+	unsigned int line = chunk.firstLine;
+	for (char const* cur = chunk.begin; cur < chunk.end;)
+	{
+	    char const* lineEnd = findLineEnd(cur, chunk.end);
+	    line++;
+	    switch (classify(cur, lineEnd))
+	    {
+		case LineType::Position:
+		    parseVector(cur, lineEnd, &m_positions[3 * positions++], line);
+		    break;
+		case LineType::Normal:
+		    parseVector(cur, lineEnd, &m_normals[3 * normals++], line);
+		    break;
+		case LineType::Face:
+		{
+		    // Emit a fan while walking the corners, thus no polygon needs to be stored
+		    unsigned int corners = 0;
+		    uint32_t first = 0, firstNormal = NoNormal, previous = 0, previousNormal = NoNormal;
+		    while (true)
+		    {
+			cur = skipBlanks(cur, lineEnd);
+			if (cur == lineEnd || *cur == '#')
+			    break;
+			long index;
+			char const* next = parseIndex(cur, lineEnd, index);
+			if (next == cur)
+			    throw std::runtime_error("Invalid vertex index in line " + std::to_string(line));
+			uint32_t vertex = resolveIndex(index, positions, line);
+			uint32_t normal = NoNormal;
+			cur = next;
+			// Texture coordinates are skipped, the normal follows the second slash
+			if (cur < lineEnd && *cur == '/')
+			{
+			    cur = parseIndex(cur + 1, lineEnd, index);
+			    if (cur < lineEnd && *cur == '/')
+			    {
+				next = parseIndex(cur + 1, lineEnd, index);
+				if (next == cur + 1)
+				    throw std::runtime_error("Missing normal index in line "
+					    + std::to_string(line));
+				normal = resolveIndex(index, normals, line);
+				cur = next;
+			    }
+			}
+			if (cur < lineEnd && !isBlank(*cur) && *cur != '#')
+			    throw std::runtime_error("Invalid face corner in line " + std::to_string(line));
+			if (corners == 0)
+			{
+			    first = vertex;
+			    firstNormal = normal;
+			}
+			else if (corners >= 2)
+			{
+			    uint32_t* pTriangle = &m_triangles[3 * triangles];
+			    uint32_t* pNormals = &m_triangleNormals[3 * triangles];
+			    pTriangle[0] = first;
+			    pTriangle[1] = previous;
+			    pTriangle[2] = vertex;
+			    pNormals[0] = firstNormal;
+			    pNormals[1] = previousNormal;
+			    pNormals[2] = normal;
+			    triangles++;
+			}
+			previous = vertex;
+			previousNormal = normal;
+			corners++;
+		    }
+		    if (corners < 3)
+			throw std::runtime_error("Face with less than three vertices in line "
+				+ std::to_string(line));
+		    break;
+		}
+		default:
+		    break;
+	    }
+	    cur = lineEnd + 1;
+	}
+    }
+
+    void OBJReader::parseVector(char const* cur, char const* end, double* pOut, unsigned int line) const
+    {
+	for (unsigned int j = 0; j < 3; j++)
+	{
+	    cur = skipBlanks(cur, end);
+	    char const* next = parseDouble(cur, end, pOut[j]);
+	    if (next == cur)
+		throw std::runtime_error("Missing coordinate in line " + std::to_string(line));
+	    cur = next;
+	}
+    }
+
+    uint32_t OBJReader::resolveIndex(long index, std::size_t amount, unsigned int line) const
+    {
+	long resolved = index < 0 ? static_cast<long>(amount) + index : index - 1;
+	if (index == 0 || resolved < 0 || resolved >= static_cast<long>(amount))
+	    throw std::runtime_error("Index out of bounds in line " + std::to_string(line));
+	return resolved;
+    }
+}
@@ -0,0 +1,67 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Face Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include "SFA/Utility/Parallel.h"
+
+namespace sfa
+{
+    void IndexFunction::operator()(unsigned int index) const
+    {
+	m_pCall(m_pFunction, index);
+    }
+
+    void parallelFor(unsigned int begin, unsigned int end, IndexFunction body, unsigned int threads)
+    {
+	if(begin >= end)
+	    return;
+	auto& scheduler = Scheduler::getDefault();
+	if(threads == 0)
+	    threads = scheduler.getThreads();
+	threads = std::min(std::min(threads, scheduler.getThreads()), end - begin);
+
+	// Workers only capture a reference to this, which std::function stores without allocating
+	struct Loop
+	{
+	    public:
+		std::atomic<unsigned int> next;
+		unsigned int end;
+		IndexFunction const* pBody;
+		std::exception_ptr error;
+		std::mutex errorMutex;
+	} loop;
+	loop.next = begin;
+	loop.end = end;
+	loop.pBody = &body;
+	auto worker = [&loop]()
+	{
+	    for(unsigned int i = loop.next++; i < loop.end; i = loop.next++)
+	    {
+		try
+		{
+		    (*loop.pBody)(i);
+		}
+		catch(...)
+		{
+		    std::lock_guard<std::mutex> lock(loop.errorMutex);
+		    if(!loop.error)
+			loop.error = std::current_exception();
+		    loop.next = loop.end;
+		}
+	    }
+	};
+	TaskGroup group(scheduler);
+	for(unsigned int i = 1; i < threads; i++)
+	    group.run(worker);
+	worker();
+	group.wait();
+	if(loop.error)
+	    std::rethrow_exception(loop.error);
+    }
+}
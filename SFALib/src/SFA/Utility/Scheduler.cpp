@@ -0,0 +1,327 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Face Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include "SFA/Utility/Scheduler.h"
+
+namespace sfa
+{
+    namespace
+    {
+	// Scheduler the calling thread works for and the index of its queue
+	thread_local Scheduler const* t_pScheduler = nullptr;
+	thread_local unsigned int t_queueIndex = 0;
+    }
+
+    std::unique_ptr<Scheduler> Scheduler::s_pDefault;
+    std::once_flag Scheduler::s_defaultOnce;
+
+    Scheduler::Scheduler(unsigned int threads) : m_queued(0), m_stop(false)
+    {
+	if(threads == 0)
+	    threads = std::max(std::thread::hardware_concurrency(), 1u);
+	// The waiting thread does its share of the work, so one worker less is needed
+	for(unsigned int i = 0; i < threads; i++)
+	    m_queues.emplace_back(new Queue);
+	// Enough for every thread to wait for a few nested parallel loops at once
+	reserve(4 * threads);
+	m_workers.reserve(threads - 1);
+	for(unsigned int i = 1; i < threads; i++)
+	    m_workers.emplace_back(&Scheduler::work, this, i);
+    }
+
+    Scheduler::~Scheduler()
+    {
+	{
+	    std::lock_guard<std::mutex> lock(m_sleepMutex);
+	    m_stop = true;
+	}
+	m_wakeUp.notify_all();
+	for(auto& worker : m_workers)
+	    worker.join();
+    }
+
+    unsigned int Scheduler::getThreads() const
+    {
+	return m_queues.size();
+    }
+
+    void Scheduler::reserve(unsigned int tasks)
+    {
+	for(auto& pQueue : m_queues)
+	{
+	    std::lock_guard<std::mutex> lock(pQueue->mutex);
+	    pQueue->reserve(tasks);
+	}
+    }
+
+    Scheduler& Scheduler::getDefault()
+    {
+	std::call_once(s_defaultOnce, []()
+	{
+	    s_pDefault.reset(new Scheduler);
+	});
+	return *s_pDefault;
+    }
+
+    void Scheduler::setDefaultThreads(unsigned int threads)
+    {
+	bool created = false;
+	std::call_once(s_defaultOnce, [threads, &created]()
+	{
+	    s_pDefault.reset(new Scheduler(threads));
+	    created = true;
+	});
+	// Replacing it would invalidate references to the one in use
+	if(!created)
+	    throw std::logic_error("The default scheduler has already been created!");
+    }
+
+    void Scheduler::push(Task task)
+    {
+	// Count first, so the counter never drops below the actual amount of queued tasks
+	m_queued++;
+	auto& queue = *m_queues[getQueueIndex()];
+	{
+	    std::lock_guard<std::mutex> lock(queue.mutex);
+	    queue.pushBack(std::move(task));
+	}
+	// Taking the lock makes sure no thread is between checking for tasks and going to sleep
+	bool waiting;
+	{
+	    std::lock_guard<std::mutex> lock(m_sleepMutex);
+	    waiting = m_waitingThreads > 0;
+	}
+	m_wakeUp.notify_one();
+	if(waiting)
+	    m_groupDone.notify_all();
+    }
+
+    bool Scheduler::runOne()
+    {
+	Task task;
+	if(!pop(task))
+	    return false;
+	try
+	{
+	    task.function();
+	}
+	catch(...)
+	{
+	    std::lock_guard<std::mutex> lock(task.pGroup->m_errorMutex);
+	    if(!task.pGroup->m_error)
+		task.pGroup->m_error = std::current_exception();
+	}
+	// The group may be gone as soon as its last task is done, so only the scheduler is touched
+	if(--task.pGroup->m_pending == 0)
+	{
+	    {
+		std::lock_guard<std::mutex> lock(m_sleepMutex);
+	    }
+	    m_groupDone.notify_all();
+	}
+	return true;
+    }
+
+    bool Scheduler::pop(Task& task)
+    {
+	if(m_queued == 0)
+	    return false;
+	// Newest task of the own queue first, keeps caches warm
+	unsigned int own = getQueueIndex();
+	{
+	    auto& queue = *m_queues[own];
+	    std::lock_guard<std::mutex> lock(queue.mutex);
+	    if(queue.popBack(task))
+	    {
+		m_queued--;
+		return true;
+	    }
+	}
+	// Otherwise steal the oldest task of another queue
+	for(unsigned int i = 1; i < m_queues.size(); i++)
+	{
+	    auto& queue = *m_queues[(own + i) % m_queues.size()];
+	    std::lock_guard<std::mutex> lock(queue.mutex);
+	    if(queue.popFront(task))
+	    {
+		m_queued--;
+		return true;
+	    }
+	}
+	return false;
+    }
+
+    void Scheduler::waitFor(TaskGroup const& group)
+    {
+	std::unique_lock<std::mutex> lock(m_sleepMutex);
+	m_waitingThreads++;
+	m_groupDone.wait(lock, [this, &group]()
+	{
+	    return group.m_pending == 0 || m_queued > 0;
+	});
+	m_waitingThreads--;
+    }
+
+    void Scheduler::work(unsigned int index)
+    {
+	t_pScheduler = this;
+	t_queueIndex = index;
+	while(true)
+	{
+	    if(runOne())
+		continue;
+	    std::unique_lock<std::mutex> lock(m_sleepMutex);
+	    m_wakeUp.wait(lock, [this]()
+	    {
+		return m_stop || m_queued > 0;
+	    });
+	    if(m_stop)
+		return;
+	}
+    }
+
+    unsigned int Scheduler::getQueueIndex() const
+    {
+	return t_pScheduler == this ? t_queueIndex : 0;
+    }
+
+    void Scheduler::Queue::reserve(unsigned int capacity)
+    {
+	if(capacity <= tasks.size())
+	    return;
+	// Unroll the ring into a bigger buffer
+	std::vector<Task> grown(capacity);
+	for(unsigned int i = 0; i < size; i++)
+	    grown[i] = std::move(tasks[(first + i) % tasks.size()]);
+	tasks.swap(grown);
+	first = 0;
+    }
+
+    void Scheduler::Queue::pushBack(Task task)
+    {
+	if(size == tasks.size())
+	    reserve(std::max(2 * size, 16u));
+	tasks[(first + size) % tasks.size()] = std::move(task);
+	size++;
+    }
+
+    bool Scheduler::Queue::popBack(Task& task)
+    {
+	if(size == 0)
+	    return false;
+	auto& slot = tasks[(first + size - 1) % tasks.size()];
+	task = std::move(slot);
+	// Release whatever the function captured right away
+	slot.function = nullptr;
+	size--;
+	return true;
+    }
+
+    bool Scheduler::Queue::popFront(Task& task)
+    {
+	if(size == 0)
+	    return false;
+	auto& slot = tasks[first];
+	task = std::move(slot);
+	slot.function = nullptr;
+	first = (first + 1) % tasks.size();
+	size--;
+	return true;
+    }
+
+    TaskGroup::TaskGroup(Scheduler& scheduler) : m_scheduler(scheduler), m_pending(0)
+    {
+    }
+
+    TaskGroup::~TaskGroup()
+    {
+	join();
+    }
+
+    void TaskGroup::run(std::function<void()> task)
+    {
+	m_pending++;
+	Scheduler::Task item;
+	item.function = std::move(task);
+	item.pGroup = this;
+	m_scheduler.push(std::move(item));
+    }
+
+    void TaskGroup::wait()
+    {
+	join();
+	std::exception_ptr error;
+	{
+	    std::lock_guard<std::mutex> lock(m_errorMutex);
+	    std::swap(error, m_error);
+	}
+	if(error)
+	    std::rethrow_exception(error);
+    }
+
+    void TaskGroup::join()
+    {
+	while(m_pending > 0)
+	{
+	    // Help out instead of blocking, this is what makes nested parallelism work
+	    if(!m_scheduler.runOne())
+		m_scheduler.waitFor(*this);
+	}
+    }
+
+    unsigned int TaskGraph::add(std::function<void()> task, std::vector<unsigned int> const& dependencies)
+    {
+	unsigned int id = m_nodes.size();
+	for(auto dependency : dependencies)
+	{
+	    if(dependency >= id)
+		throw std::out_of_range("Tasks may only depend on previously added tasks!");
+	}
+	Node node;
+	node.task = std::move(task);
+	node.dependencies = dependencies.size();
+	m_nodes.push_back(std::move(node));
+	for(auto dependency : dependencies)
+	    m_nodes[dependency].successors.push_back(id);
+	return id;
+    }
+
+    unsigned int TaskGraph::size() const
+    {
+	return m_nodes.size();
+    }
+
+    void TaskGraph::run(Scheduler& scheduler)
+    {
+	std::unique_ptr<std::atomic<unsigned int>[]> remaining(new std::atomic<unsigned int>[m_nodes.size()]);
+	for(unsigned int i = 0; i < m_nodes.size(); i++)
+	    remaining[i] = m_nodes[i].dependencies;
+	TaskGroup group(scheduler);
+	std::function<void(unsigned int)> schedule = [&](unsigned int id)
+	{
+	    group.run([&, id]()
+	    {
+		m_nodes[id].task();
+		// Only reached if the task didn't throw
+		for(auto successor : m_nodes[id].successors)
+		{
+		    if(--remaining[successor] == 0)
+			schedule(successor);
+		}
+	    });
+	};
+	for(unsigned int i = 0; i < m_nodes.size(); i++)
+	{
+	    if(m_nodes[i].dependencies == 0)
+		schedule(i);
+	}
+	group.wait();
+    }
+}
@@ -0,0 +1,403 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Face Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include "SFA/Utility/TriangleMesh.h"
+
+namespace sfa
+{
+    const uint32_t TriangleMesh::Removed;
+
+    TriangleMesh::TriangleMesh(std::string const& path)
+    {
+	OBJReader reader;
+	reader.read(path);
+	analyzeMesh(reader.getPositions(), reader.getNormals(), reader.getTriangles(), reader.getTriangleNormals());
+
+	std::random_device rd;
+	m_random.seed(rd());
+    }
+
+    TriangleMesh::TriangleMesh(OBJReader const& reader)
+    {
+	analyzeMesh(reader.getPositions(), reader.getNormals(), reader.getTriangles(), reader.getTriangleNormals());
+
+	std::random_device rd;
+	m_random.seed(rd());
+    }
+
+    TriangleMesh::TriangleMesh(std::vector<double> const& positions, std::vector<uint32_t> const& triangles)
+    {
+	analyzeMesh(positions, {}, triangles, {});
+
+	std::random_device rd;
+	m_random.seed(rd());
+    }
+
+    unsigned int TriangleMesh::getID() const
+    {
+	static unsigned int curMaxId = 0;
+	return curMaxId++;
+    }
+
+    Vertex TriangleMesh::getVertex(unsigned int n) const
+    {
+	checkBounds(n);
+	Vertex vertex;
+	vertex.id = n;
+	vertex.coords = getPositions().col(n);
+	vertex.normal = getNormals().col(n);
+	vertex.neighbors = m_topology->neighbors.getNeighbors(n);
+	vertex.baseVertices = m_topology->baseVertices.getNeighbors(n);
+	vertex.isEdge = m_topology->boundary.isBoundary(n);
+	return vertex;
+    }
+
+    Eigen::Vector3d TriangleMesh::getCoords(unsigned int n) const
+    {
+	checkBounds(n);
+	return Eigen::Map<Eigen::Vector3d const>(&m_positions[3 * n]);
+    }
+
+    Eigen::Vector3d TriangleMesh::getNormal(unsigned int n) const
+    {
+	checkBounds(n);
+	return Eigen::Map<Eigen::Vector3d const>(&m_normals[3 * n]);
+    }
+
+    bool TriangleMesh::isEdge(unsigned int n) const
+    {
+	checkBounds(n);
+	return m_topology->boundary.isBoundary(n);
+    }
+
+    Eigen::Map<Eigen::Matrix3Xd const> TriangleMesh::getPositions() const
+    {
+	return Eigen::Map<Eigen::Matrix3Xd const>(m_positions.data(), 3, getAmountOfVertices());
+    }
+
+    Eigen::Map<Eigen::Matrix3Xd const> TriangleMesh::getNormals() const
+    {
+	return Eigen::Map<Eigen::Matrix3Xd const>(m_normals.data(), 3, getAmountOfVertices());
+    }
+
+    Adjacency const& TriangleMesh::getAdjacency() const
+    {
+	return m_topology->neighbors;
+    }
+
+    Adjacency const& TriangleMesh::getBaseVertices() const
+    {
+	return m_topology->baseVertices;
+    }
+
+    std::vector<uint32_t> const& TriangleMesh::getTriangles() const
+    {
+	return m_topology->triangles;
+    }
+
+    std::vector<std::vector<uint32_t>> const& TriangleMesh::getBoundaryLoops() const
+    {
+	return m_topology->boundary.getLoops();
+    }
+
+    unsigned int TriangleMesh::findNearestVertex(Eigen::Vector3d const& point) const
+    {
+	return m_vertexTree->findNearest(toLocalFrame(point));
+    }
+
+    Eigen::Isometry3d TriangleMesh::getPose() const
+    {
+	Eigen::Isometry3d pose = Eigen::Isometry3d::Identity();
+	pose.linear() = m_poseRotation;
+	pose.translation() = m_poseTranslation;
+	return pose;
+    }
+
+    Eigen::Vector3d TriangleMesh::toLocalFrame(Eigen::Vector3d const& coords) const
+    {
+	return m_poseRotation.transpose() * (coords - m_poseTranslation);
+    }
+
+    void TriangleMesh::setVertex(unsigned int n, Eigen::Vector3d const& coords, Eigen::Vector3d const& normal)
+    {
+	checkBounds(n);
+	Eigen::Map<Eigen::Vector3d> oldCoords(&m_positions[3 * n]);
+	Eigen::Map<Eigen::Vector3d> oldNormal(&m_normals[3 * n]);
+	oldCoords = coords;
+	oldNormal = normal;
+	m_generation = newGeneration();
+	m_shapeGeneration = m_generation;
+    }
+
+    void TriangleMesh::applyTransform(Eigen::Matrix3d const& R, Eigen::Vector3d const& t)
+    {
+	unsigned int amount = getAmountOfVertices();
+	Eigen::Map<Eigen::Matrix3Xd> positions(m_positions.data(), 3, amount);
+	Eigen::Map<Eigen::Matrix3Xd> normals(m_normals.data(), 3, amount);
+	unsigned int chunkSize = 4096;
+	unsigned int chunks = (amount + chunkSize - 1) / chunkSize;
+	parallelFor(0, chunks, [&](unsigned int chunk)
+	{
+	    for (unsigned int i = chunk * chunkSize; i < std::min(amount, (chunk + 1) * chunkSize); i++)
+	    {
+		positions.col(i) = R * positions.col(i) + t;
+		normals.col(i) = R * normals.col(i);
+	    }
+	});
+	m_generation = newGeneration();
+
+	// The local frame stays, thus topology and vertex tree remain valid
+	m_poseTranslation = R * m_poseTranslation + t;
+	m_poseRotation = R * m_poseRotation;
+    }
+
+    void TriangleMesh::setPositions(Eigen::Ref<Eigen::Matrix3Xd const> const& positions)
+    {
+	if (positions.cols() != getAmountOfVertices())
+	    throw std::invalid_argument("Amount of positions doesn't match the amount of vertices.");
+	Eigen::Map<Eigen::Matrix3Xd>(m_positions.data(), 3, getAmountOfVertices()) = positions;
+	m_generation = newGeneration();
+	m_shapeGeneration = m_generation;
+	rebuildVertexTree();
+    }
+
+    unsigned int TriangleMesh::getAmountOfVertices() const
+    {
+	return m_positions.size() / 3;
+    }
+
+    Eigen::Vector3d TriangleMesh::getAverage() const
+    {
+	return getPositions().rowwise().mean();
+    }
+
+    unsigned int TriangleMesh::getGeneration() const
+    {
+	return m_generation;
+    }
+
+    unsigned int TriangleMesh::getShapeGeneration() const
+    {
+	return m_shapeGeneration;
+    }
+
+    void TriangleMesh::addNoise()
+    {
+	// Initialize random number generator
+	std::uniform_real_distribution<float> rand_float(-0.05f, 0.05f);
+	// Iterate all vertices and translate them randomly along their normal
+	Eigen::Matrix3Xd positions = getPositions();
+	for(unsigned int i = 0; i < getAmountOfVertices(); i++)
+	    positions.col(i) += rand_float(m_random) * getNormals().col(i);
+	setPositions(positions);
+    }
+
+    void TriangleMesh::addHole()
+    {
+	addHoles(1);
+    }
+
+    void TriangleMesh::addHoles(unsigned int amount, unsigned int radius)
+    {
+	unsigned int vertices = getAmountOfVertices();
+	if (vertices == 0)
+	    return;
+	// Initialize random number generator
+	std::uniform_int_distribution<uint32_t> rand_uint_0_vertices(0, vertices - 1);
+	std::vector<char> removed(vertices, false);
+	unsigned int amountRemoved = 0;
+	std::vector<uint32_t> ring;
+	for (unsigned int i = 0; i < amount && amountRemoved < vertices; i++)
+	{
+	    // Generate index of a vertex that still exists
+	    auto index = rand_uint_0_vertices(m_random);
+	    while (removed[index])
+		index = rand_uint_0_vertices(m_random);
+	    m_topology->neighbors.getRing(index, radius, ring);
+	    ring.push_back(index);
+	    for (auto n : ring)
+	    {
+		if (!removed[n])
+		    amountRemoved++;
+		removed[n] = true;
+	    }
+	}
+	removeVertices(removed);
+    }
+
+    double TriangleMesh::rotateRandom(double maxAngle, double minAngle)
+    {
+	std::uniform_real_distribution<double> rand_double_min_max(minAngle, maxAngle);
+	double angle = rand_double_min_max(m_random);
+	std::uniform_int_distribution<short> rand_bool(0, 1);
+	bool flipSign = rand_bool(m_random);
+	if(flipSign)
+	    angle = -angle;
+	Eigen::Vector3d axis = Eigen::Vector3d::Random();
+	axis.normalize();
+	Eigen::AngleAxis<double> aa(angle, axis);
+	applyTransform(aa.toRotationMatrix(), Eigen::Vector3d::Zero());
+	return angle;
+    }
+
+    double TriangleMesh::translateRandom(double maxTranslation, double minTranslation)
+    {
+	std::uniform_real_distribution<double> rand_double_min_max(minTranslation, maxTranslation);
+	double translation = rand_double_min_max(m_random);
+	Eigen::Vector3d translationVec = Eigen::Vector3d::Random();
+	translationVec.normalize();
+	translationVec *= translation;
+	applyTransform(Eigen::Matrix3d::Identity(), translationVec);
+	return translation;
+    }
+
+    void TriangleMesh::saveSnapshot(Snapshot& snapshot) const
+    {
+	// Assigning to the existing buffers reuses their memory
+	snapshot.m_positions.assign(m_positions.begin(), m_positions.end());
+	snapshot.m_normals.assign(m_normals.begin(), m_normals.end());
+	snapshot.m_vertexTree = m_vertexTree;
+	snapshot.m_poseRotation = m_poseRotation;
+	snapshot.m_poseTranslation = m_poseTranslation;
+	snapshot.m_random = m_random;
+	snapshot.m_generation = m_generation;
+	snapshot.m_shapeGeneration = m_shapeGeneration;
+    }
+
+    void TriangleMesh::restoreSnapshot(Snapshot const& snapshot)
+    {
+	if (snapshot.m_positions.size() != m_positions.size())
+	    throw std::invalid_argument("Snapshot doesn't match the topology of the mesh.");
+	std::copy(snapshot.m_positions.begin(), snapshot.m_positions.end(), m_positions.begin());
+	std::copy(snapshot.m_normals.begin(), snapshot.m_normals.end(), m_normals.begin());
+	m_vertexTree = snapshot.m_vertexTree;
+	m_poseRotation = snapshot.m_poseRotation;
+	m_poseTranslation = snapshot.m_poseTranslation;
+	m_random = snapshot.m_random;
+	m_generation = snapshot.m_generation;
+	m_shapeGeneration = snapshot.m_shapeGeneration;
+    }
+
+    void TriangleMesh::analyzeMesh(std::vector<double> const& positions, std::vector<double> const& normals,
+	    std::vector<uint32_t> const& triangles, std::vector<uint32_t> const& triangleNormals)
+    {
+	m_generation = newGeneration();
+	m_shapeGeneration = m_generation;
+	// Merge vertices with the same coordinates
+	VertexWelder welder;
+	welder.weld(positions, 0.0001);
+	unsigned int amount = welder.getAmountOfVertices();
+	auto topology = std::make_shared<Topology>();
+	topology->baseIndex2MeshIndex = welder.getMapping();
+	topology->triangles.resize(triangles.size());
+	for (unsigned int i = 0; i < triangles.size(); i++)
+	    topology->triangles[i] = topology->baseIndex2MeshIndex[triangles[i]];
+
+	// Take coordinates from the first input vertex and average the normals of all corners
+	m_positions.resize(3 * amount);
+	m_normals.assign(3 * amount, 0);
+	for (unsigned int i = 0; i < amount; i++)
+	{
+	    for (unsigned int j = 0; j < 3; j++)
+		m_positions[3 * i + j] = positions[3 * welder.getRepresentatives()[i] + j];
+	}
+	Eigen::Map<Eigen::Matrix3Xd const> inputPositions(positions.data(), 3, positions.size() / 3);
+	Eigen::Map<Eigen::Matrix3Xd const> inputNormals(normals.data(), 3, normals.size() / 3);
+	Eigen::Map<Eigen::Matrix3Xd> vertexNormals(m_normals.data(), 3, amount);
+	for (unsigned int t = 0; t < triangles.size() / 3; t++)
+	{
+	    // Corners without a normal use the face normal weighted by area
+	    Eigen::Vector3d a = inputPositions.col(triangles[3 * t]);
+	    Eigen::Vector3d faceNormal = (inputPositions.col(triangles[3 * t + 1]) - a).cross(
+		    inputPositions.col(triangles[3 * t + 2]) - a);
+	    for (unsigned int c = 3 * t; c < 3 * t + 3; c++)
+	    {
+		if (triangleNormals.empty() || triangleNormals[c] == OBJReader::NoNormal)
+		    vertexNormals.col(topology->triangles[c]) += faceNormal;
+		else
+		    vertexNormals.col(topology->triangles[c]) += inputNormals.col(triangleNormals[c]);
+	    }
+	}
+	for (unsigned int i = 0; i < amount; i++)
+	    vertexNormals.col(i).normalize();
+	m_topology = topology;
+
+	// Drop vertices without faces, this also computes neighbors and boundary
+	std::vector<char> unused(amount, true);
+	for (auto n : topology->triangles)
+	    unused[n] = false;
+	removeVertices(unused);
+    }
+
+    void TriangleMesh::removeVertices(std::vector<char> const& removed)
+    {
+	// Compact indices once, vertices keep their order
+	unsigned int oldAmount = getAmountOfVertices();
+	std::vector<uint32_t> newIndex(oldAmount);
+	unsigned int amount = 0;
+	for (unsigned int n = 0; n < oldAmount; n++)
+	{
+	    newIndex[n] = removed[n] ? Removed : amount;
+	    if (removed[n])
+		continue;
+	    for (unsigned int j = 0; j < 3; j++)
+	    {
+		m_positions[3 * amount + j] = m_positions[3 * n + j];
+		m_normals[3 * amount + j] = m_normals[3 * n + j];
+	    }
+	    amount++;
+	}
+	m_positions.resize(3 * amount);
+	m_normals.resize(3 * amount);
+
+	// Copies of this mesh may still use the old topology, thus build a new one
+	auto topology = std::make_shared<Topology>();
+	topology->baseIndex2MeshIndex.reserve(m_topology->baseIndex2MeshIndex.size());
+	for (auto n : m_topology->baseIndex2MeshIndex)
+	    topology->baseIndex2MeshIndex.push_back(n == Removed ? Removed : newIndex[n]);
+	auto const& oldTriangles = m_topology->triangles;
+	topology->triangles.reserve(oldTriangles.size());
+	for (unsigned int t = 0; t < oldTriangles.size(); t += 3)
+	{
+	    if (removed[oldTriangles[t]] || removed[oldTriangles[t + 1]] || removed[oldTriangles[t + 2]])
+		continue;
+	    for (unsigned int j = 0; j < 3; j++)
+		topology->triangles.push_back(newIndex[oldTriangles[t + j]]);
+	}
+	topology->baseVertices.buildFromGroups(amount, topology->baseIndex2MeshIndex);
+	topology->neighbors.buildFromTriangles(amount, topology->triangles);
+	topology->boundary.build(amount, topology->triangles);
+	m_topology = topology;
+	m_generation = newGeneration();
+	m_shapeGeneration = m_generation;
+
+	rebuildVertexTree();
+    }
+
+    void TriangleMesh::rebuildVertexTree()
+    {
+	// Copies of this mesh may still use the old tree, thus build a new one
+	auto tree = std::make_shared<KdTree<3>>();
+	tree->build(getPositions());
+	m_vertexTree = tree;
+	m_poseRotation.setIdentity();
+	m_poseTranslation.setZero();
+    }
+
+    void TriangleMesh::checkBounds(unsigned int n) const
+    {
+	if (n >= getAmountOfVertices())
+	{
+	    std::stringstream msg;
+	    msg << "Vertex number out of bounds: " << n;
+	    throw std::out_of_range(msg.str());
+	}
+    }
+}
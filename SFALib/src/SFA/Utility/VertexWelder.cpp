@@ -0,0 +1,105 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Face Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include "SFA/Utility/VertexWelder.h"
+
+namespace sfa
+{
+    void VertexWelder::weld(std::vector<double> const& positions, double tolerance, unsigned int threads)
+    {
+	if (!(tolerance > 0))
+	    throw std::invalid_argument("Welding tolerance has to be positive.");
+
+	unsigned int amount = positions.size() / 3;
+	unsigned int chunks = (amount + ChunkSize - 1) / ChunkSize;
+
+	// Quantise all vertices and sort them by cell
+	std::vector<Cell> cells(amount);
+	std::vector<uint32_t> order(amount);
+	parallelFor(0, chunks, [&](unsigned int chunk)
+	{
+	    for (unsigned int i = chunk * ChunkSize; i < std::min(amount, (chunk + 1) * ChunkSize); i++)
+	    {
+		for (unsigned int j = 0; j < 3; j++)
+		    cells[i][j] = static_cast<int64_t>(std::floor(positions[3 * i + j] / tolerance));
+		order[i] = i;
+	    }
+	}, threads);
+	parallelSort(order.begin(), order.end(), [&](uint32_t a, uint32_t b)
+	{
+	    return cells[a] < cells[b] || (cells[a] == cells[b] && a < b);
+	}, ChunkSize, threads);
+
+	// Find the lowest index within the tolerance for every vertex
+	std::vector<uint32_t> lowest(amount);
+	double squaredTolerance = tolerance * tolerance;
+	parallelFor(0, chunks, [&](unsigned int chunk)
+	{
+	    for (unsigned int i = chunk * ChunkSize; i < std::min(amount, (chunk + 1) * ChunkSize); i++)
+	    {
+		lowest[i] = i;
+		Cell cell;
+		for (int dx = -1; dx <= 1; dx++)
+		{
+		    for (int dy = -1; dy <= 1; dy++)
+		    {
+			for (int dz = -1; dz <= 1; dz++)
+			{
+			    cell = {{cells[i][0] + dx, cells[i][1] + dy, cells[i][2] + dz}};
+			    // Members of a cell are sorted by index, thus stop at the current best
+			    auto it = std::lower_bound(order.begin(), order.end(), cell,
+				    [&](uint32_t a, Cell const& c) { return cells[a] < c; });
+			    for (; it != order.end() && *it < lowest[i] && cells[*it] == cell; ++it)
+			    {
+				double squaredDist = 0;
+				for (unsigned int j = 0; j < 3; j++)
+				{
+				    double diff = positions[3 * *it + j] - positions[3 * i + j];
+				    squaredDist += diff * diff;
+				}
+				if (squaredDist <= squaredTolerance)
+				    lowest[i] = *it;
+			    }
+			}
+		    }
+		}
+	    }
+	}, threads);
+
+	// Resolve chains in index order, every vertex joins the welded vertex of its lowest match
+	m_mapping.resize(amount);
+	m_representatives.clear();
+	for (unsigned int i = 0; i < amount; i++)
+	{
+	    if (lowest[i] == i)
+	    {
+		m_mapping[i] = m_representatives.size();
+		m_representatives.push_back(i);
+	    }
+	    else
+		m_mapping[i] = m_mapping[lowest[i]];
+	}
+    }
+
+    unsigned int VertexWelder::getAmountOfVertices() const
+    {
+	return m_representatives.size();
+    }
+
+    std::vector<uint32_t> const& VertexWelder::getMapping() const
+    {
+	return m_mapping;
+    }
+
+    std::vector<uint32_t> const& VertexWelder::getRepresentatives() const
+    {
+	return m_representatives;
+    }
+}
@@ -18,6 +18,7 @@
 #include <DBGL/System/Log/Log.h>
 #include "StatRunner.h"
 #include "SFA/Utility/Model.h"
+#include "SFA/Utility/TriangleMesh.h"
 #include "SFA/NearestNeighbor/NearestNeighbor.h"
 #include "SFA/ICP/ICP.h"
 #include "SFA/ICP/PCA_ICP.h"
@@ -28,12 +29,14 @@ namespace sfa
     {
 	public:
 	    virtual void run(Model& src, Model& dest, NearestNeighbor& nn, ICP& icp, dbgl::Properties& props);
+	    virtual void run(TriangleMesh& src, TriangleMesh& dest, NearestNeighbor& nn, ICP& icp, dbgl::Properties& props);
 	    virtual void printResults(dbgl::Properties& props);
 	    virtual void writeResults(dbgl::Properties& props);
 
 	private:
-	    void testWithModel(Model& src, Model& dest, NearestNeighbor& nn);
-	    void initCorrectPairs(Model& src, Model& dest, NearestNeighbor& nn, ICP& icp);
+	    template<class MeshType> void runWith(MeshType& src, MeshType& dest, NearestNeighbor& nn, ICP& icp, dbgl::Properties& props);
+	    template<class MeshType> void testWithModel(MeshType& src, MeshType& dest, NearestNeighbor& nn);
+	    template<class MeshType> void initCorrectPairs(MeshType& src, MeshType& dest, NearestNeighbor& nn, ICP& icp);
 
 	    const std::string Prop_RandCycles = "PCAMatching_RandCycles";
 	    const std::string Prop_ToRot = "PCAMatching_ToRot";
@@ -19,6 +19,7 @@
 #include <DBGL/System/Log/Log.h>
 #include "StatRunner.h"
 #include "SFA/Utility/Model.h"
+#include "SFA/Utility/TriangleMesh.h"
 #include "SFA/NearestNeighbor/NearestNeighbor.h"
 #include "SFA/ICP/ICP.h"
 #include "SFA/ICP/PCA_ICP.h"
@@ -33,10 +34,12 @@ namespace sfa
     {
 	public:
 	    virtual void run(Model& src, Model& dest, NearestNeighbor& nn, ICP& icp, dbgl::Properties& props);
+	    virtual void run(TriangleMesh& src, TriangleMesh& dest, NearestNeighbor& nn, ICP& icp, dbgl::Properties& props);
 	    virtual void printResults(dbgl::Properties& props);
 	    virtual void writeResults(dbgl::Properties& props);
 	private:
-	    void testWithModel(Model& src, Model& dest, NearestNeighbor& nn, ICP& icp);
+	    template<class MeshType> void runWith(MeshType& src, MeshType& dest, NearestNeighbor& nn, ICP& icp, dbgl::Properties& props);
+	    template<class MeshType> void testWithModel(MeshType& src, MeshType& dest, NearestNeighbor& nn, ICP& icp);
 	    std::string getPairSelectionFlags(dbgl::Bitmask<> flags);
 
 	    const std::string Prop_RandCycles = "PerformanceBenchmark_RandCycles";
@@ -13,6 +13,7 @@
 
 #include <DBGL/System/Properties/Properties.h>
 #include "SFA/Utility/Model.h"
+#include "SFA/Utility/TriangleMesh.h"
 #include "SFA/NearestNeighbor/NearestNeighbor.h"
 #include "SFA/ICP/ICP.h"
 
@@ -23,6 +24,7 @@ namespace sfa
 	public:
 	    virtual ~StatRunner() {};
 	    virtual void run(Model& src, Model& dest, NearestNeighbor& nn, ICP& icp, dbgl::Properties& props) = 0;
+	    virtual void run(TriangleMesh& src, TriangleMesh& dest, NearestNeighbor& nn, ICP& icp, dbgl::Properties& props) = 0;
 	    virtual void printResults(dbgl::Properties& props) = 0;
 	    virtual void writeResults(dbgl::Properties& props) = 0;
 	    template <typename Iterator> double calcMean(Iterator begin, Iterator end) const;
@@ -12,7 +12,7 @@
 
 namespace sfa
 {
-    void AverageMatchingError::run(Model& src, Model& dest, NearestNeighbor& nn, ICP& icp, dbgl::Properties& props)
+    template<class MeshType> void AverageMatchingError::runWith(MeshType& src, MeshType& dest, NearestNeighbor& nn, ICP& icp, dbgl::Properties& props)
     {
 	LOG.info("Starting AverageMatchingError test suite...");
 
@@ -69,16 +69,16 @@ namespace sfa
 	holes = 0;
 	if(props.getStringValue(Prop_Holes) != "")
 	    holes = props.getIntValue(Prop_Holes);
-	for(unsigned int i = 0; i < holes; i++)
-	    src.addHole();
+	src.addHoles(holes);
 
 	testWithModel(src, dest, nn, icp);
     }
 
-    void AverageMatchingError::testWithModel(Model& src, Model& dest, NearestNeighbor& nn, ICP& icp)
+    template<class MeshType> void AverageMatchingError::testWithModel(MeshType& src, MeshType& dest, NearestNeighbor& nn, ICP& icp)
     {
-	// Store original model
-	Model original(src);
+	// Store original vertex positions
+	typename MeshType::Snapshot original;
+	src.saveSnapshot(original);
 	// Iterate %randCycles% times
 	for (unsigned int i = 0; i < randCycles; i++)
 	{
@@ -86,7 +86,7 @@ namespace sfa
 	    if(i % 10 == 0)
 		LOG.info("%...", i);
 	    // Reset original vertex positions
-	    src = original;
+	    src.restoreSnapshot(original);
 	    // Displace src
 	    if (maxRot > 0)
 		averageRotation += src.rotateRandom(maxRot, minRot);
@@ -95,6 +95,8 @@ namespace sfa
 	    // Calculate error
 	    averageAlgoErrorBegin += nn.computeError(src, dest);
 	    averageRealErrorBegin += nn.computeError(src, dest, correctPairs);
+	    // One-shot alignments have to run again for the new displacement
+	    icp.reset();
 	    for (unsigned int j = 0; j < icpCycles; j++)
 	    {
 		// Calculate next icp step
@@ -128,14 +130,16 @@ namespace sfa
 	averageSelectedPoints /= (randCycles * icpCycles);
     }
 
-    void AverageMatchingError::initCorrectPairs(Model& src, Model& dest, NearestNeighbor& nn, ICP& icp)
+    template<class MeshType> void AverageMatchingError::initCorrectPairs(MeshType& src, MeshType& dest, NearestNeighbor& nn, ICP& icp)
     {
 	// Store original vertex positions
-	Model original(src);
+	typename MeshType::Snapshot original;
+	src.saveSnapshot(original);
 	unsigned int selectionMethod = icp.getSelectionMethod();
 	icp.setSelectionMethod(ICP::NO_EDGES);
 	double selectionPercent = icp.getSelectionPercentage();
 	icp.setSelectionPercentage(1);
+	icp.reset();
 	// Calculate a lot if icp steps to make sure we have the correct pairs
 	for (unsigned int i = 0; i < icpCycles; i++)
 	{
@@ -151,10 +155,20 @@ namespace sfa
 	// Revert back to original vertex positions
 	icp.setSelectionMethod(selectionMethod);
 	icp.setSelectionPercentage(selectionPercent);
-	src = std::move(original);
+	src.restoreSnapshot(original);
 	LOG.info("Initialization done.");
     }
 
+    void AverageMatchingError::run(Model& src, Model& dest, NearestNeighbor& nn, ICP& icp, dbgl::Properties& props)
+    {
+	runWith(src, dest, nn, icp, props);
+    }
+
+    void AverageMatchingError::run(TriangleMesh& src, TriangleMesh& dest, NearestNeighbor& nn, ICP& icp, dbgl::Properties& props)
+    {
+	runWith(src, dest, nn, icp, props);
+    }
+
     void AverageMatchingError::printResults(dbgl::Properties& props)
     {
 	LOG.info("RESULTS (rotation in the range of [%, %], average rotation: %, translation in the range of [%, %], average translation: %, pair selection filter: %, noise level: %, holes: %, % source vertices, % destination vertices):", maxRot, minRot, averageRotation, maxTrans, minTrans, averageTranslation, pairSelection.c_str(), noiseLevel, holes, srcVertices, destVertices);
@@ -271,6 +285,10 @@ namespace sfa
 	    flagString += "EVERY_FOURTH___";
 	if(flags.isSet(ICP::EVERY_FIFTH))
 	    flagString += "EVERY_FIFTH___";
+	if(flags.isSet(ICP::NORMAL_SPACE))
+	    flagString += "NORMAL_SPACE___";
+	if(flags.isSet(ICP::COVARIANCE))
+	    flagString += "COVARIANCE___";
 	std::ostringstream s;
 	s << pairSelectionPercent * 100;
 	flagString += s.str();
@@ -12,7 +12,7 @@
 
 namespace sfa
 {
-    void PCAMatchingError::run(Model& src, Model& dest, NearestNeighbor& nn, ICP& icp, dbgl::Properties& props)
+    template<class MeshType> void PCAMatchingError::runWith(MeshType& src, MeshType& dest, NearestNeighbor& nn, ICP& icp, dbgl::Properties& props)
     {
 	LOG.info("Starting PCAMatchingError test suite...");
 
@@ -53,17 +53,17 @@ namespace sfa
 	holes = 0;
 	if(props.getStringValue(Prop_Holes) != "")
 	    holes = props.getIntValue(Prop_Holes);
-	for(unsigned int i = 0; i < holes; i++)
-	    src.addHole();
+	src.addHoles(holes);
 
 	initCorrectPairs(src, dest, nn, icp);
 	testWithModel(src, dest, nn);
     }
 
-    void PCAMatchingError::testWithModel(Model& src, Model& dest, NearestNeighbor& nn)
+    template<class MeshType> void PCAMatchingError::testWithModel(MeshType& src, MeshType& dest, NearestNeighbor& nn)
     {
-	// Store original model
-	Model original(src);
+	// Store original vertex positions
+	typename MeshType::Snapshot original;
+	src.saveSnapshot(original);
 	// Rotate as often as wanted
 	for(unsigned int rotCycle = 0; rotCycle < rotSteps; rotCycle++)
 	{
@@ -76,7 +76,7 @@ namespace sfa
 	    for(unsigned int i = 0; i < randCycles; i++)
 	    {
 		// Reset original vertex positions
-		src = original;
+		src.restoreSnapshot(original);
 		// Displace src
 		if (curRotation > 0)
 		    src.rotateRandom(curRotation, curRotation);
@@ -87,8 +87,7 @@ namespace sfa
 		curRealMatching = realError;
 		// Do PCA alignment
 		pca_icp.reset();
-		pca_icp.calcNextStep(src, dest); // First dimension
-		pca_icp.calcNextStep(src, dest); // Second dimension
+		pca_icp.calcNextStep(src, dest);
 		// Calculate error again
 		unsigned int matches = 0;
 		double nnErrorChange = curNNMatching - nn.computeError(src, dest);
@@ -111,12 +110,14 @@ namespace sfa
 	}
     }
 
-    void PCAMatchingError::initCorrectPairs(Model& src, Model& dest, NearestNeighbor& nn, ICP& icp)
+    template<class MeshType> void PCAMatchingError::initCorrectPairs(MeshType& src, MeshType& dest, NearestNeighbor& nn, ICP& icp)
     {
 	// Store original vertex positions
-	Model original(src);
+	typename MeshType::Snapshot original;
+	src.saveSnapshot(original);
 	unsigned int selectionMethod = icp.getSelectionMethod();
 	icp.setSelectionMethod(ICP::NO_EDGES);
+	icp.reset();
 	// Calculate a lot if icp steps to make sure we have the correct pairs
 	for (unsigned int i = 0; i < 30; i++)
 	{
@@ -131,10 +132,20 @@ namespace sfa
 	}
 	// Revert back to original vertex positions
 	icp.setSelectionMethod(selectionMethod);
-	src = std::move(original);
+	src.restoreSnapshot(original);
 	LOG.info("Initialization done.");
     }
 
+    void PCAMatchingError::run(Model& src, Model& dest, NearestNeighbor& nn, ICP& icp, dbgl::Properties& props)
+    {
+	runWith(src, dest, nn, icp, props);
+    }
+
+    void PCAMatchingError::run(TriangleMesh& src, TriangleMesh& dest, NearestNeighbor& nn, ICP& icp, dbgl::Properties& props)
+    {
+	runWith(src, dest, nn, icp, props);
+    }
+
     void PCAMatchingError::printResults(dbgl::Properties& props)
     {
 	LOG.info("RESULTS (rotation in % steps from % to %, noise level: %, holes: %, % source vertices, % destination vertices):", rotSteps, fromRot, toRot, noiseLevel, holes, srcVertices, destVertices);
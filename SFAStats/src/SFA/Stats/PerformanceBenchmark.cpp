@@ -12,7 +12,7 @@
 
 namespace sfa
 {
-    void PerformanceBenchmark::run(Model& src, Model& dest, NearestNeighbor& nn, ICP& icp, dbgl::Properties& props)
+    template<class MeshType> void PerformanceBenchmark::runWith(MeshType& src, MeshType& dest, NearestNeighbor& nn, ICP& icp, dbgl::Properties& props)
     {
     	LOG.info("Starting PerformanceBenchmark test suite...");
 
@@ -49,10 +49,11 @@ namespace sfa
     	testWithModel(src, dest, nn, icp);
     }
 
-    void PerformanceBenchmark::testWithModel(Model& src, Model& dest, NearestNeighbor& /* nn */, ICP& icp)
+    template<class MeshType> void PerformanceBenchmark::testWithModel(MeshType& src, MeshType& dest, NearestNeighbor& /* nn */, ICP& icp)
     {
-	// Store original model
-	Model original(src);
+	// Store original vertex positions
+	typename MeshType::Snapshot original;
+	src.saveSnapshot(original);
 	// Iterate %randCycles% times
 	for (unsigned int i = 0; i < randCycles; i++)
 	{
@@ -60,7 +61,7 @@ namespace sfa
 	    if(i % 10 == 0)
 		LOG.info("%...", i);
 	    // Reset original vertex positions
-	    src = original;
+	    src.restoreSnapshot(original);
 	    // Displace src
 	    if (maxRot > 0)
 		averageRotation += src.rotateRandom(maxRot, minRot);
@@ -68,8 +69,8 @@ namespace sfa
 		averageTranslation += src.translateRandom(maxTrans, minTrans);
 	    for (unsigned int j = 0; j < icpCycles; j++)
 	    {
-		if(typeid(icp) == typeid(PCA_ICP))
-		    dynamic_cast<PCA_ICP*>(&icp)->reset();
+		// One-shot alignments are timed on every cycle
+		icp.reset();
 		// Start time
 		steady_clock::time_point start = steady_clock::now();
 		// Calculate next icp step
@@ -89,6 +90,16 @@ namespace sfa
 	averageTranslation /= randCycles;
     }
 
+    void PerformanceBenchmark::run(Model& src, Model& dest, NearestNeighbor& nn, ICP& icp, dbgl::Properties& props)
+    {
+	runWith(src, dest, nn, icp, props);
+    }
+
+    void PerformanceBenchmark::run(TriangleMesh& src, TriangleMesh& dest, NearestNeighbor& nn, ICP& icp, dbgl::Properties& props)
+    {
+	runWith(src, dest, nn, icp, props);
+    }
+
     void PerformanceBenchmark::printResults(dbgl::Properties& props)
     {
 	LOG.info("RESULTS (rotation in the range of [%, %], average rotation: %, translation in the range of [%, %], average translation: %, pair selection filter: %, % source vertices, % destination vertices):", maxRot, minRot, averageRotation, maxTrans, minTrans, averageTranslation, pairSelection.c_str(), srcVertices, destVertices);
@@ -148,6 +159,10 @@ namespace sfa
 	    flagString += "EVERY_FOURTH___";
 	if(flags.isSet(ICP::EVERY_FIFTH))
 	    flagString += "EVERY_FIFTH___";
+	if(flags.isSet(ICP::NORMAL_SPACE))
+	    flagString += "NORMAL_SPACE___";
+	if(flags.isSet(ICP::COVARIANCE))
+	    flagString += "COVARIANCE___";
 	std::ostringstream s;
 	s << pairSelectionPercent * 100;
 	flagString += s.str();
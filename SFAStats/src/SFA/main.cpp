@@ -14,14 +14,22 @@
 #include "SFA/NearestNeighbor/NearestNeighbor.h"
 #include "SFA/NearestNeighbor/SimpleNearestNeighbor.h"
 #include "SFA/NearestNeighbor/KdTreeNearestNeighbor.h"
+#include "SFA/NearestNeighbor/TriangleMeshNearestNeighbor.h"
 #include "SFA/ICP/ICP.h"
 #include "SFA/ICP/RigidPointICP.h"
 #include "SFA/ICP/RigidPlaneICP.h"
+#include "SFA/ICP/KernelICP.h"
+#include "SFA/ICP/GeneralizedICP.h"
 #include "SFA/ICP/PCA_ICP.h"
+#include "SFA/ICP/FPFH_ICP.h"
+#include "SFA/ICP/LandmarkICP.h"
+#include "SFA/ICP/BranchAndBoundICP.h"
 #include "SFA/Stats/StatRunner.h"
 #include "SFA/Stats/AverageMatchingError.h"
 #include "SFA/Stats/PCAMatchingError.h"
 #include "SFA/Stats/PerformanceBenchmark.h"
+#include "SFA/Utility/Scheduler.h"
+#include "SFA/Utility/TriangleMesh.h"
 
 using namespace dbgl;
 using namespace sfa;
@@ -33,12 +41,25 @@ bool checkProperties()
     return properties.getStringValue("src") != "" && properties.getStringValue("dest") != "";
 }
 
+bool useHeadlessMesh()
+{
+    return properties.getStringValue("Mesh") == "Headless";
+}
+
+NearestNeighbor* createTreeNN()
+{
+    // Every mesh type keeps its own tree
+    if (useHeadlessMesh())
+	return new TriangleMeshNearestNeighbor;
+    return new KdTreeNearestNeighbor;
+}
+
 NearestNeighbor* selectNN()
 {
     if (properties.getStringValue("NearestNeighbor") == "KdTree")
     {
 	LOG.info("Using K-d tree for nearest neighbor search.");
-	return new KdTreeNearestNeighbor;
+	return createTreeNN();
     }
     else if(properties.getStringValue("NearestNeighbor") == "Simple")
     {
@@ -48,31 +69,71 @@ NearestNeighbor* selectNN()
     else
     {
 	LOG.info("No nearest neighbor search specified. Falling back to K-d tree nearest neighbor search.");
-	return new KdTreeNearestNeighbor;
+	return createTreeNN();
     }
 }
 
+template<class RigidICP, class SolverType> ICP* createRigidICP(NearestNeighbor& nn)
+{
+    // Meshes are searched by k-d tree in most cases, use the statically dispatched kernel for those
+    auto pKdTree = dynamic_cast<KdTreeNearestNeighbor*>(&nn);
+    if (pKdTree != nullptr)
+	return new KernelICP<Model, KdTreeNearestNeighbor, SolverType>(*pKdTree);
+    auto pMeshTree = dynamic_cast<TriangleMeshNearestNeighbor*>(&nn);
+    if (pMeshTree != nullptr)
+	return new KernelICP<TriangleMesh, TriangleMeshNearestNeighbor, SolverType>(*pMeshTree);
+    return new RigidICP(nn);
+}
+
 ICP* selectICP(NearestNeighbor& nn)
 {
     if (properties.getStringValue("ICP") == "RigidPoint2Point")
     {
 	LOG.info("Using rigid body point-to-point ICP.");
-	return new RigidPointICP(nn);
+	return createRigidICP<RigidPointICP, PointToPointSolver>(nn);
     }
     else if(properties.getStringValue("ICP") == "RigidPoint2Plane")
     {
 	LOG.info("Using rigid body point-to-plane ICP.");
-	return new RigidPlaneICP(nn);
+	return createRigidICP<RigidPlaneICP, PointToPlaneSolver>(nn);
+    }
+    else if(properties.getStringValue("ICP") == "Generalized")
+    {
+	LOG.info("Using generalized (plane-to-plane) ICP.");
+	return new GeneralizedICP(nn);
     }
     else if(properties.getStringValue("ICP") == "PCA")
     {
 	LOG.info("Using PCA ICP.");
 	return new PCA_ICP;
     }
+    else if(properties.getStringValue("ICP") == "PCAHypotheses")
+    {
+	LOG.info("Using PCA ICP with hypothesis racing.");
+	return new PCA_ICP(nn);
+    }
+    else if(properties.getStringValue("ICP") == "FPFH")
+    {
+	LOG.info("Using feature based global alignment.");
+	return new FPFH_ICP;
+    }
+    else if(properties.getStringValue("ICP") == "Landmarks")
+    {
+	LOG.info("Using curvature landmark based alignment.");
+	return new LandmarkICP;
+    }
+    else if(properties.getStringValue("ICP") == "BranchAndBound")
+    {
+	LOG.info("Using branch-and-bound global alignment.");
+	auto pICP = new BranchAndBoundICP;
+	if(properties.getStringValue("MaxCubes") != "")
+	    pICP->setMaxCubes(properties.getIntValue("MaxCubes"));
+	return pICP;
+    }
     else
     {
 	LOG.info("No ICP specified. Falling back to rigid body point-to-point ICP.");
-	return new RigidPointICP(nn);
+	return createRigidICP<RigidPointICP, PointToPointSolver>(nn);
     }
 }
 
@@ -118,28 +179,44 @@ int main(int argc, char** argv)
 	return -1;
     }
 
+    // All parallel algorithms share the same threads
+    if(properties.getStringValue("Threads") != "")
+	Scheduler::setDefaultThreads(properties.getIntValue("Threads"));
+
     // Select appropriate algorithms
     NearestNeighbor* pnn = selectNN();
     ICP* picp = selectICP(*pnn);
+    if(properties.getStringValue("Seed") != "")
+	picp->setSeed(properties.getIntValue("Seed"));
+    if(properties.getStringValue("SelectionBudget") != "")
+	picp->setSelectionBudget(properties.getIntValue("SelectionBudget"));
     StatRunner* pStatRunner = selectStatRunner();
 
     // Load meshes
-    Model* pSourceModel = new Model(properties.getStringValue("src"));
-    Model* pDestModel = new Model(properties.getStringValue("dest"));
-
-    pStatRunner->run(*pSourceModel, *pDestModel, *pnn, *picp, properties);
+    if (useHeadlessMesh())
+    {
+	LOG.info("Using headless meshes.");
+	TriangleMesh sourceMesh(properties.getStringValue("src"));
+	TriangleMesh destMesh(properties.getStringValue("dest"));
+	pStatRunner->run(sourceMesh, destMesh, *pnn, *picp, properties);
+    }
+    else
+    {
+	Model sourceModel(properties.getStringValue("src"));
+	Model destModel(properties.getStringValue("dest"));
+	pStatRunner->run(sourceModel, destModel, *pnn, *picp, properties);
+    }
     pStatRunner->printResults(properties);
     pStatRunner->writeResults(properties);
 
     delete pnn;
     delete picp;
     delete pStatRunner;
-    delete pSourceModel;
-    delete pDestModel;
 
     LOG.info("That's it!");
 
-    // Free remaining internal resources
-    WindowManager::get()->terminate();
+    // Free remaining internal resources, headless meshes don't use any
+    if (!useHeadlessMesh())
+	WindowManager::get()->terminate();
     return 0;
 }
@@ -28,7 +28,10 @@
 #include "SFA/NearestNeighbor/KdTreeNearestNeighbor.h"
 #include "SFA/ICP/RigidPointICP.h"
 #include "SFA/ICP/RigidPlaneICP.h"
+#include "SFA/ICP/GeneralizedICP.h"
 #include "SFA/ICP/PCA_ICP.h"
+#include "SFA/ICP/FPFH_ICP.h"
+#include "SFA/ICP/LandmarkICP.h"
 
 using namespace std;
 using namespace Eigen;
@@ -51,8 +54,11 @@ sfa::Log logfile;
 KdTreeNearestNeighbor nn;
 RigidPointICP rigidPoint_icp(nn, &logfile);
 RigidPlaneICP rigidPlane_icp(nn, &logfile);
+GeneralizedICP generalized_icp(nn, &logfile);
 ICP* icp = &rigidPoint_icp;
 PCA_ICP pca_icp;
+FPFH_ICP fpfh_icp(&logfile);
+LandmarkICP landmark_icp(&logfile);
 
 Properties properties;
 
@@ -105,6 +111,24 @@ void keyCallback(Window::KeyEventArgs const& args)
 	nn.clearCache();
 	LOG.info("Done!");
     }
+    // Check if feature based matching should be executed
+    else if (args.key == Input::Key::KEY_G && args.action == Input::KeyState::PRESSED)
+    {
+	LOG.info("Calculating feature based matching!");
+	fpfh_icp.calcNextStep(*pSourceModel, *pDestModel);
+	pSourceModel->getBasePointer()->updateBuffers();
+	nn.clearCache();
+	LOG.info("Done!");
+    }
+    // Check if landmark based matching should be executed
+    else if (args.key == Input::Key::KEY_K && args.action == Input::KeyState::PRESSED)
+    {
+	LOG.info("Calculating landmark based matching!");
+	landmark_icp.calcNextStep(*pSourceModel, *pDestModel);
+	pSourceModel->getBasePointer()->updateBuffers();
+	nn.clearCache();
+	LOG.info("Done!");
+    }
     // Toggle source and destination mesh visibility
     else if(args.key == Input::Key::KEY_O && args.action == Input::KeyState::PRESSED)
     {
@@ -120,6 +144,8 @@ void keyCallback(Window::KeyEventArgs const& args)
 	double rotation = pSourceModel->rotateRandom(properties.getFloatValue("maxRandomRotation"));
 	LOG.info("Rotated source mesh by %.", rotation);
 	pca_icp.reset();
+	fpfh_icp.reset();
+	landmark_icp.reset();
 	pSourceModel->getBasePointer()->updateBuffers();
     }
     else if (args.key == Input::Key::KEY_T && args.action == Input::KeyState::PRESSED && args.mods.isSet(Input::Modifier::KEY_CONTROL))
@@ -127,6 +153,8 @@ void keyCallback(Window::KeyEventArgs const& args)
 	double translation = pSourceModel->translateRandom(properties.getFloatValue("maxRandomTranslation"));
 	LOG.info("Translated source mesh by %", translation);
 	pca_icp.reset();
+	fpfh_icp.reset();
+	landmark_icp.reset();
 	pSourceModel->getBasePointer()->updateBuffers();
     }
     // Reload meshes
@@ -140,6 +168,8 @@ void keyCallback(Window::KeyEventArgs const& args)
 	pSourceModel->getBasePointer()->updateBuffers();
 	pDestModel->getBasePointer()->updateBuffers();
 	pca_icp.reset();
+	fpfh_icp.reset();
+	landmark_icp.reset();
     }
     // Log matching error
     else if(args.key == Input::Key::KEY_L && args.action == Input::KeyState::PRESSED)
@@ -202,6 +232,22 @@ void keyCallback(Window::KeyEventArgs const& args)
 	else
 	    LOG.info("Removing filter \"Random\".");
     }
+    else if(args.key == Input::Key::KEY_F8 && args.action == Input::KeyState::PRESSED)
+    {
+	selectionMethod.toggle(ICP::NORMAL_SPACE);
+	if(selectionMethod.isSet(ICP::NORMAL_SPACE))
+	    LOG.info("Adding filter \"Normal space\".");
+	else
+	    LOG.info("Removing filter \"Normal space\".");
+    }
+    else if(args.key == Input::Key::KEY_F9 && args.action == Input::KeyState::PRESSED)
+    {
+	selectionMethod.toggle(ICP::COVARIANCE);
+	if(selectionMethod.isSet(ICP::COVARIANCE))
+	    LOG.info("Adding filter \"Covariance\".");
+	else
+	    LOG.info("Removing filter \"Covariance\".");
+    }
     else if(args.key == Input::Key::KEY_F12 && args.action == Input::KeyState::PRESSED)
     {
 	if(icp->getSelectionPercentage() >= 1.0)
@@ -240,6 +286,11 @@ void keyCallback(Window::KeyEventArgs const& args)
     if(args.key == Input::Key::KEY_BACKSPACE && args.action == Input::KeyState::PRESSED)
     {
 	if(typeid(*icp) == typeid(RigidPlaneICP))
+	{
+	    icp = &generalized_icp;
+	    LOG.info("Using generalized (plane-to-plane) ICP.");
+	}
+	else if(typeid(*icp) == typeid(GeneralizedICP))
 	{
 	    icp = &rigidPoint_icp;
 	    LOG.info("Using rigid-body point-to-point ICP.");
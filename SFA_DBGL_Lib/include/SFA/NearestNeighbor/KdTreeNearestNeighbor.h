@@ -19,10 +19,18 @@ namespace sfa
     /**
      * @brief This nearest neighbor search uses a k-d tree for acceleration
      */
-    class KdTreeNearestNeighbor : public NearestNeighbor
+    class KdTreeNearestNeighbor final : public NearestNeighbor
     {
 	public:
 	    virtual unsigned int getNearest(unsigned int n, AbstractMesh const& source, AbstractMesh const& dest);
+	    virtual unsigned int findNearest(Eigen::Vector3d const& point, AbstractMesh const& dest) const;
+	    /**
+	     * @brief Finds the nearest neighbor of a point on a model without any runtime type checks
+	     * @param point Point to find the nearest neighbor for
+	     * @param dest Model to search on
+	     * @return Index of the nearest vertex on dest
+	     */
+	    unsigned int findNearest(Eigen::Vector3d const& point, Model const& dest) const;
 	    virtual void clearCache();
 	private:
     };
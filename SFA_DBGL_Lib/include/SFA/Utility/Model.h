@@ -19,6 +19,7 @@
 #include <map>
 #include <limits>
 #include <random>
+#include <memory>
 #include <Eigen/Core>
 #include <Eigen/Geometry>
 #include <DBGL/Rendering/Mesh/Mesh.h>
@@ -27,16 +28,46 @@
 #include <DBGL/Math/Vector3.h>
 #include <DBGL/System/Tree/KdTree.h>
 #include "SFA/Utility/AbstractMesh.h"
+#include "SFA/Utility/Parallel.h"
+#include "SFA/Utility/Boundary.h"
+#include "SFA/Utility/VertexWelder.h"
 
 namespace sfa
 {
     /**
      * @brief This is the mesh implementation used for calculations.
      * 	      Internally it uses the dbgl mesh implementation.
+     * @details The class is final, thus calls through a Model reference don't need to be
+     * 		dispatched at runtime. Coordinates and normals are stored packed in one array
+     * 		each, getVertex() assembles a Vertex on demand.
      */
-    class Model: public AbstractMesh
+    class Model final : public AbstractMesh
     {
 	public:
+	    /**
+	     * @brief Copy of the state of a model that changes when its vertices are moved
+	     * @details Topology isn't part of a snapshot. Buffers are reused by consecutive calls to
+	     * 		saveSnapshot(), thus resetting a model over and over doesn't allocate.
+	     */
+	    class Snapshot
+	    {
+		private:
+		    friend class Model;
+
+		    std::vector<double> m_positions;
+		    std::vector<double> m_normals;
+		    std::vector<float> m_floatPositions;
+		    std::vector<float> m_floatNormals;
+		    std::vector<dbgl::Vec3f> m_baseVertices;
+		    std::vector<dbgl::Vec3f> m_baseNormals;
+		    std::shared_ptr<dbgl::KdTree<unsigned int, dbgl::Vec3d> const> m_vertexTree;
+		    Eigen::Matrix3d m_poseRotation;
+		    Eigen::Vector3d m_poseTranslation;
+		    std::mt19937 m_random;
+		    unsigned int m_generation = 0;
+		    unsigned int m_shapeGeneration = 0;
+	    };
+
 	    Model();
 	    Model(std::string path, bool optimize = false);
 	    Model(Model const& other);
@@ -44,69 +75,193 @@ namespace sfa
 	    virtual ~Model();
 	    virtual unsigned int getID() const;
 	    virtual Vertex getVertex(unsigned int n) const;
-	    std::vector<Vertex> const& getVertices() const;
+	    virtual Eigen::Vector3d getCoords(unsigned int n) const;
+	    virtual Eigen::Vector3d getNormal(unsigned int n) const;
+	    virtual bool isEdge(unsigned int n) const;
+	    virtual Eigen::Map<Eigen::Matrix3Xd const> getPositions() const;
+	    virtual Eigen::Map<Eigen::Matrix3Xd const> getNormals() const;
+	    virtual Adjacency const& getAdjacency() const;
+	    /**
+	     * @return Mapping from every vertex to the vertices of the underlying mesh representing it
+	     */
+	    Adjacency const& getBaseVertices() const;
+	    /**
+	     * @return All boundary loops of the mesh, each listing its vertices in order
+	     */
+	    std::vector<std::vector<uint32_t>> const& getBoundaryLoops() const;
+	    /**
+	     * @brief Provides single precision copies of all coordinates
+	     * @return Packed coordinates of all vertices, empty unless enabled by setFloatData()
+	     */
+	    Eigen::Map<Eigen::Matrix3Xf const> getFloatPositions() const;
+	    /**
+	     * @brief Provides single precision copies of all normals
+	     * @return Packed normals of all vertices, empty unless enabled by setFloatData()
+	     */
+	    Eigen::Map<Eigen::Matrix3Xf const> getFloatNormals() const;
+	    /**
+	     * @return True in case single precision copies of coordinates and normals are kept
+	     */
+	    bool hasFloatData() const;
+	    /**
+	     * @brief Enables or disables single precision copies of coordinates and normals
+	     * @details Once enabled the copies are kept up to date by every modification.
+	     * @param enabled True to keep single precision copies
+	     */
+	    void setFloatData(bool enabled);
+	    /**
+	     * @brief Provides a tree of all vertices for fast lookups
+	     * @details The tree holds coordinates in the local frame of the model, i.e. before the
+	     * 		rigid transformations accumulated in getPose(). Query points have to be passed
+	     * 		through toLocalFrame() first.
+	     * @return The vertex tree
+	     */
 	    dbgl::KdTree<unsigned int, dbgl::Vec3d> const& getVertexTree() const;
+	    /**
+	     * @brief Provides the rigid transformation applied since the vertex tree was built
+	     * @return Transformation from the local frame into the current coordinate frame
+	     */
+	    Eigen::Isometry3d getPose() const;
+	    /**
+	     * @brief Maps a point into the local frame of the model
+	     * @param coords Point in the current coordinate frame of the mesh
+	     * @return The point in the local frame, as used by the vertex tree
+	     */
+	    Eigen::Vector3d toLocalFrame(Eigen::Vector3d const& coords) const;
 	    virtual void setVertex(unsigned int n, Eigen::Vector3d const& coords, Eigen::Vector3d const& normal);
+	    /**
+	     * @brief Moves all vertices by a rigid transformation
+	     * @details Updates the packed arrays and the underlying mesh in one parallel pass. Topology
+	     * 		and vertex tree are kept, the transformation is only added to the pose.
+	     * @param R Rotation
+	     * @param t Translation
+	     */
+	    virtual void applyTransform(Eigen::Matrix3d const& R, Eigen::Vector3d const& t);
+	    /**
+	     * @brief Replaces the coordinates of all vertices at once
+	     * @details Normals are kept. The vertex tree is rebuilt.
+	     * @param positions New coordinates, column n holds the coordinates of vertex n
+	     * @exception Throws std::invalid_argument in case the amount of columns doesn't match the
+	     * 		  amount of vertices
+	     */
+	    virtual void setPositions(Eigen::Ref<Eigen::Matrix3Xd const> const& positions);
 	    virtual unsigned int getAmountOfVertices() const;
 	    Eigen::Vector3d getAverage() const;
+	    virtual unsigned int getGeneration() const;
+	    virtual unsigned int getShapeGeneration() const;
 	    void refresh();
 	    void addNoise();
 	    void addHole();
+	    /**
+	     * @brief Removes several regions of the mesh at once
+	     * @details Every hole removes a random vertex along with all vertices that can be reached
+	     * 		from it in at most \p radius steps. Vertices are removed in one batch, thus the
+	     * 		remaining topology is only updated once.
+	     * @param amount Amount of holes
+	     * @param radius Amount of neighborhood rings to remove around each center
+	     */
+	    void addHoles(unsigned int amount, unsigned int radius = 0);
 	    double rotateRandom(double maxAngle, double minAngle = 0);
 	    double translateRandom(double maxTranslation, double minTranslation = 0);
 	    dbgl::Mesh* getBasePointer();
+	    /**
+	     * @brief Stores coordinates and normals of all vertices
+	     * @param snapshot Snapshot to overwrite
+	     */
+	    void saveSnapshot(Snapshot& snapshot) const;
+	    /**
+	     * @brief Resets coordinates and normals of all vertices to a previously saved state
+	     * @details Only copies memory, the topology is kept. Thus the snapshot has to be taken
+	     * 		from this model or a copy of it, and vertices may not have been added or removed
+	     * 		since.
+	     * @param snapshot Snapshot to restore
+	     * @exception Throws std::invalid_argument in case the snapshot doesn't fit the topology
+	     */
+	    void restoreSnapshot(Snapshot const& snapshot);
 	    Model& operator=(Model const& other);
 	    Model& operator=(Model&& other);
 	private:
+	    /**
+	     * @brief Everything derived from the connectivity of the underlying mesh
+	     * @details Never modified once built, thus copies of a model share it.
+	     */
+	    struct Topology
+	    {
+		std::vector<unsigned int> baseIndex2ModelIndex;
+		Adjacency neighbors;
+		Adjacency baseVertices;
+		Boundary boundary;
+	    };
+
 	    /**
 	     * @brief Analyzes the underlying mesh and generates some additional data
 	     * @details Additional data includes neighboring vertices and if the vertex is part
 	     * 		of the edge of the mesh. Vertices are considered neighbors if they share
-	     * 		a face. They are considered edge vertices if there is no possible way
-	     * 		of moving from one neighbor to the other and ending up at the beginning
-	     * 		with a cumulative angle of 360 degree or more.
+	     * 		a face. They are considered edge vertices if they are incident to a mesh
+	     * 		edge that is used by one face only.
 	     */
 	    void analyzeMesh();
 	    /**
-	     * @brief Checks if a vertex is situated on the edge of a mesh.
-	     * @param base Vertex to check
-	     * @param start Neighbor of base to start algorithm from
-	     * @return True in case no way has been found to circle base through its neighbors
-	     * 	       starting from start, and ending up at start with a total angle of 360
-	     * 	       or more. False otherwise.
-	     * @note If this algorithm returns false base definitely isn't an edge vertex. However,
-	     * 	     if it returns true, it might still be no edge vertex as there might be a path
-	     * 	     from a different neighbor to start from. To make sure that base is an edge
-	     * 	     vertex this method has to be called for each neighboring vertex (passed as
-	     * 	     start). If it still didn't return false, it is an edge vertex.
-	     */
-	    bool checkEdge(Vertex base, Vertex start);
-	    /**
-	     * @brief Called internally by analyzeMesh(). Checks if a vertex is situated on the
-	     * 	      edge of a mesh.
-	     * @param base Vertex to check
-	     * @param start Neighbor of base to start algorithm from
-	     * @param begin Vertex the algorithm has to come back to (should equal start on
-	     * 		    first call)
-	     * @param last Last checked vertex
-	     * @param checked Map containing flags for every neighbor of base if it has already
-	     * 		      been checked or not
-	     * @return True in case no way has been found to circle base through its neighbors
-	     * 	       starting from start, and ending up at begin with a total angle of 360
-	     * 	       or more. False otherwise.
-	     * @note If this algorithm returns false base definitely isn't an edge vertex. However,
-	     * 	     if it returns true, it might still be no edge vertex as there might be a path
-	     * 	     from a different neighbor to start from. To make sure that base is an edge
-	     * 	     vertex this method has to be called for each neighboring vertex (passed as
-	     * 	     start). If it still didn't return false, it is an edge vertex.
-	     */
-	    bool checkEdge(Vertex base, Vertex start, Vertex begin, Vertex last, std::map<unsigned int, bool> checked);
+	     * @brief Computes neighborhoods and edge vertices from the faces of the underlying mesh
+	     * @param topology Topology with a valid mapping from base vertices to vertices
+	     * @param amount Amount of vertices
+	     */
+	    void computeConnectivity(Topology& topology, unsigned int amount) const;
+	    /**
+	     * @brief Removes vertices from this model and the underlying mesh
+	     * @details Welding and normals are kept for the remaining vertices, indices are compacted.
+	     * @param removed Non-zero for every vertex to remove
+	     */
+	    void removeVertices(std::vector<char> const& removed);
+	    /**
+	     * @brief Makes sure vertex \p n exists
+	     * @param n Number of the vertex
+	     * @exception Throws std::out_of_range in case n is out of bounds
+	     */
+	    void checkBounds(unsigned int n) const;
+	    /**
+	     * @brief Updates the single precision copies of vertex \p n, if enabled
+	     * @param n Number of the vertex
+	     */
+	    void updateFloatData(unsigned int n);
+	    /**
+	     * @brief Copies the coordinates of all vertices to the underlying mesh
+	     * @param pRotation If not null, the normals of the underlying mesh are rotated by it
+	     */
+	    void updateBaseMesh(Eigen::Matrix3d const* pRotation = nullptr);
+	    /**
+	     * @brief Inserts all vertices into a new vertex tree
+	     */
+	    void rebuildVertexTree();
 
 	    dbgl::Mesh* m_pMesh;
-	    std::vector<Vertex> m_vertices;
-	    std::vector<unsigned int> m_baseIndex2ModelIndex;
-	    dbgl::KdTree<unsigned int, dbgl::Vec3d> m_vertexTree;
+	    /**
+	     * @brief Coordinates of all vertices, three consecutive values per vertex
+	     */
+	    std::vector<double> m_positions;
+	    /**
+	     * @brief Normals of all vertices, three consecutive values per vertex
+	     */
+	    std::vector<double> m_normals;
+	    std::shared_ptr<Topology const> m_topology;
+	    bool m_floatData = false;
+	    std::vector<float> m_floatPositions;
+	    std::vector<float> m_floatNormals;
+	    /**
+	     * @brief Tree of all vertices, shared between copies until one of them rebuilds it
+	     */
+	    std::shared_ptr<dbgl::KdTree<unsigned int, dbgl::Vec3d> const> m_vertexTree;
+	    /**
+	     * @brief Rotation from the local frame into the current coordinate frame
+	     */
+	    Eigen::Matrix3d m_poseRotation = Eigen::Matrix3d::Identity();
+	    /**
+	     * @brief Translation from the local frame into the current coordinate frame
+	     */
+	    Eigen::Vector3d m_poseTranslation = Eigen::Vector3d::Zero();
 	    std::mt19937 m_random;
+	    unsigned int m_generation = 0;
+	    unsigned int m_shapeGeneration = 0;
     };
 }
 
@@ -22,12 +22,31 @@ namespace sfa
 	auto realDest = dynamic_cast<const Model*>(&dest);
 	dbgl::Vec3d nearest;
 	unsigned int data;
-	dbgl::Vec3d coords(source.getVertex(n).coords[0], source.getVertex(n).coords[1], source.getVertex(n).coords[2]);
+	Eigen::Vector3d point = realDest->toLocalFrame(source.getCoords(n));
+	dbgl::Vec3d coords(point[0], point[1], point[2]);
 	realDest->getVertexTree().findNearestNeighbor(coords, nearest, data);
 
 	return data;
     }
 
+    unsigned int KdTreeNearestNeighbor::findNearest(Eigen::Vector3d const& point, AbstractMesh const& dest) const
+    {
+	return findNearest(point, dynamic_cast<const Model&>(dest));
+    }
+
+    unsigned int KdTreeNearestNeighbor::findNearest(Eigen::Vector3d const& point, Model const& dest) const
+    {
+	if (dest.getAmountOfVertices() <= 0)
+	    throw std::invalid_argument("Destination mesh doesn't have any vertices!");
+
+	dbgl::Vec3d nearest;
+	unsigned int data;
+	Eigen::Vector3d local = dest.toLocalFrame(point);
+	dest.getVertexTree().findNearestNeighbor(dbgl::Vec3d(local[0], local[1], local[2]), nearest, data);
+
+	return data;
+    }
+
     void KdTreeNearestNeighbor::clearCache()
     {
     }
@@ -37,30 +37,58 @@ namespace sfa
     Model::Model(Model const& other)
     {
 	m_pMesh = new dbgl::Mesh(*other.m_pMesh);
-	m_baseIndex2ModelIndex = other.m_baseIndex2ModelIndex;
+	m_topology = other.m_topology;
 	m_vertexTree = other.m_vertexTree;
-	m_vertices = other.m_vertices;
+	m_poseRotation = other.m_poseRotation;
+	m_poseTranslation = other.m_poseTranslation;
+	m_positions = other.m_positions;
+	m_normals = other.m_normals;
+	m_floatData = other.m_floatData;
+	m_floatPositions = other.m_floatPositions;
+	m_floatNormals = other.m_floatNormals;
 	m_random = other.m_random;
+	m_generation = other.m_generation;
+	m_shapeGeneration = other.m_shapeGeneration;
     }
 
     Model::Model(Model&& other)
     {
 	m_pMesh = other.m_pMesh;
 	other.m_pMesh = nullptr;
-	m_baseIndex2ModelIndex = other.m_baseIndex2ModelIndex;
+	// Shared data is copied rather than moved, thus the moved-from model doesn't hold null pointers
+	m_topology = other.m_topology;
 	m_vertexTree = other.m_vertexTree;
-	m_vertices = other.m_vertices;
-	m_random = other.m_random;
+	m_poseRotation = other.m_poseRotation;
+	m_poseTranslation = other.m_poseTranslation;
+	m_positions = std::move(other.m_positions);
+	m_normals = std::move(other.m_normals);
+	m_floatData = other.m_floatData;
+	m_floatPositions = std::move(other.m_floatPositions);
+	m_floatNormals = std::move(other.m_floatNormals);
+	m_random = std::move(other.m_random);
+	m_generation = other.m_generation;
+	m_shapeGeneration = other.m_shapeGeneration;
     }
 
     Model& Model::operator=(Model const& other)
     {
-	delete m_pMesh;
-	m_pMesh = new dbgl::Mesh(*other.m_pMesh);
-	m_baseIndex2ModelIndex = other.m_baseIndex2ModelIndex;
-	m_vertexTree = other.m_vertexTree;
-	m_vertices = other.m_vertices;
-	m_random = other.m_random;
+	if (this != &other)
+	{
+	    delete m_pMesh;
+	    m_pMesh = new dbgl::Mesh(*other.m_pMesh);
+	    m_topology = other.m_topology;
+	    m_vertexTree = other.m_vertexTree;
+	    m_poseRotation = other.m_poseRotation;
+	    m_poseTranslation = other.m_poseTranslation;
+	    m_positions = other.m_positions;
+	    m_normals = other.m_normals;
+	    m_floatData = other.m_floatData;
+	    m_floatPositions = other.m_floatPositions;
+	    m_floatNormals = other.m_floatNormals;
+	    m_random = other.m_random;
+	    m_generation = other.m_generation;
+	    m_shapeGeneration = other.m_shapeGeneration;
+	}
 	return *this;
     }
 
@@ -71,10 +99,18 @@ namespace sfa
 	    delete m_pMesh;
 	    m_pMesh = other.m_pMesh;
 	    other.m_pMesh = nullptr;
-	    m_baseIndex2ModelIndex = other.m_baseIndex2ModelIndex;
+	    m_topology = other.m_topology;
 	    m_vertexTree = other.m_vertexTree;
-	    m_vertices = other.m_vertices;
-	    m_random = other.m_random;
+	    m_poseRotation = other.m_poseRotation;
+	    m_poseTranslation = other.m_poseTranslation;
+	    m_positions = std::move(other.m_positions);
+	    m_normals = std::move(other.m_normals);
+	    m_floatData = other.m_floatData;
+	    m_floatPositions = std::move(other.m_floatPositions);
+	    m_floatNormals = std::move(other.m_floatNormals);
+	    m_random = std::move(other.m_random);
+	    m_generation = other.m_generation;
+	    m_shapeGeneration = other.m_shapeGeneration;
 	}
 	return *this;
     }
@@ -92,52 +128,133 @@ namespace sfa
 
     Vertex Model::getVertex(unsigned int n) const
     {
-	if (n >= getAmountOfVertices())
-	{
-	    std::stringstream msg;
-	    msg << "Vertex number out of bounds: " << n;
-	    throw std::out_of_range(msg.str());
-	}
-	return m_vertices[n];
+	checkBounds(n);
+	Vertex vertex;
+	vertex.id = n;
+	vertex.coords = getPositions().col(n);
+	vertex.normal = getNormals().col(n);
+	vertex.neighbors = m_topology->neighbors.getNeighbors(n);
+	vertex.baseVertices = m_topology->baseVertices.getNeighbors(n);
+	vertex.isEdge = m_topology->boundary.isBoundary(n);
+	return vertex;
     }
 
-    std::vector<Vertex> const& Model::getVertices() const
+    Eigen::Vector3d Model::getCoords(unsigned int n) const
     {
-	return m_vertices;
+	checkBounds(n);
+	return Eigen::Map<Eigen::Vector3d const>(&m_positions[3 * n]);
     }
 
-    dbgl::KdTree<unsigned int, dbgl::Vec3d> const& Model::getVertexTree() const
+    Eigen::Vector3d Model::getNormal(unsigned int n) const
     {
-	return m_vertexTree;
+	checkBounds(n);
+	return Eigen::Map<Eigen::Vector3d const>(&m_normals[3 * n]);
     }
 
-    void Model::setVertex(unsigned int n, Eigen::Vector3d const& coords, Eigen::Vector3d const& normal)
+    bool Model::isEdge(unsigned int n) const
     {
-	if (n >= getAmountOfVertices())
+	checkBounds(n);
+	return m_topology->boundary.isBoundary(n);
+    }
+
+    Eigen::Map<Eigen::Matrix3Xd const> Model::getPositions() const
+    {
+	return Eigen::Map<Eigen::Matrix3Xd const>(m_positions.data(), 3, getAmountOfVertices());
+    }
+
+    Eigen::Map<Eigen::Matrix3Xd const> Model::getNormals() const
+    {
+	return Eigen::Map<Eigen::Matrix3Xd const>(m_normals.data(), 3, getAmountOfVertices());
+    }
+
+    Adjacency const& Model::getAdjacency() const
+    {
+	return m_topology->neighbors;
+    }
+
+    Adjacency const& Model::getBaseVertices() const
+    {
+	return m_topology->baseVertices;
+    }
+
+    std::vector<std::vector<uint32_t>> const& Model::getBoundaryLoops() const
+    {
+	return m_topology->boundary.getLoops();
+    }
+
+    Eigen::Map<Eigen::Matrix3Xf const> Model::getFloatPositions() const
+    {
+	return Eigen::Map<Eigen::Matrix3Xf const>(m_floatPositions.data(), 3, m_floatPositions.size() / 3);
+    }
+
+    Eigen::Map<Eigen::Matrix3Xf const> Model::getFloatNormals() const
+    {
+	return Eigen::Map<Eigen::Matrix3Xf const>(m_floatNormals.data(), 3, m_floatNormals.size() / 3);
+    }
+
+    bool Model::hasFloatData() const
+    {
+	return m_floatData;
+    }
+
+    void Model::setFloatData(bool enabled)
+    {
+	m_floatData = enabled;
+	if (!enabled)
 	{
-	    std::stringstream msg;
-	    msg << "Vertex number out of bounds: " << n;
-	    throw std::out_of_range(msg.str());
+	    m_floatPositions.clear();
+	    m_floatPositions.shrink_to_fit();
+	    m_floatNormals.clear();
+	    m_floatNormals.shrink_to_fit();
+	    return;
 	}
+	m_floatPositions.resize(m_positions.size());
+	m_floatNormals.resize(m_normals.size());
+	for (unsigned int i = 0; i < getAmountOfVertices(); i++)
+	    updateFloatData(i);
+    }
+
+    dbgl::KdTree<unsigned int, dbgl::Vec3d> const& Model::getVertexTree() const
+    {
+	return *m_vertexTree;
+    }
 
-	// Update model data structure
-	auto vertex = getVertex(n);
+    Eigen::Isometry3d Model::getPose() const
+    {
+	Eigen::Isometry3d pose = Eigen::Isometry3d::Identity();
+	pose.linear() = m_poseRotation;
+	pose.translation() = m_poseTranslation;
+	return pose;
+    }
+
+    Eigen::Vector3d Model::toLocalFrame(Eigen::Vector3d const& coords) const
+    {
+	return m_poseRotation.transpose() * (coords - m_poseTranslation);
+    }
+
+    void Model::setVertex(unsigned int n, Eigen::Vector3d const& coords, Eigen::Vector3d const& normal)
+    {
+	checkBounds(n);
 
 	// Get normal rotation
 	// TODO: This is not correct. While it works for small rotations, it certainly does give
 	// wrong results for bigger ones and will cause normals used by the internal mesh to be noticeably
 	// off. This applies to visual (OpenGL) display, however, the normals used by the ICP implementation
 	// are not affected.
-	auto rot = Eigen::Quaterniond::FromTwoVectors(vertex.normal, normal);
+	Eigen::Map<Eigen::Vector3d> oldCoords(&m_positions[3 * n]);
+	Eigen::Map<Eigen::Vector3d> oldNormal(&m_normals[3 * n]);
+	auto rot = Eigen::Quaterniond::FromTwoVectors(oldNormal, normal);
 	rot.normalize();
 
 	// Store in own data structure
-	vertex.coords = coords;
-	vertex.normal = normal;
-	m_vertices[n] = vertex;
+	oldCoords = coords;
+	oldNormal = normal;
+	updateFloatData(n);
+	m_generation = newGeneration();
+	m_shapeGeneration = m_generation;
 
 	// Pass to base mesh
-	for(auto i : vertex.baseVertices)
+	for(auto i : m_topology->baseVertices.getNeighbors(n))
 	{
 	    m_pMesh->vertices()[i].x() = coords.x();
 	    m_pMesh->vertices()[i].y() = coords.y();
@@ -150,21 +267,61 @@ namespace sfa
 	}
     }
 
+    void Model::applyTransform(Eigen::Matrix3d const& R, Eigen::Vector3d const& t)
+    {
+	unsigned int amount = getAmountOfVertices();
+	Eigen::Map<Eigen::Matrix3Xd> positions(m_positions.data(), 3, amount);
+	Eigen::Map<Eigen::Matrix3Xd> normals(m_normals.data(), 3, amount);
+	unsigned int chunkSize = 4096;
+	unsigned int chunks = (amount + chunkSize - 1) / chunkSize;
+	parallelFor(0, chunks, [&](unsigned int chunk)
+	{
+	    for (unsigned int i = chunk * chunkSize; i < std::min(amount, (chunk + 1) * chunkSize); i++)
+	    {
+		positions.col(i) = R * positions.col(i) + t;
+		normals.col(i) = R * normals.col(i);
+		updateFloatData(i);
+	    }
+	});
+	updateBaseMesh(&R);
+	m_generation = newGeneration();
+
+	// The local frame stays, thus topology and vertex tree remain valid
+	m_poseTranslation = R * m_poseTranslation + t;
+	m_poseRotation = R * m_poseRotation;
+    }
+
+    void Model::setPositions(Eigen::Ref<Eigen::Matrix3Xd const> const& positions)
+    {
+	if (positions.cols() != getAmountOfVertices())
+	    throw std::invalid_argument("Amount of positions doesn't match the amount of vertices.");
+	Eigen::Map<Eigen::Matrix3Xd>(m_positions.data(), 3, getAmountOfVertices()) = positions;
+	for (unsigned int i = 0; i < getAmountOfVertices(); i++)
+	    updateFloatData(i);
+	updateBaseMesh();
+	m_generation = newGeneration();
+	m_shapeGeneration = m_generation;
+	rebuildVertexTree();
+    }
+
     unsigned int Model::getAmountOfVertices() const
     {
-	return m_vertices.size();
+	return m_positions.size() / 3;
     }
 
     Eigen::Vector3d Model::getAverage() const
     {
-	Eigen::Vector3d average(0, 0, 0);
-	unsigned int amount = getAmountOfVertices();
-	for (unsigned int i = 0; i < amount; i++)
-	{
-	    average += getVertex(i).coords;
-	}
-	average /= amount;
-	return average;
+	return getPositions().rowwise().mean();
+    }
+
+    unsigned int Model::getGeneration() const
+    {
+	return m_generation;
+    }
+
+    unsigned int Model::getShapeGeneration() const
+    {
+	return m_shapeGeneration;
     }
 
     void Model::refresh()
@@ -177,26 +334,43 @@ namespace sfa
 	// Initialize random number generator
 	std::uniform_real_distribution<float> rand_float(-0.05f, 0.05f);
 	// Iterate all vertices and translate them randomly along their normal
+	Eigen::Matrix3Xd positions = getPositions();
 	for(unsigned int i = 0; i < getAmountOfVertices(); i++)
-	{
-	    auto vertex = getVertex(i);
-	    auto coeff = rand_float(m_random);
-	    auto newCoords = vertex.coords + coeff * vertex.normal;
-	    setVertex(vertex.id, newCoords, vertex.normal);
-	}
+	    positions.col(i) += rand_float(m_random) * getNormals().col(i);
+	setPositions(positions);
     }
 
     void Model::addHole()
     {
+	addHoles(1);
+    }
+
+    void Model::addHoles(unsigned int amount, unsigned int radius)
+    {
+	unsigned int vertices = getAmountOfVertices();
+	if (vertices == 0)
+	    return;
 	// Initialize random number generator
-	std::uniform_int_distribution<uint32_t> rand_uint_0_vertices(0, getAmountOfVertices() - 1);
-	// Generate index of vertex to remove
-	auto index = rand_uint_0_vertices(m_random);
-	// Note: we need to iterate from high indices to low indices since every removed vertex will invalidate
-	// every other vertex with an index higher than their own index. Indices are then regenerated in analyzeMesh().
-	for(auto it = m_vertices[index].baseVertices.rbegin(); it != m_vertices[index].baseVertices.rend(); ++it)
-	    m_pMesh->removeVertex(*it);
-	analyzeMesh();
+	std::uniform_int_distribution<uint32_t> rand_uint_0_vertices(0, vertices - 1);
+	std::vector<char> removed(vertices, false);
+	unsigned int amountRemoved = 0;
+	std::vector<uint32_t> ring;
+	for (unsigned int i = 0; i < amount && amountRemoved < vertices; i++)
+	{
+	    // Generate index of a vertex that still exists
+	    auto index = rand_uint_0_vertices(m_random);
+	    while (removed[index])
+		index = rand_uint_0_vertices(m_random);
+	    m_topology->neighbors.getRing(index, radius, ring);
+	    ring.push_back(index);
+	    for (auto n : ring)
+	    {
+		if (!removed[n])
+		    amountRemoved++;
+		removed[n] = true;
+	    }
+	}
+	removeVertices(removed);
     }
 
     double Model::rotateRandom(double maxAngle, double minAngle)
@@ -210,16 +384,7 @@ namespace sfa
 	Eigen::Vector3d axis = Eigen::Vector3d::Random();
 	axis.normalize();
 	Eigen::AngleAxis<double> aa(angle, axis);
-	Eigen::Quaterniond quat(aa);
-	for(unsigned int i = 0; i < getAmountOfVertices(); i++)
-	{
-	    auto coords = getVertex(i).coords;
-	    coords = quat * coords;
-	    auto normal = getVertex(i).normal;
-	    normal = quat * normal;
-	    setVertex(i, coords, normal);
-	}
-	analyzeMesh();
+	applyTransform(aa.toRotationMatrix(), Eigen::Vector3d::Zero());
 	return angle;
     }
 
@@ -230,9 +395,7 @@ namespace sfa
 	Eigen::Vector3d translationVec = Eigen::Vector3d::Random();
 	translationVec.normalize();
 	translationVec *= translation;
-	for(unsigned int i = 0; i < m_pMesh->vertices().size(); i++)
-	    m_pMesh->vertices()[i].translate(translationVec[0], translationVec[1], translationVec[2]);
-	analyzeMesh();
+	applyTransform(Eigen::Matrix3d::Identity(), translationVec);
 	return translation;
     }
 
@@ -241,125 +404,215 @@ namespace sfa
 	return m_pMesh;
     }
 
-    void Model::analyzeMesh()
+    void Model::saveSnapshot(Snapshot& snapshot) const
     {
-	// Clear any previous results
-	m_vertices.clear();
-	m_vertexTree.clear();
-	m_baseIndex2ModelIndex.clear();
+	// Assigning to the existing buffers reuses their memory
+	snapshot.m_positions.assign(m_positions.begin(), m_positions.end());
+	snapshot.m_normals.assign(m_normals.begin(), m_normals.end());
+	snapshot.m_floatPositions.assign(m_floatPositions.begin(), m_floatPositions.end());
+	snapshot.m_floatNormals.assign(m_floatNormals.begin(), m_floatNormals.end());
+	snapshot.m_baseVertices.assign(m_pMesh->getVertices().begin(), m_pMesh->getVertices().end());
+	snapshot.m_baseNormals.assign(m_pMesh->getNormals().begin(), m_pMesh->getNormals().end());
+	snapshot.m_vertexTree = m_vertexTree;
+	snapshot.m_poseRotation = m_poseRotation;
+	snapshot.m_poseTranslation = m_poseTranslation;
+	snapshot.m_random = m_random;
+	snapshot.m_generation = m_generation;
+	snapshot.m_shapeGeneration = m_shapeGeneration;
+    }
 
-	// Add all vertices
-	for (unsigned int i = 0; i < m_pMesh->getVertices().size(); i++)
+    void Model::restoreSnapshot(Snapshot const& snapshot)
+    {
+	if (snapshot.m_positions.size() != m_positions.size()
+		|| snapshot.m_baseVertices.size() != m_pMesh->getVertices().size())
+	    throw std::invalid_argument("Snapshot doesn't match the topology of the model.");
+	std::copy(snapshot.m_positions.begin(), snapshot.m_positions.end(), m_positions.begin());
+	std::copy(snapshot.m_normals.begin(), snapshot.m_normals.end(), m_normals.begin());
+	std::copy(snapshot.m_baseVertices.begin(), snapshot.m_baseVertices.end(), m_pMesh->vertices().begin());
+	std::copy(snapshot.m_baseNormals.begin(), snapshot.m_baseNormals.end(), m_pMesh->normals().begin());
+	if (m_floatData && snapshot.m_floatPositions.size() == m_positions.size())
 	{
-	    auto vertex = m_pMesh->getVertices()[i];
-	    auto normal = m_pMesh->getNormals()[i];
+	    std::copy(snapshot.m_floatPositions.begin(), snapshot.m_floatPositions.end(), m_floatPositions.begin());
+	    std::copy(snapshot.m_floatNormals.begin(), snapshot.m_floatNormals.end(), m_floatNormals.begin());
+	}
+	else
+	    setFloatData(m_floatData);
+	m_vertexTree = snapshot.m_vertexTree;
+	m_poseRotation = snapshot.m_poseRotation;
+	m_poseTranslation = snapshot.m_poseTranslation;
+	m_random = snapshot.m_random;
+	m_generation = snapshot.m_generation;
+	m_shapeGeneration = snapshot.m_shapeGeneration;
+    }
 
-	    // Check if there already is a vertex with the same coordinates
-	    auto dbglCoords = dbgl::Vec3d(vertex.x(), vertex.y(), vertex.z());
-	    auto pVertId = m_vertexTree.getSimilar(dbglCoords, 0.0001);
-	    if(pVertId != nullptr)
-	    {
-		// Average normals
-		m_vertices[*pVertId].normal += Eigen::Vector3d(normal.x(), normal.y(), normal.z());
-		// Add base vertex id
-		m_vertices[*pVertId].baseVertices.insert(i);
-		// Create a list base index -> this index
-		m_baseIndex2ModelIndex.push_back(*pVertId);
-	    }
-	    else
-	    {
-		Vertex vert;
-		vert.id = m_vertices.size();
-		vert.coords = Eigen::Vector3d(vertex.x(), vertex.y(), vertex.z());
-		vert.normal = Eigen::Vector3d(normal.x(), normal.y(), normal.z());
-		vert.baseVertices.insert(i);
-		m_vertices.push_back(vert);
-		m_vertexTree.insert(dbglCoords, vert.id);
-		// Create a list base index -> this index
-		m_baseIndex2ModelIndex.push_back(vert.id);
-	    }
+    void Model::analyzeMesh()
+    {
+	// Clear any previous results
+	m_positions.clear();
+	m_normals.clear();
+	m_generation = newGeneration();
+	m_shapeGeneration = m_generation;
+	// Copies of this model may still use the old topology, thus build a new one
+	auto topology = std::make_shared<Topology>();
+
+	// Merge vertices with the same coordinates
+	auto const& baseVertices = m_pMesh->getVertices();
+	auto const& baseNormals = m_pMesh->getNormals();
+	std::vector<double> basePositions(3 * baseVertices.size());
+	for (unsigned int i = 0; i < baseVertices.size(); i++)
+	{
+	    for (unsigned int j = 0; j < 3; j++)
+		basePositions[3 * i + j] = baseVertices[i][j];
+	}
+	VertexWelder welder;
+	welder.weld(basePositions, 0.0001);
+	topology->baseIndex2ModelIndex = welder.getMapping();
+	unsigned int amount = welder.getAmountOfVertices();
+	topology->baseVertices.buildFromGroups(amount, topology->baseIndex2ModelIndex);
+
+	// Take coordinates from the first base vertex and average normals
+	m_positions.resize(3 * amount);
+	m_normals.assign(3 * amount, 0);
+	for (unsigned int i = 0; i < amount; i++)
+	{
+	    for (unsigned int j = 0; j < 3; j++)
+		m_positions[3 * i + j] = basePositions[3 * welder.getRepresentatives()[i] + j];
 	}
-	// Normalize all normals
-	for(auto& vert : m_vertices)
-	    vert.normal.normalize();
+	for (unsigned int i = 0; i < baseNormals.size(); i++)
+	{
+	    for (unsigned int j = 0; j < 3; j++)
+		m_normals[3 * topology->baseIndex2ModelIndex[i] + j] += baseNormals[i][j];
+	}
+	Eigen::Map<Eigen::Matrix3Xd> normals(m_normals.data(), 3, amount);
+	for (unsigned int i = 0; i < amount; i++)
+	    normals.col(i).normalize();
 
-	// Balance the tree for maximum performance
-	m_vertexTree.balance();
+	// Build the tree from the welded vertices only
+	rebuildVertexTree();
+
+	// Compute neighbors and edge vertices
+	computeConnectivity(*topology, amount);
+	m_topology = topology;
 
+	// Single precision copies
+	setFloatData(m_floatData);
+    }
+
+    void Model::computeConnectivity(Topology& topology, unsigned int amount) const
+    {
 	// Compute neighbors
-	for (unsigned int i = 0; i < m_pMesh->getIndices().size(); i += 3)
+	auto const& indices = m_pMesh->getIndices();
+	std::vector<uint32_t> triangles(indices.size());
+	for (unsigned int i = 0; i < indices.size(); i++)
+	    triangles[i] = topology.baseIndex2ModelIndex[indices[i]];
+	topology.neighbors.buildFromTriangles(amount, triangles);
+
+	// Compute edge vertices
+	topology.boundary.build(amount, triangles);
+    }
+
+    void Model::removeVertices(std::vector<char> const& removed)
+    {
+	// Note: we need to iterate from high indices to low indices since every removed vertex will invalidate
+	// every other vertex with an index higher than their own index.
+	auto const& oldBaseIndex2ModelIndex = m_topology->baseIndex2ModelIndex;
+	for (unsigned int i = oldBaseIndex2ModelIndex.size(); i-- > 0;)
 	{
-	    m_vertices[m_baseIndex2ModelIndex[m_pMesh->getIndices()[i + 0]]].neighbors.insert(
-		    m_baseIndex2ModelIndex[m_pMesh->getIndices()[i + 1]]);
-	    m_vertices[m_baseIndex2ModelIndex[m_pMesh->getIndices()[i + 0]]].neighbors.insert(
-		    m_baseIndex2ModelIndex[m_pMesh->getIndices()[i + 2]]);
-	    m_vertices[m_baseIndex2ModelIndex[m_pMesh->getIndices()[i + 1]]].neighbors.insert(
-		    m_baseIndex2ModelIndex[m_pMesh->getIndices()[i + 0]]);
-	    m_vertices[m_baseIndex2ModelIndex[m_pMesh->getIndices()[i + 1]]].neighbors.insert(
-		    m_baseIndex2ModelIndex[m_pMesh->getIndices()[i + 2]]);
-	    m_vertices[m_baseIndex2ModelIndex[m_pMesh->getIndices()[i + 2]]].neighbors.insert(
-		    m_baseIndex2ModelIndex[m_pMesh->getIndices()[i + 0]]);
-	    m_vertices[m_baseIndex2ModelIndex[m_pMesh->getIndices()[i + 2]]].neighbors.insert(
-		    m_baseIndex2ModelIndex[m_pMesh->getIndices()[i + 1]]);
+	    if (removed[oldBaseIndex2ModelIndex[i]])
+		m_pMesh->removeVertex(i);
 	}
 
-	// Compute edge vertices
-	for (unsigned int i = 0; i < m_vertices.size(); i++)
+	// Compact indices once. Vertices keep their order, thus the result is the same as welding again.
+	unsigned int oldAmount = getAmountOfVertices();
+	std::vector<unsigned int> newIndex(oldAmount);
+	unsigned int amount = 0;
+	for (unsigned int n = 0; n < oldAmount; n++)
 	{
-	    if (m_vertices[i].neighbors.empty())
+	    newIndex[n] = amount;
+	    if (removed[n])
 		continue;
-	    bool isEdge = false;
-	    for(auto it = m_vertices[i].neighbors.begin(); it != m_vertices[i].neighbors.end(); ++it)
+	    for (unsigned int j = 0; j < 3; j++)
 	    {
-		// Usually this should finish on first iteration. Only due to bad luck it might need more.
-		auto start = m_vertices[*it];
-		isEdge = checkEdge(m_vertices[i], start);
-		if(!isEdge)
-		    break;
+		m_positions[3 * amount + j] = m_positions[3 * n + j];
+		m_normals[3 * amount + j] = m_normals[3 * n + j];
 	    }
-
-	    m_vertices[i].isEdge = isEdge;
+	    amount++;
 	}
+	m_positions.resize(3 * amount);
+	m_normals.resize(3 * amount);
+	auto topology = std::make_shared<Topology>();
+	for (auto n : oldBaseIndex2ModelIndex)
+	{
+	    if (!removed[n])
+		topology->baseIndex2ModelIndex.push_back(newIndex[n]);
+	}
+	topology->baseVertices.buildFromGroups(amount, topology->baseIndex2ModelIndex);
+	computeConnectivity(*topology, amount);
+	m_topology = topology;
+	m_generation = newGeneration();
+	m_shapeGeneration = m_generation;
+
+	rebuildVertexTree();
+	setFloatData(m_floatData);
     }
 
-    bool Model::checkEdge(Vertex base, Vertex start)
-    {
-	std::map<unsigned int, bool> checked;
-	for(auto neighbor : base.neighbors)
-	    checked[neighbor] = false;
-	checked[start.id] = true;
-	return checkEdge(base, start, start, start, checked);
-    }
-
-    bool Model::checkEdge(Vertex base, Vertex start, Vertex begin, Vertex last,
-	    std::map<unsigned int, bool> checked)
+    void Model::updateBaseMesh(Eigen::Matrix3d const* pRotation)
     {
-	// Get a vertex that is both a neighbor of base and start and different than last
-	for (auto it = start.neighbors.begin(); it != start.neighbors.end(); ++it)
+	unsigned int amount = m_topology->baseIndex2ModelIndex.size();
+	unsigned int chunkSize = 4096;
+	unsigned int chunks = (amount + chunkSize - 1) / chunkSize;
+	parallelFor(0, chunks, [&](unsigned int chunk)
 	{
-	    // If the neighbors neighbor is the beginning but not the one we just came from
-	    // then there is a way of circling base through their neighbors
-	    if(*it == begin.id && *it != last.id)
-		return false;
-	    // If the neighbor has already been used don't use it again
-	    if(checked[*it])
-		continue;
-	    for (auto it2 = base.neighbors.begin(); it2 != base.neighbors.end(); ++it2)
+	    for (unsigned int i = chunk * chunkSize; i < std::min(amount, (chunk + 1) * chunkSize); i++)
 	    {
-		if (*it == *it2)
+		unsigned int n = m_topology->baseIndex2ModelIndex[i];
+		auto& vertex = m_pMesh->vertices()[i];
+		vertex.x() = m_positions[3 * n];
+		vertex.y() = m_positions[3 * n + 1];
+		vertex.z() = m_positions[3 * n + 2];
+		if (pRotation)
 		{
-		    // Found a match
-		    checked[*it] = true;
-		    // Check the next vertex
-		    bool isEdge = checkEdge(base, m_vertices[*it], begin, start, checked);
-		    // If checkEdge returns true there might still be a different "path" to prove
-		    // that it's no edge, thus we continue iterating
-		    if (!isEdge)
-			return false;
+		    auto& normal = m_pMesh->normals()[i];
+		    Eigen::Vector3d newNormal = *pRotation * Eigen::Vector3d(normal.x(), normal.y(), normal.z());
+		    normal.x() = newNormal[0];
+		    normal.y() = newNormal[1];
+		    normal.z() = newNormal[2];
 		}
 	    }
+	});
+    }
+
+    void Model::rebuildVertexTree()
+    {
+	// Copies of this model may still use the old tree, thus build a new one
+	auto tree = std::make_shared<dbgl::KdTree<unsigned int, dbgl::Vec3d>>();
+	for (unsigned int i = 0; i < getAmountOfVertices(); i++)
+	    tree->insert(dbgl::Vec3d(m_positions[3 * i], m_positions[3 * i + 1], m_positions[3 * i + 2]), i);
+	// Balance the tree for maximum performance
+	tree->balance();
+	m_vertexTree = tree;
+	m_poseRotation.setIdentity();
+	m_poseTranslation.setZero();
+    }
+
+    void Model::updateFloatData(unsigned int n)
+    {
+	if (!m_floatData)
+	    return;
+	for (unsigned int j = 0; j < 3; j++)
+	{
+	    m_floatPositions[3 * n + j] = m_positions[3 * n + j];
+	    m_floatNormals[3 * n + j] = m_normals[3 * n + j];
+	}
+    }
+
+    void Model::checkBounds(unsigned int n) const
+    {
+	if (n >= getAmountOfVertices())
+	{
+	    std::stringstream msg;
+	    msg << "Vertex number out of bounds: " << n;
+	    throw std::out_of_range(msg.str());
 	}
-	// If we get here the algorithm has not found a proper way
-	return true;
     }
 }
@@ -0,0 +1,82 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Face Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include <stdexcept>
+#include <cmath>
+#include <assert.h>
+#include <Eigen/Geometry>
+#include <DBGL/System/Log/Log.h>
+#include <SFA/Utility/Log.h>
+#include <SFA/Utility/Model.h>
+#include <SFA/NearestNeighbor/KdTreeNearestNeighbor.h>
+#include <SFA/ICP/BranchAndBoundICP.h>
+#include <SFA/ICP/RigidPlaneICP.h>
+
+using namespace sfa;
+
+void testBranchAndBoundICP()
+{
+    LOG.info("Starting BranchAndBoundICP test suite...");
+
+    Model dest("Resources/Generic_Face_Lowpoly.obj", true);
+    Model src(dest);
+    Eigen::Isometry3d applied = Eigen::Isometry3d::Identity();
+    applied.rotate(Eigen::AngleAxisd(2.8, Eigen::Vector3d(-1, 1, 2).normalized()));
+    applied.pretranslate(Eigen::Vector3d(0.2, 0.2, -0.1));
+    src.applyTransform(applied.linear(), applied.translation());
+
+    // Check error
+    KdTreeNearestNeighbor nn;
+    auto startError = nn.computeError(src, dest);
+    LOG.info("Matching error: %{20}", startError);
+
+    // Global alignment followed by regular ICP
+    Log log;
+    BranchAndBoundICP icp(&log);
+    icp.setSamples(30);
+    icp.setResolution(64);
+    icp.setThreshold(0.002);
+    // The search certifies the applied pose within the threshold, well before it would have
+    // to evaluate every cube up to the finest level
+    Eigen::Isometry3d residual = icp.findPose(src, dest) * applied;
+    unsigned int cubes = icp.getEvaluatedCubes();
+    LOG.info("Evaluated cubes: %, gap: %, residual rotation: %, residual translation: %", cubes, icp.getGap(),
+	    Eigen::AngleAxisd(residual.linear()).angle(), residual.translation().norm());
+    assert(cubes > 0 && cubes < icp.getMaxCubes());
+    assert(icp.getGap() <= icp.getThreshold());
+    assert(Eigen::AngleAxisd(residual.linear()).angle() < 0.1);
+    assert(residual.translation().norm() < 0.1);
+
+    // Alignment is done once per reset and deterministic, then refined by regular ICP
+    assert(icp.calcNextStep(src, dest) == 30);
+    assert(icp.getEvaluatedCubes() == cubes);
+    assert(icp.calcNextStep(src, dest) == 0);
+
+    // A search cut short by the cube budget reports what is left to certify
+    BranchAndBoundICP limited;
+    limited.setSamples(30);
+    limited.setResolution(64);
+    limited.setThreshold(0.002);
+    limited.setMaxCubes(16);
+    Model moved(dest);
+    moved.applyTransform(applied.linear(), applied.translation());
+    limited.findPose(moved, dest);
+    LOG.info("Evaluated cubes: %, gap: %", limited.getEvaluatedCubes(), limited.getGap());
+    assert(limited.getEvaluatedCubes() == 16);
+    assert(limited.getGap() > limited.getThreshold());
+    auto error = nn.computeError(src, dest);
+    LOG.info("Matching error: %{20}", error);
+    RigidPlaneICP planeICP(nn);
+    for (unsigned int i = 0; i < 3; i++)
+	planeICP.calcNextStep(src, dest);
+    error = nn.computeError(src, dest);
+    LOG.info("Matching error: %{20}", error);
+    assert(error < startError / 100);
+}
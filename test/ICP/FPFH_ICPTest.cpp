@@ -0,0 +1,68 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Face Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include <stdexcept>
+#include <cmath>
+#include <assert.h>
+#include <Eigen/Geometry>
+#include <DBGL/System/Log/Log.h>
+#include <SFA/Utility/Model.h>
+#include <SFA/NearestNeighbor/KdTreeNearestNeighbor.h>
+#include <SFA/ICP/FPFH_ICP.h>
+#include <SFA/ICP/RigidPlaneICP.h>
+
+using namespace sfa;
+
+void testFPFH_ICP()
+{
+    LOG.info("Starting FPFH_ICP test suite...");
+
+    Model dest("Resources/Generic_Face_Lowpoly.obj", true);
+    Model src(dest);
+    Eigen::Isometry3d applied = Eigen::Isometry3d::Identity();
+    applied.rotate(Eigen::AngleAxisd(2.5, Eigen::Vector3d(1, 2, -1).normalized()));
+    applied.pretranslate(Eigen::Vector3d(0.3, -0.2, 0.3));
+    src.applyTransform(applied.linear(), applied.translation());
+
+    // Features don't depend on the pose
+    FPFH_ICP icp;
+    FPFH_ICP::Features srcFeatures, destFeatures;
+    icp.computeFeatures(src, srcFeatures);
+    icp.computeFeatures(dest, destFeatures);
+    assert((srcFeatures - destFeatures).cwiseAbs().maxCoeff() < 1e-3);
+
+    // Check error
+    KdTreeNearestNeighbor nn;
+    auto startError = nn.computeError(src, dest);
+    LOG.info("Matching error: %{20}", startError);
+
+    // RANSAC finds the inverse of the applied pose with most selected vertices as inliers
+    icp.setSeed(42);
+    unsigned int inliers = 0;
+    Eigen::Isometry3d residual = icp.findPose(src, dest, &inliers) * applied;
+    LOG.info("Inliers: %, residual rotation: %, residual translation: %", inliers,
+	    Eigen::AngleAxisd(residual.linear()).angle(), residual.translation().norm());
+    assert(inliers > src.getAmountOfVertices() / 2);
+    assert(Eigen::AngleAxisd(residual.linear()).angle() < 0.05);
+    assert(residual.translation().norm() < 0.05);
+
+    // Global alignment is done once per reset, then refined by regular ICP
+    icp.setSeed(42);
+    assert(icp.calcNextStep(src, dest) == inliers);
+    assert(icp.calcNextStep(src, dest) == 0);
+    auto error = nn.computeError(src, dest);
+    LOG.info("Matching error: %{20}", error);
+    RigidPlaneICP planeICP(nn);
+    for (unsigned int i = 0; i < 3; i++)
+	planeICP.calcNextStep(src, dest);
+    error = nn.computeError(src, dest);
+    LOG.info("Matching error: %{20}", error);
+    assert(error < startError / 100);
+}
@@ -0,0 +1,89 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Face Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include <stdexcept>
+#include <atomic>
+#include <assert.h>
+#include <DBGL/System/Log/Log.h>
+#include <SFA/Utility/Log.h>
+#include <SFA/Utility/Model.h>
+#include <SFA/Utility/TriangleMesh.h>
+#include <SFA/NearestNeighbor/KdTreeNearestNeighbor.h>
+#include <SFA/NearestNeighbor/TriangleMeshNearestNeighbor.h>
+#include <SFA/ICP/RigidPlaneICP.h>
+#include <SFA/ICP/GeneralizedICP.h>
+
+using namespace sfa;
+
+// Heap allocations of all threads while counting is enabled, see AllocationCounter.cpp
+extern std::atomic<bool> g_countAllocations;
+extern std::atomic<unsigned int> g_allocations;
+
+void testGeneralizedICP()
+{
+    LOG.info("Starting GeneralizedICP test suite...");
+
+    // Load models
+    Model src("Resources/Generic_Face_Lowpoly_Transformed.obj", true);
+    Model dest("Resources/Generic_Face_Lowpoly.obj", true);
+    Model planeSrc(src);
+
+    // Check error
+    KdTreeNearestNeighbor nn;
+    auto startError = nn.computeError(src, dest);
+    auto error = startError;
+    LOG.info("Matching error: %{20}", startError);
+
+    // Do ICP
+    GeneralizedICP icp(nn);
+    for(unsigned int i = 0; i < 3; i++)
+    {
+	// Calculate next step
+	icp.calcNextStep(src, dest);
+
+	// Check error
+	error = nn.computeError(src, dest);
+	LOG.info("Matching error: %{20}", error);
+    }
+    assert(error < startError);
+
+    // Covariances of both meshes are computed once, the own transformations don't invalidate them
+    assert(icp.getCovarianceComputations() == 2);
+
+    // Any other modification of the source forces a recomputation of its covariances only
+    auto vertex = src.getVertex(0);
+    src.setVertex(0, vertex.coords, vertex.normal);
+    icp.calcNextStep(src, dest);
+    assert(icp.getCovarianceComputations() == 3);
+    icp.calcNextStep(src, dest);
+    assert(icp.getCovarianceComputations() == 3);
+
+    // Matching surface against surface converges faster than matching points against planes
+    RigidPlaneICP planeICP(nn);
+    for(unsigned int i = 0; i < 3; i++)
+	planeICP.calcNextStep(planeSrc, dest);
+    auto planeError = nn.computeError(planeSrc, dest);
+    LOG.info("Point-to-plane matching error: %{20}", planeError);
+    assert(error < planeError);
+
+    // Steps don't allocate once everything has been set up
+    TriangleMesh meshSrc("Resources/Generic_Face_Lowpoly_Transformed.obj");
+    TriangleMesh meshDest("Resources/Generic_Face_Lowpoly.obj");
+    TriangleMeshNearestNeighbor meshNN;
+    GeneralizedICP meshICP(meshNN);
+    for(unsigned int i = 0; i < 3; i++)
+	meshICP.calcNextStep(meshSrc, meshDest);
+    g_allocations = 0;
+    g_countAllocations = true;
+    for(unsigned int i = 0; i < 3; i++)
+	meshICP.calcNextStep(meshSrc, meshDest);
+    g_countAllocations = false;
+    assert(g_allocations == 0);
+}
@@ -0,0 +1,92 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Face Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+
+#include <stdexcept>
+#include <atomic>
+#include <assert.h>
+#include <DBGL/System/Log/Log.h>
+#include <SFA/Utility/Model.h>
+#include <SFA/Utility/TriangleMesh.h>
+#include <SFA/NearestNeighbor/KdTreeNearestNeighbor.h>
+#include <SFA/NearestNeighbor/TriangleMeshNearestNeighbor.h>
+#include <SFA/ICP/RigidPointICP.h>
+#include <SFA/ICP/RigidPlaneICP.h>
+#include <SFA/ICP/KernelICP.h>
+
+using namespace sfa;
+
+// Heap allocations of all threads while counting is enabled, see AllocationCounter.cpp
+extern std::atomic<bool> g_countAllocations;
+extern std::atomic<unsigned int> g_allocations;
+
+void testKernelICP()
+{
+    LOG.info("Starting KernelICP test suite...");
+
+    // Load models
+    Model src("Resources/Plane_Transformed.obj");
+    Model dest("Resources/Plane.obj");
+
+    // Check error
+    KdTreeNearestNeighbor nn;
+    auto startError = nn.computeError(src, dest);
+    auto error = startError;
+    LOG.info("Matching error: %{20}", startError);
+
+    // Specialized kernel gives exactly the same results as the pipeline
+    Model reference(src);
+    KernelICP<Model, KdTreeNearestNeighbor, PointToPointSolver> icp(nn);
+    RigidPointICP referenceICP(nn);
+    icp.setSelectionMethod(ICP::PointSelection::NO_EDGES);
+    referenceICP.setSelectionMethod(ICP::PointSelection::NO_EDGES);
+    for(unsigned int i = 0; i < 3; i++)
+    {
+	// Calculate next step
+	assert(icp.calcNextStep(src, dest) == referenceICP.calcNextStep(reference, dest));
+	assert(icp.getCorrespondences().size() > 0);
+	for(unsigned int j = 0; j < src.getAmountOfVertices(); j++)
+	    assert(src.getCoords(j) == reference.getCoords(j) && src.getNormal(j) == reference.getNormal(j));
+
+	// Check error
+	error = nn.computeError(src, dest);
+	LOG.info("Matching error: %{20}", error);
+    }
+    assert(error < startError);
+
+    // Generic instantiation works on any mesh and nearest neighbor type
+    Model generic("Resources/Plane.obj");
+    generic.rotateRandom(0.1);
+    Model genericReference(generic);
+    KernelICP<AbstractMesh, NearestNeighbor, PointToPlaneSolver> genericICP(nn);
+    RigidPlaneICP genericReferenceICP(nn);
+    genericICP.setThreads(1);
+    genericReferenceICP.setThreads(4);
+    for(unsigned int i = 0; i < 2; i++)
+    {
+	assert(genericICP.calcNextStep(generic, dest) == genericReferenceICP.calcNextStep(genericReference, dest));
+	for(unsigned int j = 0; j < generic.getAmountOfVertices(); j++)
+	    assert(generic.getCoords(j) == genericReference.getCoords(j));
+    }
+
+    // Steps don't allocate once everything has been set up
+    TriangleMesh meshSrc("Resources/Plane_Transformed.obj");
+    TriangleMesh meshDest("Resources/Plane.obj");
+    TriangleMeshNearestNeighbor meshNN;
+    KernelICP<TriangleMesh, TriangleMeshNearestNeighbor, PointToPointSolver> meshICP(meshNN);
+    for(unsigned int i = 0; i < 3; i++)
+	meshICP.calcNextStep(meshSrc, meshDest);
+    g_allocations = 0;
+    g_countAllocations = true;
+    for(unsigned int i = 0; i < 3; i++)
+	meshICP.calcNextStep(meshSrc, meshDest);
+    g_countAllocations = false;
+    assert(g_allocations == 0);
+}
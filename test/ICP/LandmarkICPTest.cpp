@@ -0,0 +1,75 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Face Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include <stdexcept>
+#include <cmath>
+#include <assert.h>
+#include <Eigen/Geometry>
+#include <DBGL/System/Log/Log.h>
+#include <SFA/Utility/Model.h>
+#include <SFA/NearestNeighbor/KdTreeNearestNeighbor.h>
+#include <SFA/ICP/LandmarkICP.h>
+#include <SFA/ICP/RigidPlaneICP.h>
+
+using namespace sfa;
+
+void testLandmarkICP()
+{
+    LOG.info("Starting LandmarkICP test suite...");
+
+    Model dest("Resources/Generic_Face_Lowpoly.obj", true);
+    Model src(dest);
+    Eigen::Isometry3d applied = Eigen::Isometry3d::Identity();
+    applied.rotate(Eigen::AngleAxisd(-2.2, Eigen::Vector3d(2, -1, 1).normalized()));
+    applied.pretranslate(Eigen::Vector3d(-0.4, 0.1, 0.2));
+    src.applyTransform(applied.linear(), applied.translation());
+
+    // Curvatures don't depend on the pose (up to float precision of the mesh)
+    LandmarkICP icp;
+    std::vector<LandmarkICP::Curvature> srcCurvatures, destCurvatures;
+    icp.computeCurvatures(src, srcCurvatures);
+    icp.computeCurvatures(dest, destCurvatures);
+    assert(srcCurvatures.size() == dest.getAmountOfVertices());
+    for (unsigned int i = 0; i < srcCurvatures.size(); i++)
+    {
+	assert(std::abs(srcCurvatures[i].max - destCurvatures[i].max) < 1e-3 * (1 + std::abs(destCurvatures[i].max)));
+	assert(std::abs(srcCurvatures[i].min - destCurvatures[i].min) < 1e-3 * (1 + std::abs(destCurvatures[i].min)));
+	assert(srcCurvatures[i].max >= srcCurvatures[i].min);
+    }
+    std::vector<uint32_t> landmarks;
+    icp.findLandmarks(dest, destCurvatures, landmarks);
+    assert(landmarks.size() == icp.getLandmarks());
+
+    // Check error
+    KdTreeNearestNeighbor nn;
+    auto startError = nn.computeError(src, dest);
+    LOG.info("Matching error: %{20}", startError);
+
+    // Most landmarks are found on both meshes and paired up, which recovers the applied pose
+    unsigned int pairs = 0;
+    Eigen::Isometry3d residual = icp.findPose(src, dest, &pairs) * applied;
+    LOG.info("Landmark pairs: %, residual rotation: %, residual translation: %", pairs,
+	    Eigen::AngleAxisd(residual.linear()).angle(), residual.translation().norm());
+    assert(pairs >= icp.getLandmarks() / 2);
+    assert(Eigen::AngleAxisd(residual.linear()).angle() < 0.05);
+    assert(residual.translation().norm() < 0.05);
+
+    // Landmark alignment is done once per reset, then refined by regular ICP
+    assert(icp.calcNextStep(src, dest) == pairs);
+    assert(icp.calcNextStep(src, dest) == 0);
+    auto error = nn.computeError(src, dest);
+    LOG.info("Matching error: %{20}", error);
+    RigidPlaneICP planeICP(nn);
+    for (unsigned int i = 0; i < 3; i++)
+	planeICP.calcNextStep(src, dest);
+    error = nn.computeError(src, dest);
+    LOG.info("Matching error: %{20}", error);
+    assert(error < startError / 100);
+}
@@ -0,0 +1,52 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Face Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include <stdexcept>
+#include <cmath>
+#include <assert.h>
+#include <DBGL/System/Log/Log.h>
+#include <SFA/Utility/Model.h>
+#include <SFA/NearestNeighbor/KdTreeNearestNeighbor.h>
+#include <SFA/ICP/RigidPointICP.h>
+#include <SFA/ICP/MultiStartICP.h>
+
+using namespace sfa;
+
+void testMultiStartICP()
+{
+    LOG.info("Starting MultiStartICP test suite...");
+
+    Model dest("Resources/Generic_Face_Lowpoly.obj", true);
+    Model src(dest);
+    src.rotateRandom(2, 2);
+
+    // Check error
+    KdTreeNearestNeighbor nn;
+    auto startError = nn.computeError(src, dest);
+    LOG.info("Matching error: %{20}", startError);
+
+    // Run multiple starts
+    MultiStartICP<Model> multiStart([&nn]()
+    {
+	return new RigidPointICP(nn);
+    }, nn);
+    multiStart.setStarts(8);
+    multiStart.setMaxAngle(std::acos(-1.0));
+    multiStart.setCheckpointSteps(3);
+    multiStart.setSeed(42);
+    auto result = multiStart.align(src, dest);
+    auto error = nn.computeError(src, dest);
+    LOG.info("Matching error: %{20} (start %, % steps, %s)", error, result.winner, result.steps, result.cpuTime);
+    assert(result.winner < 8);
+    assert(result.steps == 3 * 3);
+    assert(result.cpuTime > 0);
+    assert(std::abs(error - result.error) < 1e-9);
+    assert(error < startError);
+}
@@ -0,0 +1,64 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Face Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include <stdexcept>
+#include <cmath>
+#include <assert.h>
+#include <Eigen/Eigenvalues>
+#include <DBGL/System/Log/Log.h>
+#include <SFA/Utility/Model.h>
+#include <SFA/NearestNeighbor/KdTreeNearestNeighbor.h>
+#include <SFA/ICP/PCA_ICP.h>
+
+using namespace sfa;
+
+void testPCA_ICP()
+{
+    LOG.info("Starting PCA_ICP test suite...");
+
+    Model dest("Resources/Generic_Face_Lowpoly.obj", true);
+    Model src(dest);
+    src.rotateRandom(0.5, 0.5);
+
+    // Check error
+    KdTreeNearestNeighbor nn;
+    auto startError = nn.computeError(src, dest);
+    LOG.info("Matching error: %{20}", startError);
+
+    // A single step aligns all axes
+    PCA_ICP icp;
+    assert(icp.calcNextStep(src, dest) == src.getAmountOfVertices());
+    auto error = nn.computeError(src, dest);
+    LOG.info("Matching error: %{20}", error);
+    assert(error < startError / 10);
+
+    // Further steps do nothing until reset
+    assert(icp.calcNextStep(src, dest) == 0);
+    icp.reset();
+    icp.calcNextStep(src, dest);
+    assert(nn.computeError(src, dest) <= error * 1.01);
+
+    // Flipped poses are recovered by racing all hypotheses. A half turn about the major axis
+    // keeps all principal axes but negates two of them.
+    Eigen::Matrix3Xd positions = dest.getPositions();
+    Eigen::Vector3d center = positions.rowwise().mean();
+    Eigen::Matrix3Xd centered = positions.colwise() - center;
+    Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> solver(centered * centered.transpose());
+    Eigen::Matrix3d halfTurn = Eigen::AngleAxisd(std::acos(-1.0), solver.eigenvectors().col(2)).toRotationMatrix();
+    Model flipped(dest);
+    flipped.applyTransform(halfTurn, center - halfTurn * center);
+    startError = nn.computeError(flipped, dest);
+    LOG.info("Matching error: %{20}", startError);
+    PCA_ICP racing(nn);
+    racing.calcNextStep(flipped, dest);
+    error = nn.computeError(flipped, dest);
+    LOG.info("Matching error: %{20}", error);
+    assert(error < startError / 10);
+}
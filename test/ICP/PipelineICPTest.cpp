@@ -0,0 +1,80 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Face Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+
+#include <stdexcept>
+#include <assert.h>
+#include <DBGL/System/Log/Log.h>
+#include <SFA/Utility/Model.h>
+#include <SFA/NearestNeighbor/KdTreeNearestNeighbor.h>
+#include <SFA/ICP/PipelineICP.h>
+
+using namespace sfa;
+
+void testPipelineICP()
+{
+    LOG.info("Starting PipelineICP test suite...");
+
+    // Correspondence buffer keeps order when removing pairs
+    Correspondences c;
+    c.resize(5);
+    for(unsigned int i = 0; i < c.size(); i++)
+    {
+	assert(c.weight[i] == 1);
+	c.source[i] = i;
+	c.distance[i] = i;
+    }
+    assert(c.removeIf([&](unsigned int i){ return c.source[i] % 2 == 1; }) == 2);
+    assert(c.size() == 3 && c.source[0] == 0 && c.source[1] == 2 && c.source[2] == 4);
+    assert(c.distance[2] == 4);
+
+    // Load models
+    Model src("Resources/Plane_Transformed.obj");
+    Model dest("Resources/Plane.obj");
+
+    // Check error
+    KdTreeNearestNeighbor nn;
+    auto startError = nn.computeError(src, dest);
+    auto error = startError;
+    LOG.info("Matching error: %{20}", startError);
+
+    // Assemble a custom pipeline with outlier rejection and distance based weights
+    NearestNeighborMatcher matcher(nn);
+    PointToPointSolver solver;
+    DistanceRejector rejector(2.5);
+    DistanceWeighter weighter;
+    PipelineICP icp(matcher, solver);
+    icp.addRejector(rejector);
+    icp.setWeighter(&weighter);
+    for(unsigned int i = 0; i < 3; i++)
+    {
+	// Calculate next step
+	unsigned int pairs = icp.calcNextStep(src, dest);
+	assert(pairs == icp.getCorrespondences().size());
+	assert(pairs > 0 && pairs <= src.getAmountOfVertices());
+
+	// Check error
+	error = nn.computeError(src, dest);
+	LOG.info("Matching error: %{20}", error);
+    }
+    assert(error < startError);
+
+    // Distance weights stay within [0,1]
+    auto const& pairs = icp.getCorrespondences();
+    for(unsigned int i = 0; i < pairs.size(); i++)
+	assert(pairs.weight[i] >= 0 && pairs.weight[i] <= 1);
+
+    // Stage times are accumulated and can be reset
+    auto times = icp.getStageTimes();
+    assert(times.matching > 0 && times.solving > 0);
+    assert(times.selection >= 0 && times.rejection >= 0 && times.weighting >= 0 && times.applying >= 0);
+    icp.resetStageTimes();
+    assert(icp.getStageTimes().matching == 0);
+}
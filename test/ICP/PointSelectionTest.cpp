@@ -0,0 +1,92 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Face Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include <stdexcept>
+#include <assert.h>
+#include <DBGL/System/Log/Log.h>
+#include <SFA/Utility/Model.h>
+#include <SFA/NearestNeighbor/KdTreeNearestNeighbor.h>
+#include <SFA/ICP/RigidPointICP.h>
+
+using namespace sfa;
+
+void testPointSelection()
+{
+    LOG.info("Starting point selection test suite...");
+
+    Model model("Resources/Plane.obj");
+    KdTreeNearestNeighbor nn;
+    RigidPointICP icp(nn);
+
+    // Without any filter all points are selected in order
+    auto all = icp.selectIndices(model);
+    assert(all.size() == model.getAmountOfVertices());
+    for (unsigned int i = 0; i < all.size(); i++)
+	assert(all[i] == i);
+
+    // Stride and edge filters
+    icp.setSelectionMethod(ICP::EVERY_SECOND | ICP::NO_EDGES);
+    auto filtered = icp.selectIndices(model);
+    assert(!filtered.empty() && filtered.size() < all.size() / 2);
+    for (auto i : filtered)
+	assert(i % 2 != 0 && !model.getVertex(i).isEdge);
+
+    // Percentage picks exactly the requested amount, sorted and without duplicates
+    icp.setSelectionMethod(0);
+    icp.setSelectionPercentage(0.25);
+    icp.setSeed(42);
+    auto first = icp.selectIndices(model);
+    assert(first.size() == static_cast<unsigned int>(std::floor(model.getAmountOfVertices() * 0.25 + 0.5)));
+    for (unsigned int i = 1; i < first.size(); i++)
+	assert(first[i - 1] < first[i]);
+
+    // Same seed, same selection
+    icp.setSeed(42);
+    auto second = icp.selectIndices(model);
+    assert(first == second);
+
+    // Normal-space sampling also picks exactly the requested amount and is reproducible
+    Model face("Resources/Generic_Face_Lowpoly.obj", true);
+    icp.setSelectionMethod(ICP::NORMAL_SPACE);
+    icp.setSelectionPercentage(0.1);
+    icp.setSeed(7);
+    auto normalSpace = icp.selectIndices(face);
+    assert(normalSpace.size() == static_cast<unsigned int>(std::floor(face.getAmountOfVertices() * 0.1 + 0.5)));
+    for (unsigned int i = 1; i < normalSpace.size(); i++)
+	assert(normalSpace[i - 1] < normalSpace[i]);
+    icp.setSeed(7);
+    assert(normalSpace == icp.selectIndices(face));
+
+    // Covariance sampling respects the budget and constrains all six degrees of freedom
+    icp.setSelectionMethod(ICP::COVARIANCE);
+    icp.setSelectionPercentage(1);
+    icp.setSelectionBudget(100);
+    auto stable = icp.selectIndices(face);
+    assert(stable.size() == 100);
+    for (unsigned int i = 1; i < stable.size(); i++)
+	assert(stable[i - 1] < stable[i]);
+    auto conditionOf = [&face](std::vector<uint32_t> const& indices)
+    {
+	Eigen::Matrix<double, 6, 6> covariance = Eigen::Matrix<double, 6, 6>::Zero();
+	for (auto i : indices)
+	{
+	    Eigen::Matrix<double, 6, 1> c;
+	    c << face.getVertex(i).coords.cross(face.getVertex(i).normal), face.getVertex(i).normal;
+	    covariance += c * c.transpose();
+	}
+	Eigen::SelfAdjointEigenSolver<Eigen::Matrix<double, 6, 6>> solver(covariance);
+	return solver.eigenvalues()(5) / solver.eigenvalues()(0);
+    };
+    icp.setSelectionMethod(0);
+    icp.setSelectionPercentage(100.0 / face.getAmountOfVertices());
+    auto uniform = icp.selectIndices(face);
+    LOG.info("Condition number: % (covariance) vs. % (uniform)", conditionOf(stable), conditionOf(uniform));
+    assert(conditionOf(stable) < conditionOf(uniform));
+}
@@ -9,15 +9,22 @@
 //////////////////////////////////////////////////////////////////////
 
 #include <stdexcept>
+#include <atomic>
 #include <assert.h>
 #include <DBGL/System/Log/Log.h>
 #include <SFA/Utility/Log.h>
 #include <SFA/Utility/Model.h>
+#include <SFA/Utility/TriangleMesh.h>
 #include <SFA/NearestNeighbor/KdTreeNearestNeighbor.h>
+#include <SFA/NearestNeighbor/TriangleMeshNearestNeighbor.h>
 #include <SFA/ICP/RigidPlaneICP.h>
 
 using namespace sfa;
 
+// Heap allocations of all threads while counting is enabled, see AllocationCounter.cpp
+extern std::atomic<bool> g_countAllocations;
+extern std::atomic<unsigned int> g_allocations;
+
 void testRigidPlaneICP()
 {
     LOG.info("Starting RigidPlaneICP test suite...");
@@ -48,7 +55,32 @@ void testRigidPlaneICP()
 	LOG.info("Matching error: %{20}", error);
     }
     assert(error < startError);
-}
-
 
+    // Results don't depend on the amount of threads
+    Model single("Resources/Generic_Face_Lowpoly_Transformed.obj", true);
+    Model multi(single);
+    RigidPlaneICP singleICP(nn);
+    RigidPlaneICP multiICP(nn);
+    singleICP.setThreads(1);
+    multiICP.setThreads(4);
+    for(unsigned int i = 0; i < 2; i++)
+    {
+	assert(singleICP.calcNextStep(single, dest) == multiICP.calcNextStep(multi, dest));
+	for(unsigned int j = 0; j < single.getAmountOfVertices(); j++)
+	    assert(single.getVertex(j).coords == multi.getVertex(j).coords);
+    }
 
+    // Steps don't allocate once everything has been set up
+    TriangleMesh meshSrc("Resources/Generic_Face_Lowpoly_Transformed.obj");
+    TriangleMesh meshDest("Resources/Generic_Face_Lowpoly.obj");
+    TriangleMeshNearestNeighbor meshNN;
+    RigidPlaneICP meshICP(meshNN);
+    for(unsigned int i = 0; i < 3; i++)
+	meshICP.calcNextStep(meshSrc, meshDest);
+    g_allocations = 0;
+    g_countAllocations = true;
+    for(unsigned int i = 0; i < 3; i++)
+	meshICP.calcNextStep(meshSrc, meshDest);
+    g_countAllocations = false;
+    assert(g_allocations == 0);
+}
@@ -10,14 +10,21 @@
 
 
 #include <stdexcept>
+#include <atomic>
 #include <assert.h>
 #include <DBGL/System/Log/Log.h>
 #include <SFA/Utility/Model.h>
+#include <SFA/Utility/TriangleMesh.h>
 #include <SFA/NearestNeighbor/KdTreeNearestNeighbor.h>
+#include <SFA/NearestNeighbor/TriangleMeshNearestNeighbor.h>
 #include <SFA/ICP/RigidPointICP.h>
 
 using namespace sfa;
 
+// Heap allocations of all threads while counting is enabled, see AllocationCounter.cpp
+extern std::atomic<bool> g_countAllocations;
+extern std::atomic<unsigned int> g_allocations;
+
 void testRigidPointICP()
 {
     LOG.info("Starting RigidPointICP test suite...");
@@ -48,5 +55,32 @@ void testRigidPointICP()
 	LOG.info("Matching error: %{20}", error);
     }
     assert(error < startError);
-}
 
+    // Results don't depend on the amount of threads
+    Model single("Resources/Plane_Transformed.obj");
+    Model multi(single);
+    RigidPointICP singleICP(nn);
+    RigidPointICP multiICP(nn);
+    singleICP.setThreads(1);
+    multiICP.setThreads(4);
+    for(unsigned int i = 0; i < 2; i++)
+    {
+	assert(singleICP.calcNextStep(single, dest) == multiICP.calcNextStep(multi, dest));
+	for(unsigned int j = 0; j < single.getAmountOfVertices(); j++)
+	    assert(single.getVertex(j).coords == multi.getVertex(j).coords);
+    }
+
+    // Steps don't allocate once everything has been set up
+    TriangleMesh meshSrc("Resources/Plane_Transformed.obj");
+    TriangleMesh meshDest("Resources/Plane.obj");
+    TriangleMeshNearestNeighbor meshNN;
+    RigidPointICP meshICP(meshNN);
+    for(unsigned int i = 0; i < 3; i++)
+	meshICP.calcNextStep(meshSrc, meshDest);
+    g_allocations = 0;
+    g_countAllocations = true;
+    for(unsigned int i = 0; i < 3; i++)
+	meshICP.calcNextStep(meshSrc, meshDest);
+    g_countAllocations = false;
+    assert(g_allocations == 0);
+}
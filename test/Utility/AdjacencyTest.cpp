@@ -0,0 +1,75 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Face Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+
+#include <stdexcept>
+#include <assert.h>
+#include <DBGL/System/Log/Log.h>
+#include <SFA/Utility/Model.h>
+#include <SFA/Utility/Adjacency.h>
+
+using namespace sfa;
+
+void testAdjacency()
+{
+    LOG.info("Starting adjacency test suite...");
+
+    // Strip of three triangles, the last one given twice: 0-1-2, 1-3-2, 2-3-4, 2-3-4
+    std::vector<uint32_t> triangles = {0, 1, 2, 1, 3, 2, 2, 3, 4, 2, 3, 4};
+    Adjacency adjacency;
+    adjacency.buildFromTriangles(6, triangles);
+    assert(adjacency.getAmountOfNodes() == 6);
+    assert(adjacency.getDegree(0) == 2 && adjacency.getDegree(2) == 4 && adjacency.getDegree(5) == 0);
+    std::vector<uint32_t> expected = {0, 1, 3, 4};
+    assert(std::equal(expected.begin(), expected.end(), adjacency.getNeighbors(2).begin()));
+    assert(adjacency.getNeighbors(5).empty());
+    assert(adjacency.getOffsets().back() == adjacency.getIndices().size());
+
+    // Rings exclude the center and are sorted
+    std::vector<uint32_t> ring;
+    adjacency.getRing(0, 1, ring);
+    assert((ring == std::vector<uint32_t>{1, 2}));
+    adjacency.getRing(0, 2, ring);
+    assert((ring == std::vector<uint32_t>{1, 2, 3, 4}));
+    adjacency.getRing(0, 0, ring);
+    assert(ring.empty());
+
+    // Group mapping keeps members in increasing order
+    Adjacency groups;
+    groups.buildFromGroups(3, {2, 0, 2, 1, 0});
+    assert(groups.getDegree(0) == 2 && groups.getNeighbors(0)[0] == 1 && groups.getNeighbors(0)[1] == 4);
+    assert(groups.getDegree(1) == 1 && groups.getNeighbors(1)[0] == 3);
+    assert(groups.getDegree(2) == 2 && groups.getNeighbors(2)[0] == 0 && groups.getNeighbors(2)[1] == 2);
+    // Members without a valid group are skipped
+    groups.buildFromGroups(2, {1, 5, 0, 1});
+    assert(groups.getIndices().size() == 3);
+    assert(groups.getDegree(0) == 1 && groups.getNeighbors(0)[0] == 2);
+    assert(groups.getDegree(1) == 2 && groups.getNeighbors(1)[0] == 0 && groups.getNeighbors(1)[1] == 3);
+
+    // Model neighborhoods are symmetric and don't depend on the amount of threads
+    Model model("Resources/Generic_Face_Lowpoly.obj");
+    auto const& modelAdjacency = model.getAdjacency();
+    assert(modelAdjacency.getAmountOfNodes() == model.getAmountOfVertices());
+    for(unsigned int i = 0; i < model.getAmountOfVertices(); i++)
+    {
+	for(auto neighbor : modelAdjacency.getNeighbors(i))
+	{
+	    auto back = modelAdjacency.getNeighbors(neighbor);
+	    assert(std::binary_search(back.begin(), back.end(), i));
+	}
+	assert(model.getVertex(i).neighbors.size() == modelAdjacency.getDegree(i));
+    }
+    auto const& indices = model.getBasePointer()->getIndices();
+    std::vector<uint32_t> faces(indices.begin(), indices.end());
+    Adjacency single, multi;
+    single.buildFromTriangles(model.getBasePointer()->getVertices().size(), faces, 1);
+    multi.buildFromTriangles(model.getBasePointer()->getVertices().size(), faces, 4);
+    assert(single.getOffsets() == multi.getOffsets() && single.getIndices() == multi.getIndices());
+}
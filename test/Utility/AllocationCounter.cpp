@@ -0,0 +1,33 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Face Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include <cstdlib>
+#include <new>
+#include <atomic>
+
+// Replaces the global allocation functions of the test executable to count heap allocations.
+// Kept in a file of its own, so the replacements can't be inlined into any allocating code.
+
+std::atomic<bool> g_countAllocations(false);
+std::atomic<unsigned int> g_allocations(0);
+
+void* operator new(std::size_t size)
+{
+    if(g_countAllocations)
+	g_allocations++;
+    if(void* p = std::malloc(size == 0 ? 1 : size))
+	return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
@@ -0,0 +1,69 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Face Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include <stdexcept>
+#include <assert.h>
+#include <cstdint>
+#include <DBGL/System/Log/Log.h>
+#include <SFA/Utility/Arena.h>
+#include <SFA/Utility/Model.h>
+#include <SFA/NearestNeighbor/KdTreeNearestNeighbor.h>
+#include <SFA/ICP/RigidPlaneICP.h>
+#include <SFA/ICP/GeneralizedICP.h>
+
+using namespace sfa;
+
+void testArena()
+{
+    LOG.info("Starting arena test suite...");
+
+    // Memory is aligned and grows as needed
+    Arena arena(64);
+    for (unsigned int i = 0; i < 10; i++)
+    {
+	auto pData = arena.allocate<double>(7);
+	assert(reinterpret_cast<std::uintptr_t>(pData) % 16 == 0);
+    }
+    auto matrix = arena.allocateMatrix<Eigen::Matrix3Xd>(3, 100);
+    matrix.setOnes();
+    assert(matrix.sum() == 300);
+    assert(arena.getHeapAllocations() > 1);
+
+    // After a reset everything fits into a single block
+    arena.reset();
+    assert(arena.getUsed() == 0);
+    unsigned int allocations = arena.getHeapAllocations();
+    for (unsigned int i = 0; i < 10; i++)
+	arena.allocate<double>(7);
+    arena.allocateMatrix<Eigen::Matrix3Xd>(3, 100);
+    assert(arena.getHeapAllocations() == allocations);
+
+    // Once the blocks of the first step have been merged, steps don't need any new memory
+    Model src("Resources/Generic_Face_Lowpoly_Transformed.obj", true);
+    Model dest("Resources/Generic_Face_Lowpoly.obj", true);
+    KdTreeNearestNeighbor nn;
+    RigidPlaneICP planeICP(nn);
+    GeneralizedICP generalizedICP(nn);
+    for (unsigned int i = 0; i < 2; i++)
+    {
+	planeICP.calcNextStep(src, dest);
+	generalizedICP.calcNextStep(src, dest);
+    }
+    unsigned int planeAllocations = planeICP.getArena().getHeapAllocations();
+    unsigned int generalizedAllocations = generalizedICP.getArena().getHeapAllocations();
+    for (unsigned int i = 0; i < 3; i++)
+    {
+	planeICP.calcNextStep(src, dest);
+	generalizedICP.calcNextStep(src, dest);
+    }
+    assert(planeICP.getArena().getHeapAllocations() == planeAllocations);
+    assert(generalizedICP.getArena().getHeapAllocations() == generalizedAllocations);
+    assert(generalizedICP.getArena().getUsed() > 0);
+}
@@ -0,0 +1,61 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Face Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+
+#include <stdexcept>
+#include <assert.h>
+#include <DBGL/System/Log/Log.h>
+#include <SFA/Utility/Model.h>
+#include <SFA/Utility/Boundary.h>
+
+using namespace sfa;
+
+void testBoundary()
+{
+    LOG.info("Starting boundary test suite...");
+
+    // Strip of three triangles: 0-1-2, 1-3-2, 2-3-4. Vertex 5 is unused.
+    std::vector<uint32_t> triangles = {0, 1, 2, 1, 3, 2, 2, 3, 4};
+    Boundary boundary;
+    boundary.build(6, triangles);
+    for(unsigned int i = 0; i < 5; i++)
+	assert(boundary.isBoundary(i));
+    assert(!boundary.isBoundary(5));
+    assert(boundary.getAmountOfEdges() == 5);
+    assert(boundary.getLoops().size() == 1);
+    assert((boundary.getLoops()[0] == std::vector<uint32_t>{0, 1, 3, 4, 2}));
+
+    // A closed tetrahedron has no boundary
+    boundary.build(4, {0, 1, 2, 0, 3, 1, 1, 3, 2, 2, 3, 0});
+    assert(boundary.getAmountOfEdges() == 0 && boundary.getLoops().empty());
+
+    // Closed mesh
+    Model cube("Resources/Cube.obj");
+    for(unsigned int i = 0; i < cube.getAmountOfVertices(); i++)
+	assert(!cube.isEdge(i));
+    assert(cube.getBoundaryLoops().empty());
+
+    // Every boundary vertex is part of a loop, the result doesn't depend on the amount of threads
+    Model model("Resources/Generic_Face_Lowpoly.obj");
+    std::vector<char> inLoop(model.getAmountOfVertices(), false);
+    for(auto const& loop : model.getBoundaryLoops())
+    {
+	for(auto n : loop)
+	    inLoop[n] = true;
+    }
+    for(unsigned int i = 0; i < model.getAmountOfVertices(); i++)
+	assert(model.isEdge(i) == static_cast<bool>(inLoop[i]));
+    auto const& indices = model.getBasePointer()->getIndices();
+    std::vector<uint32_t> faces(indices.begin(), indices.end());
+    Boundary single, multi;
+    single.build(model.getBasePointer()->getVertices().size(), faces, 1);
+    multi.build(model.getBasePointer()->getVertices().size(), faces, 4);
+    assert(single.getFlags() == multi.getFlags() && single.getLoops() == multi.getLoops());
+}
@@ -0,0 +1,64 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Face Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include <stdexcept>
+#include <assert.h>
+#include <DBGL/System/Log/Log.h>
+#include <SFA/Utility/KdTree.h>
+
+using namespace sfa;
+
+template<int Dim> void testKdTreeWithDim()
+{
+    typename KdTree<Dim>::PointList points = KdTree<Dim>::PointList::Random(Dim, 500);
+    KdTree<Dim> tree;
+    tree.build(points);
+    assert(tree.size() == 500);
+
+    std::vector<unsigned int> kNearest;
+    for (unsigned int q = 0; q < 50; q++)
+    {
+	typename KdTree<Dim>::Point query = KdTree<Dim>::Point::Random();
+	// Compare with linear search
+	std::vector<std::pair<double, unsigned int>> all;
+	for (unsigned int i = 0; i < points.cols(); i++)
+	    all.push_back(std::make_pair((points.col(i) - query).squaredNorm(), i));
+	std::sort(all.begin(), all.end());
+	double sqDist = 0;
+	assert(tree.findNearest(query, &sqDist) == all[0].second);
+	assert(sqDist == all[0].first);
+	tree.findKNearest(query, 5, kNearest);
+	assert(kNearest.size() == 5);
+	for (unsigned int i = 0; i < 5; i++)
+	    assert(kNearest[i] == all[i].second);
+    }
+}
+
+void testKdTree()
+{
+    LOG.info("Starting KdTree test suite...");
+
+    testKdTreeWithDim<3>();
+    testKdTreeWithDim<33>();
+
+    // Empty tree
+    KdTree<3> empty;
+    empty.build(KdTree<3>::PointList(3, 0));
+    bool caught = false;
+    try
+    {
+	empty.findNearest(Eigen::Vector3d::Zero());
+    }
+    catch(std::out_of_range const&)
+    {
+	caught = true;
+    }
+    assert(caught);
+}
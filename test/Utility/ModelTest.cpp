@@ -13,6 +13,7 @@
 #include <DBGL/System/Log/Log.h>
 #include <SFA/Utility/Log.h>
 #include <SFA/Utility/Model.h>
+#include <SFA/NearestNeighbor/KdTreeNearestNeighbor.h>
 
 using namespace sfa;
 
@@ -51,4 +52,142 @@ void testModel()
     }
     avrgBaseNormal.normalize();
     assert(dbgl::isSimilar((double)(newSFAVert.normal - avrgBaseNormal).norm(), 0.0, 0.0001));
+
+    // Packed views reflect all vertices, including modifications
+    auto positions = model.getPositions();
+    auto normals = model.getNormals();
+    assert(positions.cols() == model.getAmountOfVertices() && normals.cols() == model.getAmountOfVertices());
+    for(unsigned int i = 0; i < model.getAmountOfVertices(); i++)
+    {
+	assert(positions.col(i) == model.getVertex(i).coords && positions.col(i) == model.getCoords(i));
+	assert(normals.col(i) == model.getVertex(i).normal && normals.col(i) == model.getNormal(i));
+    }
+    assert(positions.rowwise().mean().isApprox(model.getAverage()));
+
+    // Single precision copies are only kept on request
+    assert(!model.hasFloatData() && model.getFloatPositions().cols() == 0);
+    model.setFloatData(true);
+    model.setVertex(1, Eigen::Vector3d(1, 2, 3), model.getNormal(1));
+    assert(model.getFloatPositions().cols() == model.getAmountOfVertices());
+    assert(model.getFloatPositions().col(1) == Eigen::Vector3f(1, 2, 3));
+    assert(model.getFloatNormals().cast<double>().isApprox(model.getNormals(), 1e-6));
+    Model copy(model);
+    assert(copy.hasFloatData() && copy.getFloatPositions() == model.getFloatPositions());
+    model.setFloatData(false);
+    assert(model.getFloatNormals().cols() == 0);
+
+    // Rigid transformations move the underlying mesh along and keep the vertex tree usable
+    Model face("Resources/Generic_Face_Lowpoly.obj");
+    Model original(face);
+    KdTreeNearestNeighbor nn;
+    Eigen::Matrix3d R = Eigen::AngleAxisd(0.7, Eigen::Vector3d(1, 2, 3).normalized()).toRotationMatrix();
+    Eigen::Vector3d t(0.5, -1, 2);
+    auto generation = face.getGeneration();
+    auto shapeGeneration = face.getShapeGeneration();
+    face.applyTransform(R, t);
+    assert(face.getGeneration() != generation && face.getShapeGeneration() == shapeGeneration);
+    for(unsigned int i = 0; i < face.getAmountOfVertices(); i++)
+    {
+	assert((face.getCoords(i) - (R * original.getCoords(i) + t)).norm() < 1e-9);
+	assert((face.getNormal(i) - R * original.getNormal(i)).norm() < 1e-9);
+	for(auto base : face.getBaseVertices().getNeighbors(i))
+	{
+	    auto baseCoords = face.getBasePointer()->getVertices()[base];
+	    auto baseNormal = face.getBasePointer()->getNormals()[base];
+	    auto oldNormal = original.getBasePointer()->getNormals()[base];
+	    assert((Eigen::Vector3d(baseCoords[0], baseCoords[1], baseCoords[2]) - face.getCoords(i)).norm() < 1e-5);
+	    assert((Eigen::Vector3d(baseNormal[0], baseNormal[1], baseNormal[2]) -
+		    R * Eigen::Vector3d(oldNormal[0], oldNormal[1], oldNormal[2])).norm() < 1e-5);
+	}
+	assert((face.toLocalFrame(face.getCoords(i)) - original.getCoords(i)).norm() < 1e-9);
+	assert(nn.findNearest(face.getCoords(i), face) == i);
+    }
+
+    // Replacing all coordinates keeps the normals and rebuilds the vertex tree
+    Eigen::Matrix3Xd moved = original.getPositions();
+    moved.row(0).array() += 1;
+    face.setPositions(moved);
+    assert(face.getPositions() == moved);
+    assert(face.getShapeGeneration() != shapeGeneration);
+    assert((face.getNormals() - R * original.getNormals()).norm() < 1e-9);
+    for(unsigned int i = 0; i < face.getAmountOfVertices(); i++)
+    {
+	assert(face.toLocalFrame(face.getCoords(i)) == face.getCoords(i));
+	assert(nn.findNearest(face.getCoords(i), face) == i);
+    }
+    bool caught = false;
+    try
+    {
+	face.setPositions(Eigen::Matrix3Xd(3, 2));
+    }
+    catch(std::invalid_argument& e)
+    {
+	caught = true;
+    }
+    assert(caught);
+
+    // Copies share their topology
+    Model shared(face);
+    assert(&shared.getAdjacency() == &face.getAdjacency() && &shared.getVertexTree() == &face.getVertexTree());
+
+    // Snapshots reset coordinates, normals and the underlying mesh
+    Model::Snapshot snapshot;
+    face.saveSnapshot(snapshot);
+    Eigen::Matrix3Xd savedPositions = face.getPositions();
+    Eigen::Matrix3Xd savedNormals = face.getNormals();
+    auto savedBaseVertices = face.getBasePointer()->getVertices();
+    auto savedGeneration = face.getGeneration();
+    for(unsigned int cycle = 0; cycle < 2; cycle++)
+    {
+	face.applyTransform(R, t);
+	face.rotateRandom(1, 0.5);
+	face.restoreSnapshot(snapshot);
+	assert(face.getPositions() == savedPositions && face.getNormals() == savedNormals);
+	assert(face.getBasePointer()->getVertices() == savedBaseVertices);
+	assert(face.getGeneration() == savedGeneration);
+	for(unsigned int i = 0; i < face.getAmountOfVertices(); i++)
+	    assert(nn.findNearest(face.getCoords(i), face) == i);
+    }
+
+    // Rigid perturbations keep topology and vertex tree, only the pose changes
+    auto const* pAdjacency = &face.getAdjacency();
+    auto const* pTree = &face.getVertexTree();
+    assert(face.getPose().isApprox(Eigen::Isometry3d::Identity()));
+    face.rotateRandom(1, 0.5);
+    face.translateRandom(0.3, 0.3);
+    assert(&face.getAdjacency() == pAdjacency && &face.getVertexTree() == pTree);
+    for(unsigned int i = 0; i < face.getAmountOfVertices(); i++)
+    {
+	assert((face.getPose() * savedPositions.col(i) - face.getCoords(i)).norm() < 1e-9);
+	assert(nn.findNearest(face.getCoords(i), face) == i);
+    }
+    face.addHole();
+    caught = false;
+    try
+    {
+	face.restoreSnapshot(snapshot);
+    }
+    catch(std::invalid_argument& e)
+    {
+	caught = true;
+    }
+    assert(caught);
+
+    // Carving holes in one batch yields the same model as analyzing the remaining mesh again
+    Model holes("Resources/Generic_Face_Lowpoly.obj");
+    unsigned int before = holes.getAmountOfVertices();
+    holes.addHoles(5, 1);
+    assert(holes.getAmountOfVertices() < before - 5);
+    Model reanalyzed(holes);
+    reanalyzed.refresh();
+    assert(reanalyzed.getPositions() == holes.getPositions() && reanalyzed.getNormals() == holes.getNormals());
+    assert(reanalyzed.getAdjacency().getOffsets() == holes.getAdjacency().getOffsets());
+    assert(reanalyzed.getAdjacency().getIndices() == holes.getAdjacency().getIndices());
+    assert(reanalyzed.getBaseVertices().getIndices() == holes.getBaseVertices().getIndices());
+    assert(reanalyzed.getBoundaryLoops() == holes.getBoundaryLoops());
+    for(unsigned int i = 0; i < holes.getAmountOfVertices(); i++)
+    {
+	assert(reanalyzed.isEdge(i) == holes.isEdge(i));
+	assert(nn.findNearest(holes.getCoords(i), holes) == i);
+    }
 }
@@ -0,0 +1,98 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Face Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <cstdlib>
+#include <cstdio>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <assert.h>
+#include <DBGL/System/Log/Log.h>
+#include <SFA/Utility/OBJReader.h>
+#include <SFA/Utility/MappedFile.h>
+
+using namespace sfa;
+
+void testOBJReader()
+{
+    LOG.info("Starting OBJ reader test suite...");
+
+    // Numbers are parsed like strtod does
+    std::mt19937 random(42);
+    std::uniform_real_distribution<double> rand_double(-10, 10);
+    std::uniform_int_distribution<int> rand_exponent(-30, 30);
+    std::ostringstream numbers;
+    numbers.precision(17);
+    std::vector<std::string> tokens = {"0", "-0.0", "+1.5", "1.", ".25", "1e3", "2.5E-3", "-7.125e+2", "123456789012345678901234",
+	    "0.000000000000000000000000001", "3.14159265358979323846"};
+    for (unsigned int i = 0; i < 1000; i++)
+    {
+	std::ostringstream token;
+	token.precision(i % 17 + 1);
+	token << rand_double(random) * std::pow(10.0, rand_exponent(random));
+	tokens.push_back(token.str());
+    }
+    while (tokens.size() % 3 != 0)
+	tokens.push_back("1");
+    for (unsigned int i = 0; i < tokens.size(); i += 3)
+	numbers << "v " << tokens[i] << " " << tokens[i + 1] << "\t" << tokens[i + 2] << "\n";
+    std::string data = numbers.str();
+    OBJReader reader;
+    reader.parse(data.data(), data.data() + data.size());
+    assert(reader.getPositions().size() == tokens.size());
+    for (unsigned int i = 0; i < tokens.size(); i++)
+    {
+	double expected = std::strtod(tokens[i].c_str(), nullptr);
+	assert(std::abs(reader.getPositions()[i] - expected) <= 1e-15 * std::abs(expected));
+    }
+
+    // Chunk boundaries and the amount of threads don't change the result
+    MappedFile file("Resources/Generic_Face_2_Lowpoly.obj");
+    OBJReader whole;
+    whole.parse(file.data(), file.data() + file.size(), file.size(), 1);
+    assert(!whole.getTriangles().empty());
+    for (std::size_t chunkSize : {1, 7, 100, 4096})
+    {
+	reader.parse(file.data(), file.data() + file.size(), chunkSize, 4);
+	assert(reader.getPositions() == whole.getPositions());
+	assert(reader.getNormals() == whole.getNormals());
+	assert(reader.getTriangles() == whole.getTriangles());
+	assert(reader.getTriangleNormals() == whole.getTriangleNormals());
+    }
+    reader.read("Resources/Generic_Face_2_Lowpoly.obj");
+    assert(reader.getPositions() == whole.getPositions());
+    assert(reader.getTriangles() == whole.getTriangles());
+
+    // Errors are reported no matter which chunk contains them
+    std::string invalid = "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\nf 1 2 x\n";
+    for (std::size_t chunkSize : {1, 1000})
+    {
+	bool caught = false;
+	try
+	{
+	    reader.parse(invalid.data(), invalid.data() + invalid.size(), chunkSize);
+	}
+	catch (std::runtime_error& e)
+	{
+	    caught = std::string(e.what()).find("line 5") != std::string::npos;
+	}
+	assert(caught);
+    }
+
+    // Empty files are valid
+    std::ofstream("OBJReaderTest.obj").close();
+    reader.read("OBJReaderTest.obj");
+    assert(reader.getPositions().empty() && reader.getTriangles().empty());
+    std::remove("OBJReaderTest.obj");
+}
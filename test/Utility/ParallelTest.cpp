@@ -0,0 +1,105 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Face Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include <stdexcept>
+#include <assert.h>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <atomic>
+#include <functional>
+#include <DBGL/System/Log/Log.h>
+#include <SFA/Utility/Parallel.h>
+
+using namespace sfa;
+
+// Heap allocations of all threads while counting is enabled, see AllocationCounter.cpp
+extern std::atomic<bool> g_countAllocations;
+extern std::atomic<unsigned int> g_allocations;
+
+void testParallel()
+{
+    LOG.info("Starting parallel test suite...");
+
+    // Every index is visited exactly once
+    std::vector<int> visits(100, 0);
+    parallelFor(0, visits.size(), [&visits](unsigned int i)
+    {
+	visits[i]++;
+    }, 4);
+    for (auto v : visits)
+	assert(v == 1);
+
+    // Exceptions are passed on to the caller
+    bool caught = false;
+    try
+    {
+	parallelFor(0, 10, [](unsigned int i)
+	{
+	    if(i == 5)
+		throw std::runtime_error("Test");
+	});
+    }
+    catch(std::runtime_error const&)
+    {
+	caught = true;
+    }
+    assert(caught);
+
+    // Reductions give the same result no matter how many threads are used
+    auto sum = [](unsigned int threads)
+    {
+	return parallelReduce(0, 10000, 64, 0.0, [](double& partial, unsigned int i)
+	{
+	    partial += 1.0 / (i + 1);
+	}, [](double& result, double partial)
+	{
+	    result += partial;
+	}, threads);
+    };
+    assert(sum(1) == sum(4));
+    assert(std::abs(sum(0) - 9.787606) < 1e-6);
+
+    // Sorting in parallel merges all chunks
+    std::vector<unsigned int> values(10007);
+    for(unsigned int i = 0; i < values.size(); i++)
+	values[i] = (i * 7919) % 1013;
+    auto sorted = values;
+    std::sort(sorted.begin(), sorted.end());
+    parallelSort(values.begin(), values.end(), std::less<unsigned int>(), 100, 4);
+    assert(values == sorted);
+
+    // Dispatching work doesn't allocate once the queues are large enough
+    Scheduler scheduler(4);
+    scheduler.reserve(32);
+    std::atomic<unsigned int> counter(0);
+    std::function<void(unsigned int)> increment = [&counter](unsigned int)
+    {
+	counter++;
+    };
+    auto dispatch = [&]()
+    {
+	TaskGroup group(scheduler);
+	for (unsigned int i = 0; i < 32; i++)
+	    group.run([&counter]()
+	    {
+		counter++;
+	    });
+	group.wait();
+	parallelFor(0, 64, increment, 4);
+    };
+    dispatch();
+    g_countAllocations = true;
+    for (unsigned int i = 0; i < 100; i++)
+	dispatch();
+    g_countAllocations = false;
+    assert(counter == 101 * (32 + 64));
+    assert(g_allocations == 0);
+}
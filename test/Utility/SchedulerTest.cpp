@@ -0,0 +1,125 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Face Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include <stdexcept>
+#include <assert.h>
+#include <vector>
+#include <atomic>
+#include <DBGL/System/Log/Log.h>
+#include <SFA/Utility/Scheduler.h>
+#include <SFA/Utility/Parallel.h>
+
+using namespace sfa;
+
+void testScheduler()
+{
+    LOG.info("Starting scheduler test suite...");
+
+    Scheduler scheduler(4);
+    assert(scheduler.getThreads() == 4);
+
+    // Tasks may spawn and wait for further tasks
+    std::atomic<unsigned int> counter(0);
+    TaskGroup outer(scheduler);
+    for (unsigned int i = 0; i < 8; i++)
+    {
+	outer.run([&]()
+	{
+	    TaskGroup inner(scheduler);
+	    for (unsigned int j = 0; j < 8; j++)
+		inner.run([&]()
+		{
+		    counter++;
+		});
+	    inner.wait();
+	});
+    }
+    outer.wait();
+    assert(counter == 64);
+
+    // Nested parallel loops on the default scheduler
+    std::vector<int> visits(32 * 32, 0);
+    parallelFor(0, 32, [&visits](unsigned int i)
+    {
+	parallelFor(0, 32, [&visits, i](unsigned int j)
+	{
+	    visits[i * 32 + j]++;
+	});
+    });
+    for (auto v : visits)
+	assert(v == 1);
+
+    // The default scheduler can't be replaced once it is in use
+    bool replaced = true;
+    try
+    {
+	Scheduler::setDefaultThreads(2);
+    }
+    catch(std::logic_error const&)
+    {
+	replaced = false;
+    }
+    assert(!replaced);
+
+    // Tasks run after their dependencies
+    std::vector<unsigned int> order;
+    std::mutex orderMutex;
+    auto record = [&](unsigned int id)
+    {
+	return [&, id]()
+	{
+	    std::lock_guard<std::mutex> lock(orderMutex);
+	    order.push_back(id);
+	};
+    };
+    TaskGraph graph;
+    auto a = graph.add(record(0));
+    auto b = graph.add(record(1), {a});
+    auto c = graph.add(record(2), {a});
+    graph.add(record(3), {b, c});
+    assert(graph.size() == 4);
+    graph.run(scheduler);
+    assert(order.size() == 4);
+    assert(order.front() == 0 && order.back() == 3);
+
+    // Dependents of failing tasks are skipped, the exception is passed on
+    bool caught = false;
+    bool skipped = true;
+    TaskGraph failing;
+    auto thrower = failing.add([]()
+    {
+	throw std::runtime_error("Test");
+    });
+    failing.add([&skipped]()
+    {
+	skipped = false;
+    }, {thrower});
+    try
+    {
+	failing.run(scheduler);
+    }
+    catch(std::runtime_error const&)
+    {
+	caught = true;
+    }
+    assert(caught && skipped);
+
+    // Only existing tasks can be dependencies
+    caught = false;
+    try
+    {
+	failing.add([]() {}, {5});
+    }
+    catch(std::out_of_range const&)
+    {
+	caught = true;
+    }
+    assert(caught);
+}
@@ -0,0 +1,129 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Face Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+
+#include <cstring>
+#include <stdexcept>
+#include <assert.h>
+#include <DBGL/System/Log/Log.h>
+#include <SFA/Utility/Model.h>
+#include <SFA/Utility/OBJReader.h>
+#include <SFA/Utility/TriangleMesh.h>
+#include <SFA/NearestNeighbor/KdTreeNearestNeighbor.h>
+#include <SFA/NearestNeighbor/TriangleMeshNearestNeighbor.h>
+
+using namespace sfa;
+
+void testTriangleMesh()
+{
+    LOG.info("Starting triangle mesh test suite...");
+
+    // Quad split into a fan, negative indices, a duplicated and an unused vertex
+    char const* obj = "# Test\n"
+	    "v 0 0 0\n"
+	    "v 1 0 0\n"
+	    "v 1 1 0\n"
+	    "v 0 1 0\n"
+	    "vt 0 0\n"
+	    "vn 0 0 1\n"
+	    "f 1/1/1 2/1/1 3/1/1 4/1/1\n"
+	    "v 1 0 0\n"
+	    "v 5 5 5\n"
+	    "v 2 0 0\r\n"
+	    "f -3 -1 3\r\n";
+    OBJReader reader;
+    reader.parse(obj, obj + std::strlen(obj));
+    assert(reader.getPositions().size() == 3 * 7);
+    assert(reader.getNormals().size() == 3);
+    assert((reader.getTriangles() == std::vector<uint32_t>{0, 1, 2, 0, 2, 3, 4, 6, 2}));
+    for (unsigned int i = 0; i < 6; i++)
+	assert(reader.getTriangleNormals()[i] == 0);
+    for (unsigned int i = 6; i < 9; i++)
+	assert(reader.getTriangleNormals()[i] == OBJReader::NoNormal);
+    bool caught = false;
+    try
+    {
+	char const* invalid = "v 0 0 0\nf 1 2 3\n";
+	reader.parse(invalid, invalid + std::strlen(invalid));
+    }
+    catch (std::runtime_error& e)
+    {
+	caught = true;
+    }
+    assert(caught);
+    caught = false;
+    try
+    {
+	reader.read("Resources/DoesNotExist.obj");
+    }
+    catch (std::runtime_error& e)
+    {
+	caught = true;
+    }
+    assert(caught);
+
+    // Vertex 4 is welded to vertex 1, vertex 5 isn't used by any face and is dropped
+    reader.parse(obj, obj + std::strlen(obj));
+    TriangleMesh quad(reader);
+    assert(quad.getAmountOfVertices() == 5);
+    assert(quad.getTriangles().size() == 9);
+    assert(quad.getBaseVertices().getDegree(1) == 2);
+    assert(quad.getCoords(4).isApprox(Eigen::Vector3d(2, 0, 0)));
+    assert(quad.getNormal(0).isApprox(Eigen::Vector3d(0, 0, 1)));
+    assert(quad.getNormal(4).isApprox(Eigen::Vector3d(0, 0, 1)));
+    for (unsigned int i = 0; i < quad.getAmountOfVertices(); i++)
+	assert(quad.isEdge(i));
+    assert(quad.getBoundaryLoops().size() == 1 && quad.getBoundaryLoops()[0].size() == 5);
+
+    // Same analysis as the dbgl based model, up to the order of the vertices
+    Model model("Resources/Generic_Face_Lowpoly.obj");
+    TriangleMesh mesh("Resources/Generic_Face_Lowpoly.obj");
+    assert(mesh.getAmountOfVertices() == model.getAmountOfVertices());
+    assert(mesh.getBoundaryLoops().size() == model.getBoundaryLoops().size());
+    KdTreeNearestNeighbor modelNN;
+    for (unsigned int i = 0; i < mesh.getAmountOfVertices(); i++)
+    {
+	unsigned int n = modelNN.findNearest(mesh.getCoords(i), model);
+	assert((model.getCoords(n) - mesh.getCoords(i)).norm() < 1e-5);
+	assert(model.isEdge(n) == mesh.isEdge(i));
+	assert(model.getAdjacency().getDegree(n) == mesh.getAdjacency().getDegree(i));
+	assert(std::abs(mesh.getNormal(i).norm() - 1) < 1e-9);
+    }
+
+    // Vertex tree follows rigid transformations
+    TriangleMeshNearestNeighbor nn;
+    TriangleMesh::Snapshot original;
+    mesh.saveSnapshot(original);
+    mesh.rotateRandom(0.5, 0.1);
+    mesh.translateRandom(0.3, 0.1);
+    for (unsigned int i = 0; i < mesh.getAmountOfVertices(); i++)
+	assert(nn.findNearest(mesh.getCoords(i), mesh) == i);
+    mesh.restoreSnapshot(original);
+    assert(mesh.getPose().isApprox(Eigen::Isometry3d::Identity()));
+
+    // Copies share the topology, holes only modify the copy
+    TriangleMesh copy(mesh);
+    copy.addHoles(5, 1);
+    assert(copy.getAmountOfVertices() < mesh.getAmountOfVertices());
+    assert(copy.getAdjacency().getAmountOfNodes() == copy.getAmountOfVertices());
+    for (auto n : copy.getTriangles())
+	assert(n < copy.getAmountOfVertices());
+    assert(mesh.getAdjacency().getAmountOfNodes() == mesh.getAmountOfVertices());
+    caught = false;
+    try
+    {
+	copy.restoreSnapshot(original);
+    }
+    catch (std::invalid_argument& e)
+    {
+	caught = true;
+    }
+    assert(caught);
+}
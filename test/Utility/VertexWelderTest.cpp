@@ -0,0 +1,60 @@
+//////////////////////////////////////////////////////////////////////
+/// Statistical Face Analysis
+///
+/// Copyright (c) 2014 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+
+#include <stdexcept>
+#include <assert.h>
+#include <DBGL/System/Log/Log.h>
+#include <SFA/Utility/Model.h>
+#include <SFA/Utility/VertexWelder.h>
+
+using namespace sfa;
+
+void testVertexWelder()
+{
+    LOG.info("Starting vertex welder test suite...");
+
+    // Vertices 2 and 4 duplicate vertex 0, vertex 3 is close to vertex 1 but in a different cell
+    std::vector<double> positions = {0, 0, 0, 1, 1, 1, 0, 0, 0, 1.00015, 1, 1, 0.00005, 0, 0, 2, 2, 2};
+    VertexWelder welder;
+    welder.weld(positions, 0.0001);
+    assert(welder.getAmountOfVertices() == 4);
+    assert((welder.getMapping() == std::vector<uint32_t>{0, 1, 0, 2, 0, 3}));
+    assert((welder.getRepresentatives() == std::vector<uint32_t>{0, 1, 3, 5}));
+    welder.weld(positions, 0.0002);
+    assert((welder.getMapping() == std::vector<uint32_t>{0, 1, 0, 1, 0, 2}));
+    bool caught = false;
+    try
+    {
+	welder.weld(positions, 0);
+    }
+    catch (std::invalid_argument& e)
+    {
+	caught = true;
+    }
+    assert(caught);
+
+    // The result doesn't depend on the amount of threads
+    Model model("Resources/Generic_Face_Lowpoly.obj");
+    auto const& vertices = model.getBasePointer()->getVertices();
+    std::vector<double> basePositions;
+    for (auto const& vertex : vertices)
+    {
+	for (unsigned int j = 0; j < 3; j++)
+	    basePositions.push_back(vertex[j]);
+    }
+    VertexWelder single, multi;
+    single.weld(basePositions, 0.0001, 1);
+    multi.weld(basePositions, 0.0001, 4);
+    assert(single.getMapping() == multi.getMapping());
+    assert(single.getAmountOfVertices() == model.getAmountOfVertices());
+    for (unsigned int i = 0; i < vertices.size(); i++)
+	assert((model.getCoords(single.getMapping()[i]) - Eigen::Vector3d(vertices[i][0], vertices[i][1], vertices[i][2])).norm() <= 0.0001);
+}
@@ -15,8 +15,26 @@
 void testModel();
 void testNearestNeighbor();
 void testPoissonDiskSampler();
+void testParallel();
+void testScheduler();
+void testArena();
+void testAdjacency();
+void testBoundary();
+void testVertexWelder();
+void testOBJReader();
+void testTriangleMesh();
+void testKdTree();
 void testRigidPointICP();
 void testRigidPlaneICP();
+void testPipelineICP();
+void testKernelICP();
+void testGeneralizedICP();
+void testPointSelection();
+void testPCA_ICP();
+void testMultiStartICP();
+void testFPFH_ICP();
+void testLandmarkICP();
+void testBranchAndBoundICP();
 
 int main()
 {
@@ -26,8 +44,26 @@ int main()
     testModel();
     testNearestNeighbor();
     testPoissonDiskSampler();
+    testParallel();
+    testScheduler();
+    testArena();
+    testAdjacency();
+    testBoundary();
+    testVertexWelder();
+    testOBJReader();
+    testTriangleMesh();
+    testKdTree();
     testRigidPointICP();
     testRigidPlaneICP();
+    testPipelineICP();
+    testKernelICP();
+    testGeneralizedICP();
+    testPointSelection();
+    testPCA_ICP();
+    testMultiStartICP();
+    testFPFH_ICP();
+    testLandmarkICP();
+    testBranchAndBoundICP();
 
     LOG.info("Done!");
     dbgl::WindowManager::get()->terminate();